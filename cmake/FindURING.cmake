@@ -0,0 +1,21 @@
+find_package(PkgConfig)
+pkg_check_modules(PC_URING liburing>=2.0)
+
+find_path(URING_INCLUDE_DIRS
+    liburing.h
+    HINTS ${URING_INCLUDE_DIR_HINT} ${PC_URING_INCLUDEDIR}
+)
+find_library(URING_LIBRARIES
+    NAMES uring
+    HINTS ${URING_LIBRARIES_DIR_HINT} ${PC_URING_LIBDIR}
+)
+
+if(URING_INCLUDE_DIRS AND URING_LIBRARIES)
+    set(URING_FOUND TRUE)
+    set(HAVE_LIBURING "1")
+endif()
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(URING DEFAULT_MSG URING_LIBRARIES URING_INCLUDE_DIRS)
+
+mark_as_advanced(URING_INCLUDE_DIRS URING_LIBRARIES)
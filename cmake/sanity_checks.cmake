@@ -18,6 +18,15 @@ check_function_exists(memrchr HAVE_MEMRCHR)
 check_function_exists(sigaction HAVE_SIGACTION)
 check_function_exists(basename_r HAVE_BASENAME_R)
 
+# shm_open moved from librt into libc with glibc 2.34
+check_function_exists(shm_open HAVE_SHM_OPEN)
+if (NOT HAVE_SHM_OPEN)
+    check_library_exists(rt shm_open "" HAVE_LIBRT)
+    if (HAVE_LIBRT)
+        set(RT_LIBRARIES rt)
+    endif ()
+endif ()
+
 check_cxx_source_compiles(
     "
     #include <string.h>
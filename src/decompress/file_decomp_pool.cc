@@ -0,0 +1,311 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// file_decomp_pool.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "file_decomp_pool.h"
+
+#include <utility>
+#include <vector>
+
+#ifdef UNIT_TEST
+#include <cstring>
+
+#include "catch/snort_catch.h"
+#endif
+
+// zlib doesn't say how much it allocates, so use the inflate state plus
+// the largest window, which is what every user here asks for
+#define FD_ZLIB_SIZE (sizeof(z_stream) + 7168 + 32768)
+
+struct FileDecompPool
+{
+    // streams keep their addresses since zlib checks state->strm
+    std::vector<z_stream*> zlib;
+#ifdef HAVE_LZMA
+    std::vector<std::pair<lzma_stream*, size_t>> lzma;
+#endif
+    size_t bytes = 0;
+};
+
+THREAD_LOCAL FileDecompPoolStats fd_pool_stats;
+
+static THREAD_LOCAL FileDecompPool* fd_pool = nullptr;
+static THREAD_LOCAL size_t fd_pool_memcap = FD_POOL_MEMCAP_DEFAULT;
+
+void File_Decomp_Set_Pool_Memcap(size_t memcap)
+{
+    fd_pool_memcap = memcap;
+}
+
+/* Returns the pool if another size bytes fit under the memcap */
+static FileDecompPool* Get_Pool(size_t size)
+{
+    size_t bytes = fd_pool ? fd_pool->bytes : 0;
+
+    if ( bytes + size > fd_pool_memcap )
+    {
+        fd_pool_stats.pool_frees++;
+        return nullptr;
+    }
+
+    if ( !fd_pool )
+        fd_pool = new FileDecompPool;
+
+    fd_pool->bytes += size;
+
+    if ( fd_pool->bytes > fd_pool_stats.pool_max_bytes )
+        fd_pool_stats.pool_max_bytes = fd_pool->bytes;
+
+    return fd_pool;
+}
+
+static void Free_Inflate(z_stream* z_s)
+{
+    inflateEnd(z_s);
+    delete z_s;
+}
+
+z_stream* File_Decomp_Get_Inflate(int window_bits)
+{
+    if ( fd_pool and !fd_pool->zlib.empty() )
+    {
+        z_stream* z_s = fd_pool->zlib.back();
+
+        fd_pool->zlib.pop_back();
+        fd_pool->bytes -= FD_ZLIB_SIZE;
+
+        if ( inflateReset2(z_s, window_bits) == Z_OK )
+        {
+            fd_pool_stats.pool_hits++;
+            return z_s;
+        }
+
+        Free_Inflate(z_s);
+    }
+
+    z_stream* z_s = new z_stream { };
+
+    if ( inflateInit2(z_s, window_bits) != Z_OK )
+    {
+        delete z_s;
+        return nullptr;
+    }
+
+    fd_pool_stats.pool_misses++;
+    return z_s;
+}
+
+void File_Decomp_Put_Inflate(z_stream* z_s)
+{
+    if ( !z_s )
+        return;
+
+    if ( FileDecompPool* pool = Get_Pool(FD_ZLIB_SIZE) )
+        pool->zlib.emplace_back(z_s);
+    else
+        Free_Inflate(z_s);
+}
+
+#ifdef HAVE_LZMA
+static void Free_LZMA(lzma_stream* l_s)
+{
+    lzma_end(l_s);
+    delete l_s;
+}
+
+lzma_stream* File_Decomp_Get_LZMA()
+{
+    lzma_stream* l_s;
+
+    if ( fd_pool and !fd_pool->lzma.empty() )
+    {
+        l_s = fd_pool->lzma.back().first;
+        fd_pool->bytes -= fd_pool->lzma.back().second;
+        fd_pool->lzma.pop_back();
+
+        // liblzma reuses the decoder and dictionary of the same type
+        if ( lzma_alone_decoder(l_s, UINT64_MAX) == LZMA_OK )
+        {
+            fd_pool_stats.pool_hits++;
+            return l_s;
+        }
+
+        Free_LZMA(l_s);
+    }
+
+    l_s = new lzma_stream;
+    *l_s = LZMA_STREAM_INIT;
+
+    if ( lzma_alone_decoder(l_s, UINT64_MAX) != LZMA_OK )
+    {
+        Free_LZMA(l_s);
+        return nullptr;
+    }
+
+    fd_pool_stats.pool_misses++;
+    return l_s;
+}
+
+void File_Decomp_Put_LZMA(lzma_stream* l_s)
+{
+    if ( !l_s )
+        return;
+
+    size_t size = sizeof(lzma_stream) + lzma_memusage(l_s);
+
+    if ( FileDecompPool* pool = Get_Pool(size) )
+        pool->lzma.emplace_back(l_s, size);
+    else
+        Free_LZMA(l_s);
+}
+#endif
+
+void File_Decomp_Pool_Term()
+{
+    if ( !fd_pool )
+        return;
+
+    for ( auto z_s : fd_pool->zlib )
+        Free_Inflate(z_s);
+
+#ifdef HAVE_LZMA
+    for ( auto& l : fd_pool->lzma )
+        Free_LZMA(l.first);
+#endif
+
+    delete fd_pool;
+    fd_pool = nullptr;
+}
+
+//--------------------------------------------------------------------------
+// unit tests
+//--------------------------------------------------------------------------
+
+#ifdef UNIT_TEST
+
+static bool Inflate_Test(z_stream* z_s, int window_bits)
+{
+    const char* text = "file_decomp pool file_decomp pool file_decomp pool";
+    size_t len = strlen(text);
+
+    z_stream d_s { };
+    uint8_t comp[128];
+    uint8_t out[128];
+
+    if ( deflateInit2(&d_s, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8,
+        Z_DEFAULT_STRATEGY) != Z_OK )
+        return false;
+
+    d_s.next_in = (Bytef*)text;
+    d_s.avail_in = len;
+    d_s.next_out = comp;
+    d_s.avail_out = sizeof(comp);
+    deflate(&d_s, Z_FINISH);
+    deflateEnd(&d_s);
+
+    z_s->next_in = comp;
+    z_s->avail_in = sizeof(comp) - d_s.avail_out;
+    z_s->next_out = out;
+    z_s->avail_out = sizeof(out);
+
+    return inflate(z_s, Z_SYNC_FLUSH) == Z_STREAM_END and
+        sizeof(out) - z_s->avail_out == len and !memcmp(out, text, len);
+}
+
+TEST_CASE("File_Decomp_Get_Inflate-reuse", "[file_decomp_pool]")
+{
+    File_Decomp_Pool_Term();
+    fd_pool_stats = { };
+
+    z_stream* z_s = File_Decomp_Get_Inflate(31);
+    REQUIRE(z_s != nullptr);
+    CHECK(Inflate_Test(z_s, 31));
+    CHECK(fd_pool_stats.pool_misses == 1);
+
+    File_Decomp_Put_Inflate(z_s);
+    CHECK(fd_pool_stats.pool_max_bytes == FD_ZLIB_SIZE);
+
+    // same stream, reset for raw deflate
+    z_stream* z_r = File_Decomp_Get_Inflate(-MAX_WBITS);
+    REQUIRE(z_r == z_s);
+    CHECK(fd_pool_stats.pool_hits == 1);
+    CHECK(Inflate_Test(z_r, -MAX_WBITS));
+
+    File_Decomp_Put_Inflate(z_r);
+    File_Decomp_Put_Inflate(nullptr);
+    File_Decomp_Pool_Term();
+}
+
+TEST_CASE("File_Decomp_Put_Inflate-memcap", "[file_decomp_pool]")
+{
+    size_t memcap = fd_pool_memcap;
+
+    File_Decomp_Pool_Term();
+    File_Decomp_Set_Pool_Memcap(FD_ZLIB_SIZE);
+    fd_pool_stats = { };
+
+    z_stream* z1 = File_Decomp_Get_Inflate(MAX_WBITS);
+    z_stream* z2 = File_Decomp_Get_Inflate(MAX_WBITS);
+    REQUIRE(z1 != nullptr);
+    REQUIRE(z2 != nullptr);
+
+    File_Decomp_Put_Inflate(z1);
+    File_Decomp_Put_Inflate(z2);
+    CHECK(fd_pool_stats.pool_frees == 1);
+
+    CHECK(File_Decomp_Get_Inflate(MAX_WBITS) == z1);
+    File_Decomp_Put_Inflate(z1);
+
+    File_Decomp_Set_Pool_Memcap(0);
+    z1 = File_Decomp_Get_Inflate(MAX_WBITS);
+    z2 = File_Decomp_Get_Inflate(MAX_WBITS);
+    File_Decomp_Put_Inflate(z1);
+    File_Decomp_Put_Inflate(z2);
+    CHECK(fd_pool_stats.pool_hits == 2);
+    CHECK(fd_pool_stats.pool_frees == 3);
+
+    File_Decomp_Set_Pool_Memcap(memcap);
+    File_Decomp_Pool_Term();
+}
+
+#ifdef HAVE_LZMA
+TEST_CASE("File_Decomp_Get_LZMA-reuse", "[file_decomp_pool]")
+{
+    File_Decomp_Pool_Term();
+    fd_pool_stats = { };
+
+    lzma_stream* l_s = File_Decomp_Get_LZMA();
+    REQUIRE(l_s != nullptr);
+    File_Decomp_Put_LZMA(l_s);
+    CHECK(fd_pool_stats.pool_max_bytes > sizeof(lzma_stream));
+
+    CHECK(File_Decomp_Get_LZMA() == l_s);
+    CHECK(fd_pool_stats.pool_hits == 1);
+    CHECK(fd_pool_stats.pool_misses == 1);
+
+    File_Decomp_Put_LZMA(l_s);
+    File_Decomp_Pool_Term();
+}
+#endif
+
+#endif
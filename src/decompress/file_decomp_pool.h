@@ -0,0 +1,74 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// file_decomp_pool.h
+
+#ifndef FILE_DECOMP_POOL_H
+#define FILE_DECOMP_POOL_H
+
+// per-thread pool of decompression streams.
+//
+// a PDF may hold many small deflated streams and a ZIP many small
+// entries, and setting up and tearing down a zlib or LZMA stream for each
+// one can cost more than decompressing it.  streams are instead taken
+// from a per-thread pool, reset for the new data, and put back when done.
+// idle streams are kept up to file_decomp.pool_memcap (estimated) bytes,
+// the rest are freed when they are put back.
+
+#ifdef HAVE_LZMA
+#include <lzma.h>
+#endif
+
+#include <zlib.h>
+
+#include "framework/counts.h"
+#include "main/thread.h"
+
+#define FD_POOL_MEMCAP_DEFAULT 1048576
+
+struct FileDecompPoolStats
+{
+    PegCount pool_hits;
+    PegCount pool_misses;
+    PegCount pool_frees;
+    PegCount pool_max_bytes;
+};
+
+extern THREAD_LOCAL FileDecompPoolStats fd_pool_stats;
+
+/* Returns an inflate stream set up for window_bits or nullptr on error */
+z_stream* File_Decomp_Get_Inflate(int window_bits);
+
+/* Returns the stream to the pool, nullptr is ignored */
+void File_Decomp_Put_Inflate(z_stream*);
+
+#ifdef HAVE_LZMA
+/* Returns an LZMA_Alone decoder or nullptr on error */
+lzma_stream* File_Decomp_Get_LZMA();
+
+void File_Decomp_Put_LZMA(lzma_stream*);
+#endif
+
+/* Upper limit for idle streams of this thread, set from the thread's
+   config at start and when a reloaded config is swapped in */
+void File_Decomp_Set_Pool_Memcap(size_t);
+
+/* Frees the idle streams of this thread */
+void File_Decomp_Pool_Term();
+
+#endif
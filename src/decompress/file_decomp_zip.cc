@@ -26,34 +26,30 @@
 #include "helpers/boyer_moore_search.h"
 #include "utils/util.h"
 
+#include "file_decomp_pool.h"
+
 using namespace snort;
 
 // initialize zlib decompression
 static fd_status_t Inflate_Init(fd_session_t* SessionPtr)
 {
-    z_stream* z_s = &(SessionPtr->ZIP->Stream);
+    z_stream* z_s = File_Decomp_Get_Inflate(-MAX_WBITS);
 
-    memset((char*)z_s, 0, sizeof(z_stream));
+    if ( z_s == nullptr )
+        return File_Decomp_Error;
 
-    z_s->zalloc = (alloc_func)nullptr;
-    z_s->zfree = (free_func)nullptr;
+    SessionPtr->ZIP->Stream = z_s;
 
     SYNC_IN(z_s)
 
-    int z_ret = inflateInit2(z_s, -MAX_WBITS);
-
-    if ( z_ret != Z_OK )
-        return File_Decomp_Error;
-
     return File_Decomp_OK;
 }
 
 // end zlib decompression
 static fd_status_t Inflate_End(fd_session_t* SessionPtr)
 {
-    z_stream* z_s = &(SessionPtr->ZIP->Stream);
-
-    inflateEnd(z_s);
+    File_Decomp_Put_Inflate(SessionPtr->ZIP->Stream);
+    SessionPtr->ZIP->Stream = nullptr;
 
     return File_Decomp_OK;
 }
@@ -63,7 +59,7 @@ static fd_status_t Inflate(fd_session_t* SessionPtr)
 {
     const uint8_t *zlib_start, *zlib_end;
 
-    z_stream* z_s = &(SessionPtr->ZIP->Stream);
+    z_stream* z_s = SessionPtr->ZIP->Stream;
 
     zlib_start = SessionPtr->Next_In;
 
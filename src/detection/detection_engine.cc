@@ -243,6 +243,8 @@ void DetectionEngine::finish_inspect_with_latency(Packet* p)
     if ( p->has_ip() )
         check_tags(p);
 
+    DataBus::publish(get_pub_id(), DetectionEventIds::POST_DETECTION, p);
+
     InspectorManager::probe(p);
 }
 
@@ -61,6 +61,8 @@ public:
     static uint8_t* get_next_buffer(unsigned& max);
 
     static void enable_offload();
+    static bool is_offload_enabled()
+    { return offload_enabled; }
     static bool offload(Packet*);
 
     static void onload(Flow*);
@@ -29,7 +29,6 @@
 
 #include "log/messages.h"
 #include "main/snort_config.h"
-#include "main/thread_config.h"
 #include "trace/trace.h"
 
 #include "detect_trace.h"
@@ -96,7 +95,7 @@ static const Parameter detection_params[] =
       "minimum sizeof PDU to offload fast pattern search (defaults to disabled)" },
 
     { "offload_threads", Parameter::PT_INT, "0:max32", "0",
-      "maximum number of simultaneous offloads (defaults to disabled)" },
+      "maximum number of simultaneous offloads per packet thread and number of shared offload threads (defaults to disabled)" },
 
     { "pcre_enable", Parameter::PT_BOOL, nullptr, "true",
       "enable pcre pattern matching" },
@@ -191,9 +190,6 @@ bool DetectionModule::end(const char* fqn, int idx, SnortConfig* sc)
         return add_service_extension(sc);
     }
 
-    if ( sc->offload_threads and ThreadConfig::get_instance_max() != 1 )
-        ParseError("You can not enable experimental offload with more than one packet thread.");
-
     if ( sc->offload_limit < 99999 )
         DetectionEngine::enable_offload();
 
@@ -684,6 +684,9 @@ static void detection_option_node_update_otn_stats(detection_option_tree_node_t*
 
         local_stats.latency_suspends += stats->latency_suspends;
         local_stats.latency_timeouts += stats->latency_timeouts;
+
+        if ( !local_stats.latency )
+            local_stats.latency = stats->latency;
     }
 
     if ( node->option_type == RULE_OPTION_TYPE_LEAF_NODE )
@@ -716,6 +719,14 @@ static void detection_option_node_update_otn_stats(detection_option_tree_node_t*
         totals.latency_suspends += state.latency_suspends;
         totals.matches += state.matches;
         totals.alerts += state.alerts;
+
+        if ( local_stats.latency )
+        {
+            if ( !totals.latency )
+                totals.latency = std::make_shared<LatencyHistogram>();
+
+            *totals.latency += *local_stats.latency;
+        }
     }
 
     if ( node->num_children )
@@ -725,6 +736,29 @@ static void detection_option_node_update_otn_stats(detection_option_tree_node_t*
     }
 }
 
+// true if only one rule is below this node
+static bool single_rule(const detection_option_tree_node_t* node)
+{
+    while ( node->num_children == 1 )
+        node = node->children[0];
+
+    return node->option_type == RULE_OPTION_TYPE_LEAF_NODE;
+}
+
+// rules sharing their first options get separate histograms from the first
+// node of each branch that leads to one rule
+void detection_option_tree_set_rule_latency(detection_option_tree_node_t* node)
+{
+    if ( single_rule(node) )
+    {
+        node->set_rule_latency();
+        return;
+    }
+
+    for ( int i = 0; i < node->num_children; ++i )
+        detection_option_tree_set_rule_latency(node->children[i]);
+}
+
 static void detection_option_node_reset_otn_stats(detection_option_tree_node_t* node,
     unsigned thread_id)
 {
@@ -1253,4 +1287,60 @@ TEST_CASE("Detection Engine: skip_on_retry", "[de_core]")
     }
 }
 
+static detection_option_tree_node_t* add_child(
+    detection_option_tree_node_t* parent, detection_option_tree_node_t* child)
+{
+    // room for the two children used here
+    if ( !parent->children )
+        parent->children = (detection_option_tree_node_t**)snort_calloc(2, sizeof(child));
+
+    assert(parent->num_children < 2);
+    parent->children[parent->num_children++] = child;
+    return child;
+}
+
+TEST_CASE("Detection Engine: rule latency with shared first option", "[de_core]")
+{
+    OptTreeNode otn_a, otn_b;
+    otn_a.state = new OtnState[ThreadConfig::get_instance_max()];
+    otn_b.state = new OtnState[ThreadConfig::get_instance_max()];
+
+    // rules a and b share their first option
+    auto* first = new detection_option_tree_node_t(RULE_OPTION_TYPE_OTHER, nullptr);
+    auto* opt_a = add_child(first, new detection_option_tree_node_t(RULE_OPTION_TYPE_OTHER, nullptr));
+    auto* opt_b = add_child(first, new detection_option_tree_node_t(RULE_OPTION_TYPE_OTHER, nullptr));
+    auto* leaf_a = add_child(opt_a, new detection_option_tree_node_t(RULE_OPTION_TYPE_LEAF_NODE, &otn_a));
+    auto* leaf_b = add_child(opt_b, new detection_option_tree_node_t(RULE_OPTION_TYPE_LEAF_NODE, &otn_b));
+
+    detection_option_tree_set_rule_latency(first);
+    CHECK(!first->state[0].rule_latency);
+    CHECK(opt_a->state[0].rule_latency);
+    CHECK(opt_b->state[0].rule_latency);
+    CHECK(!leaf_a->state[0].rule_latency);
+
+    first->state[0].update(hr_duration(300), true);
+    opt_a->state[0].update(hr_duration(100), true);
+    opt_a->state[0].update(hr_duration(100), true);
+    opt_b->state[0].update(hr_duration(200), false);
+    leaf_a->state[0].update(hr_duration(1), true);
+    leaf_a->state[0].update(hr_duration(1), true);
+    leaf_b->state[0].update(hr_duration(1), true);
+
+    std::unordered_map<SigInfo*, OtnState> stats;
+    detection_option_node_update_otn_stats(first, nullptr, 0, stats);
+
+    const auto& hist_a = stats[&otn_a.sigInfo].latency;
+    const auto& hist_b = stats[&otn_b.sigInfo].latency;
+
+    REQUIRE(hist_a);
+    REQUIRE(hist_b);
+    CHECK(hist_a != hist_b);
+    CHECK(hist_a->total() == 2);
+    CHECK(hist_a->max == (uint64_t)TO_TICKS(hr_duration(100)));
+    CHECK(hist_b->total() == 1);
+    CHECK(hist_b->max == (uint64_t)TO_TICKS(hr_duration(200)));
+
+    delete first;
+}
+
 #endif
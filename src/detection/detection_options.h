@@ -38,6 +38,7 @@
 #include "detection/rule_option_types.h"
 #include "latency/rule_latency_state.h"
 #include "main/thread_config.h"
+#include "profiler/latency_histogram.h"
 #include "time/clock_defs.h"
 #include "trace/trace_api.h"
 #include "utils/util.h"
@@ -93,12 +94,20 @@ struct dot_node_state_t
     unsigned latency_timeouts;
     unsigned latency_suspends;
 
+    // latency distribution of the checks of a single rule's options; only
+    // kept by the first node that belongs to one rule and allocated when
+    // first profiled.  owned by the tree node.
+    LatencyHistogram* latency;
+    bool rule_latency;
+
     dot_node_state_t()
     {
         result = 0;
         conts = nullptr;
         memset(&last_check, 0, sizeof(last_check));
         context_num = run_num = 0;
+        latency = nullptr;
+        rule_latency = false;
         reset_profiling();
     }
 
@@ -113,6 +122,14 @@ struct dot_node_state_t
             elapsed_no_match += delta;
 
         ++checks;
+
+        if ( rule_latency )
+        {
+            if ( !latency )
+                latency = new LatencyHistogram;
+
+            latency->update(TO_TICKS(delta));
+        }
     }
 
     void reset_profiling()
@@ -120,6 +137,9 @@ struct dot_node_state_t
         elapsed = elapsed_match = elapsed_no_match = 0_ticks;
         checks = disables = 0;
         latency_suspends = latency_timeouts = 0;
+
+        if ( latency )
+            latency->reset();
     }
 };
 
@@ -162,8 +182,18 @@ struct detection_option_tree_node_t : public detection_option_tree_bud_t
             delete children[i];
 
         snort_free(children);
+
+        for ( unsigned i = 0; i < snort::ThreadConfig::get_instance_max(); ++i )
+            delete state[i].latency;
+
         delete[] state;
     }
+
+    void set_rule_latency()
+    {
+        for ( unsigned i = 0; i < snort::ThreadConfig::get_instance_max(); ++i )
+            state[i].rule_latency = true;
+    }
 };
 
 struct detection_option_tree_root_t : public detection_option_tree_bud_t
@@ -221,6 +251,7 @@ int detection_option_node_evaluate(
     const detection_option_tree_node_t*, detection_option_eval_data_t&, const class Cursor&);
 
 void print_option_tree(detection_option_tree_node_t*, int level);
+void detection_option_tree_set_rule_latency(detection_option_tree_node_t*);
 void detection_option_tree_update_otn_stats(std::vector<snort::HashNode*>&,
     std::unordered_map<SigInfo*, OtnState>&, unsigned);
 void detection_option_tree_reset_otn_stats(std::vector<snort::HashNode*>&, unsigned);
@@ -130,6 +130,12 @@ public:
     unsigned get_queue_limit() const
     { return queue_limit; }
 
+    void set_reload_compile_threads(unsigned n)
+    { reload_compile_threads = n; }
+
+    unsigned get_reload_compile_threads() const
+    { return reload_compile_threads; }
+
     const snort::MpseApi* get_search_api() const
     { return search_api; }
 
@@ -158,6 +164,7 @@ private:
     unsigned max_pattern_len = 0;
 
     unsigned queue_limit = 0;
+    unsigned reload_compile_threads = 0;
 
     int portlists_flags = 0;
     unsigned num_patterns_truncated = 0;  // due to max_pattern_len
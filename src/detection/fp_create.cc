@@ -124,6 +124,7 @@ static int finalize_detection_option_tree(SnortConfig* sc, detection_option_tree
         else
         {
             fixup_tree(root->children[i], true, 0);
+            detection_option_tree_set_rule_latency(node);
 
             trace_logf(detection_trace, TRACE_OPTION_TREE, nullptr, "%3d %3d  %p %4s\n",
                 0, root->num_children, (void*)root, "root");
@@ -1529,11 +1530,8 @@ static void fpCreateServiceRuleGroups(SnortConfig* sc)
     sc->srmmTable = nullptr;
 }
 
-static unsigned can_build_mt(FastPatternConfig* fp)
+static bool can_build_mt(FastPatternConfig* fp)
 {
-    if ( Snort::is_reloading() )
-        return false;
-
     const MpseApi* search_api = fp->get_search_api();
     assert(search_api);
 
@@ -1548,6 +1546,21 @@ static unsigned can_build_mt(FastPatternConfig* fp)
     return true;
 }
 
+// reload compiles with a bounded pool of background threads while the
+// packet threads keep running; startup uses one thread per packet thread
+static unsigned get_compile_threads(SnortConfig* sc)
+{
+    FastPatternConfig* fp = sc->fast_pattern_config;
+
+    if ( !can_build_mt(fp) )
+        return 0;
+
+    if ( Snort::is_reloading() )
+        return fp->get_reload_compile_threads();
+
+    return sc->num_slots;
+}
+
 /*
 *  7/2007 - man
 *  Build Pattern Groups for 1st pass of content searching using
@@ -1602,6 +1615,7 @@ int fpCreateFastPacketDetection(SnortConfig* sc)
 
     unsigned mpse_loaded = 0;
     unsigned mpse_dumped = 0;
+    unsigned mpse_reused = 0;
 
     if ( !sc->test_mode() or sc->mem_check() )
     {
@@ -1610,7 +1624,15 @@ int fpCreateFastPacketDetection(SnortConfig* sc)
             mpse_loaded = fp_deserialize(sc, fp->get_rule_db_dir());
 #endif
 
-        unsigned c = compile_mpses(sc, can_build_mt(fp));
+        if ( Snort::is_reloading() )
+        {
+            mpse_reused = fp_reuse(sc, SnortConfig::get_conf());
+            proc_stats.reload_mpse_reused += mpse_reused;
+            proc_stats.reload_mpse_rebuilt +=
+                mpse_count + offload_mpse_count - mpse_loaded - mpse_reused;
+        }
+
+        unsigned c = compile_mpses(sc, get_compile_threads(sc), Snort::is_reloading());
         unsigned expected = mpse_count + offload_mpse_count;
 
         if ( c != expected )
@@ -1643,6 +1665,19 @@ int fpCreateFastPacketDetection(SnortConfig* sc)
     LogCount("fast pattern only", fp_only);
     LogCount("mpse_loaded", mpse_loaded);
     LogCount("mpse_dumped", mpse_dumped);
+    LogCount("mpse_reused", mpse_reused);
+
+#ifndef REG_TEST
+    const MpseCompileStats& cs = get_mpse_compile_stats();
+
+    if ( cs.groups )
+    {
+        LogCount("compile threads", cs.threads);
+        LogStat("compile time (s)", cs.wall_usecs / 1e6);
+        LogStat("group compile time (s)", cs.total_usecs / 1e6);
+        LogStat("max group compile (s)", cs.max_usecs / 1e6);
+    }
+#endif
 
     MpseManager::setup_search_engine(fp->get_search_api(), sc);
 
@@ -22,7 +22,12 @@
 
 #include "fp_utils.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
 #include <cstring>
 #include <fstream>
 #include <iomanip>
@@ -32,14 +37,18 @@
 #include <thread>
 #include <unordered_map>
 
+#include <sys/resource.h>
+
 #include "framework/inspector.h"
 #include "framework/mpse.h"
 #include "framework/mpse_batch.h"
 #include "hash/ghash.h"
 #include "ips_options/ips_flowbits.h"
 #include "log/messages.h"
+#include "main/reload_tracker.h"
 #include "main/snort_config.h"
 #include "main/thread.h"
+#include "main/thread_config.h"
 #include "parser/parse_conf.h"
 #include "pattern_match_data.h"
 #include "ports/port_group.h"
@@ -274,7 +283,8 @@ bool FpSelector::is_better_than(
 // mpse database serialization
 //--------------------------------------------------------------------------
 
-static unsigned mpse_loaded, mpse_dumped;
+static unsigned mpse_loaded, mpse_dumped, mpse_reused;
+static std::unordered_map<std::string, Mpse*> s_reusable;
 
 static bool store(const std::string& s, const uint8_t* data, size_t len)
 {
@@ -392,6 +402,55 @@ static bool db_load(const std::string& path, const char* proto, const char* dir,
     return true;
 }
 
+// index the outgoing config's engines by group and hash; the path is unused
+static bool db_index(const std::string&, const char* proto, const char* dir, RuleGroup* g)
+{
+    for ( int sect = PS_NONE; sect <= PS_MAX; sect++)
+    {
+        for ( auto it : g->pm_list[sect] )
+        {
+            if ( it->group.normal_is_dup or !it->group.normal_mpse )
+                continue;
+
+            std::string id;
+            it->group.normal_mpse->get_hash(id);
+
+            if ( !id.empty() )
+                s_reusable[make_db_name("", proto, dir, it->name, id, sect)] = it->group.normal_mpse;
+        }
+    }
+    return true;
+}
+
+static bool db_reuse(const std::string&, const char* proto, const char* dir, RuleGroup* g)
+{
+    for ( int sect = PS_NONE; sect <= PS_MAX; sect++)
+    {
+        for ( auto it : g->pm_list[sect] )
+        {
+            Mpse* mpse = it->group.normal_mpse;
+
+            if ( it->group.normal_is_dup or !mpse )
+                continue;
+
+            std::string id;
+            mpse->get_hash(id);
+
+            if ( id.empty() )
+                continue;
+
+            auto old = s_reusable.find(make_db_name("", proto, dir, it->name, id, sect));
+
+            if ( old == s_reusable.end() or old->second->get_api() != mpse->get_api() )
+                continue;
+
+            if ( mpse->adopt(*old->second) )
+                ++mpse_reused;
+        }
+    }
+    return true;
+}
+
 typedef bool (*db_io)(const std::string&, const char*, const char*, RuleGroup*);
 
 static void port_io(
@@ -469,6 +528,22 @@ unsigned fp_deserialize(const SnortConfig* sc, const std::string& dir)
     return mpse_loaded;
 }
 
+unsigned fp_reuse(const SnortConfig* sc, const SnortConfig* old)
+{
+    mpse_reused = 0;
+
+    if ( !old or !old->port_tables or !old->spgmmTable )
+        return 0;
+
+    fp_io(old, "", db_index);
+
+    if ( !s_reusable.empty() )
+        fp_io(sc, "", db_reuse);
+
+    s_reusable.clear();
+    return mpse_reused;
+}
+
 bool has_service_rule_opt(OptTreeNode* otn)
 {
     for (OptFpList* ofl = otn->opt_func; ofl; ofl = ofl->next)
@@ -674,8 +749,24 @@ bool is_flowbit_setter(const OptFpList* ofp)
 // mpse compile threads
 //--------------------------------------------------------------------------
 
+#define COMPILE_THREAD_NAME "compile"
+#define COMPILE_THREAD_NICE 19
+#define COMPILE_PROGRESS_SECS 5
+
 static std::list<Mpse*> s_tbd;
 static std::mutex s_mutex;
+static std::condition_variable s_done_cond;
+static MpseCompileStats s_stats;
+static std::atomic<unsigned> s_done { 0 };
+static unsigned s_active = 0;
+
+using CompileClock = std::chrono::steady_clock;
+
+static uint64_t get_usecs(CompileClock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        CompileClock::now() - start).count();
+}
 
 static Mpse* get_mpse()
 {
@@ -690,23 +781,53 @@ static Mpse* get_mpse()
     return m;
 }
 
-static void compile_mpse(SnortConfig* sc, unsigned id, unsigned* count)
+static void compile_mpse(SnortConfig* sc, unsigned id, unsigned* count, bool background)
 {
     set_instance_id(id);
     unsigned c = 0;
 
+    if ( background )
+    {
+        // keep off the packet thread cores and yield to them
+        sc->thread_config->implement_named_thread_affinity(COMPILE_THREAD_NAME);
+        setpriority(PRIO_PROCESS, gettid(), COMPILE_THREAD_NICE);
+    }
+
+    MpseCompileStats stats;
+    const FastPatternConfig* fp = sc->fast_pattern_config;
+
     while ( Mpse* m = get_mpse() )
     {
+        auto start = CompileClock::now();
+
         if ( !m->prep_patterns(sc) )
         {
-            if ( sc->fast_pattern_config->get_debug_mode() )
+            if ( fp->get_debug_mode() )
                 m->print_info();
 
             c++;
         }
+
+        uint64_t usecs = get_usecs(start);
+
+        if ( fp->get_debug_print_rule_group_build_details() )
+            LogMessage("%s group with %d patterns compiled in %" PRIu64 " usecs\n",
+                m->get_method(), m->get_pattern_count(), usecs);
+
+        stats.groups++;
+        stats.total_usecs += usecs;
+        stats.max_usecs = std::max(stats.max_usecs, usecs);
+        s_done++;
     }
     std::lock_guard<std::mutex> lock(s_mutex);
     *count += c;
+
+    if ( !--s_active )
+        s_done_cond.notify_one();
+
+    s_stats.groups += stats.groups;
+    s_stats.total_usecs += stats.total_usecs;
+    s_stats.max_usecs = std::max(s_stats.max_usecs, stats.max_usecs);
 }
 
 void queue_mpse(Mpse* m)
@@ -714,30 +835,63 @@ void queue_mpse(Mpse* m)
     s_tbd.push_back(m);
 }
 
-unsigned compile_mpses(struct SnortConfig* sc, bool parallel)
+const MpseCompileStats& get_mpse_compile_stats()
+{ return s_stats; }
+
+static void report_progress(unsigned total)
+{
+    std::unique_lock<std::mutex> lock(s_mutex);
+
+    while ( !s_done_cond.wait_for(lock, std::chrono::seconds(COMPILE_PROGRESS_SECS),
+        [] { return !s_active; }) )
+    {
+        std::string status = "compiled " + std::to_string(s_done) + " of " +
+            std::to_string(total) + " search engines";
+
+        lock.unlock();
+        ReloadTracker::progress(status.c_str());
+        lock.lock();
+    }
+}
+
+unsigned compile_mpses(struct SnortConfig* sc, unsigned threads, bool background)
 {
     std::list<std::thread*> workers;
-    unsigned max = parallel ? sc->num_slots : 1;
+    const unsigned total = s_tbd.size();
+    unsigned max = std::min(threads, total);
     unsigned count = 0;
 
-    if ( max == 1 )
+    s_stats = { };
+    s_stats.threads = std::max(max, 1u);
+    s_done = 0;
+    auto start = CompileClock::now();
+
+    if ( !max or (max == 1 and !background) )
     {
-        compile_mpse(sc, get_instance_id(), &count);
+        s_active = 1;
+        compile_mpse(sc, get_instance_id(), &count, false);
+        s_stats.wall_usecs = get_usecs(start);
         return count;
     }
 
+    s_active = max;
+
     for ( unsigned i = 0; i < max; ++i )
     {
-        auto* w = new std::thread(compile_mpse, sc, i, &count);
+        auto* w = new std::thread(compile_mpse, sc, i, &count, background);
         SET_THREAD_NAME(w->native_handle(), "snort3.compile");
         workers.push_back(w);
     }
 
+    if ( background )
+        report_progress(total);
+
     for ( auto* w : workers )
     {
         w->join();
         delete w;
     }
+    s_stats.wall_usecs = get_usecs(start);
     return count;
 }
 
@@ -23,6 +23,7 @@
 
 // fast pattern utilities
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -46,8 +47,20 @@ bool set_fp_content(OptTreeNode*);
 std::vector <PatternMatchData*> get_fp_content(
     OptTreeNode*, OptFpList*& pat, snort::IpsOption*& buf, bool srvc, bool only_literals, bool& exclude);
 
+struct MpseCompileStats
+{
+    unsigned threads = 0;
+    unsigned groups = 0;
+    uint64_t total_usecs = 0;  // sum over groups
+    uint64_t max_usecs = 0;    // slowest group
+    uint64_t wall_usecs = 0;
+};
+
 void queue_mpse(snort::Mpse*);
-unsigned compile_mpses(struct snort::SnortConfig*, bool parallel = false);
+// threads = 0 compiles on the calling thread; background threads run at low
+// priority with the compile thread affinity and report progress on reload
+unsigned compile_mpses(struct snort::SnortConfig*, unsigned threads = 0, bool background = false);
+const MpseCompileStats& get_mpse_compile_stats();
 
 bool has_service_rule_opt(OptTreeNode*);
 void validate_services(struct snort::SnortConfig*, OptTreeNode*);
@@ -55,6 +68,9 @@ void validate_services(struct snort::SnortConfig*, OptTreeNode*);
 unsigned fp_serialize(const struct snort::SnortConfig*, const std::string& dir);
 unsigned fp_deserialize(const struct snort::SnortConfig*, const std::string& dir);
 
+// adopt compiled search engines from the outgoing config on reload
+unsigned fp_reuse(const struct snort::SnortConfig*, const struct snort::SnortConfig* old);
+
 void clear_buffer_map();
 void update_buffer_map(const char** bufs, const char* svc);
 void add_default_services(struct snort::SnortConfig*, const std::string&, OptTreeNode*);
@@ -33,6 +33,8 @@
 #include <vector>
 #include <thread>
 
+#include "main/thread.h"
+
 #include "fp_detect.h"
 #include "ips_context.h"
 #include "latency/packet_latency.h"
@@ -43,6 +45,10 @@
 #include "utils/stats.h"
 #include "utils/util.h"
 
+#ifdef UNIT_TEST
+#include "catch/snort_catch.h"
+#endif
+
 using namespace snort;
 
 // FIXIT-L this could be offloader specific
@@ -50,10 +56,6 @@ struct RegexRequest
 {
     Packet* packet = nullptr;
 
-    std::thread* thread;
-    std::mutex mutex;
-    std::condition_variable cond;
-
 #ifdef REG_TEST
     // used to make main thread wait for results to get predictable behavior
     std::mutex sync_mutex;
@@ -61,8 +63,6 @@ struct RegexRequest
 #endif
 
     std::atomic<bool> offload { false };
-
-    bool go = true;
 };
 
 RegexOffload* RegexOffload::get_offloader(unsigned max, bool async)
@@ -173,42 +173,380 @@ bool MpseRegexOffload::get(Packet*& p)
 }
 
 //--------------------------------------------------------------------------
-// async (threads) offload implementation
+// shared offload workers
 //--------------------------------------------------------------------------
 
-ThreadRegexOffload::ThreadRegexOffload(unsigned max) : RegexOffload(max)
+// bounded queue with a single producer (the packet thread) and multiple
+// consumers (the workers); each cell's sequence number tells whether it is
+// free for the producer or ready for a consumer so no locks are needed.
+class RequestQueue
+{
+public:
+    explicit RequestQueue(unsigned max)
+    {
+        size_t n = 1;
+
+        while ( n < max )
+            n <<= 1;
+
+        mask = n - 1;
+        cells = new Cell[n];
+
+        for ( size_t i = 0; i < n; ++i )
+            cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    ~RequestQueue()
+    { delete[] cells; }
+
+    bool push(RegexRequest* req)
+    {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Cell& c = cells[pos & mask];
+
+        if ( c.seq.load(std::memory_order_acquire) != pos )
+            return false;
+
+        c.req = req;
+        c.seq.store(pos + 1, std::memory_order_release);
+        tail.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    RegexRequest* pop()
+    {
+        size_t pos = head.load(std::memory_order_relaxed);
+
+        while ( true )
+        {
+            Cell& c = cells[pos & mask];
+            size_t seq = c.seq.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+
+            if ( dif < 0 )
+                return nullptr;
+
+            if ( dif > 0 )
+                pos = head.load(std::memory_order_relaxed);
+
+            else if ( head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) )
+            {
+                RegexRequest* req = c.req;
+                c.seq.store(pos + mask + 1, std::memory_order_release);
+                return req;
+            }
+        }
+    }
+
+    unsigned size() const
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_relaxed);
+        return t > h ? t - h : 0;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        RegexRequest* req = nullptr;
+    };
+
+    Cell* cells;
+    size_t mask;
+
+    alignas(64) std::atomic<size_t> head { 0 };
+    alignas(64) std::atomic<size_t> tail { 0 };
+};
+
+// the queues of all packet threads and the number of requests in them.
+// the count is raised before a request is published and lowered after it
+// is taken so a consumer can never take it below zero; at worst it briefly
+// includes a request that is not yet visible.
+class RequestQueues
+{
+public:
+    RequestQueues(unsigned num, unsigned max)
+    {
+        for ( unsigned i = 0; i < num; ++i )
+            queues.emplace_back(new RequestQueue(max));
+    }
+
+    ~RequestQueues()
+    {
+        for ( auto* q : queues )
+        {
+            assert(!q->size());
+            delete q;
+        }
+    }
+
+    // returns the depth of the slot's queue
+    unsigned push(unsigned slot, RegexRequest* req)
+    {
+        assert(slot < queues.size());
+        RequestQueue* q = queues[slot];
+
+        pending++;
+
+        if ( !q->push(req) )
+        {
+            pending--;
+            assert(false);
+        }
+        return q->size();
+    }
+
+    RegexRequest* pop(unsigned slot)
+    {
+        RegexRequest* req = queues[slot]->pop();
+
+        if ( req )
+            pending--;
+
+        return req;
+    }
+
+    unsigned size() const
+    { return queues.size(); }
+
+    int get_pending() const
+    { return pending; }
+
+private:
+    std::vector<RequestQueue*> queues;
+    std::atomic<int> pending { 0 };
+};
+
+// one pool of workers is shared by all packet threads.  there is one queue
+// per packet thread and each queue has a home worker; idle workers steal
+// from the other queues.  workers only block when all queues are empty.
+class RegexOffloadPool
+{
+public:
+    static RegexOffloadPool* acquire(unsigned max);
+    static void release();
+
+    unsigned submit(unsigned slot, RegexRequest*);
+
+private:
+    RegexOffloadPool(unsigned max);
+    ~RegexOffloadPool();
+
+    void worker(SnortConfig*, unsigned id);
+    RegexRequest* next(unsigned id);
+    bool wait();
+
+    static void search(RegexRequest*);
+
+    RequestQueues queues;
+    std::vector<std::thread*> workers;
+
+    std::atomic<unsigned> sleepers { 0 };
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool go = true;
+
+    static std::mutex s_mutex;
+    static RegexOffloadPool* s_pool;
+    static unsigned s_users;
+};
+
+std::mutex RegexOffloadPool::s_mutex;
+RegexOffloadPool* RegexOffloadPool::s_pool = nullptr;
+unsigned RegexOffloadPool::s_users = 0;
+
+RegexOffloadPool* RegexOffloadPool::acquire(unsigned max)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    if ( !s_pool )
+        s_pool = new RegexOffloadPool(max);
+
+    ++s_users;
+    return s_pool;
+}
+
+void RegexOffloadPool::release()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    assert(s_users);
+
+    if ( --s_users )
+        return;
+
+    delete s_pool;
+    s_pool = nullptr;
+}
+
+// each packet thread has at most max requests outstanding
+RegexOffloadPool::RegexOffloadPool(unsigned max) :
+    queues(ThreadConfig::get_instance_max(), max)
 {
-    unsigned i = ThreadConfig::get_instance_max();
     SnortConfig* sc = SnortConfig::get_main_conf();
 
-    for ( auto* req : idle )
+    for ( unsigned i = 0; i < max; ++i )
     {
         ModuleManager::add_thread_stats_entry("search_engine");
         ModuleManager::add_thread_stats_entry("detection");
-        req->thread = new std::thread(worker, req, sc, i++);
-        SET_THREAD_NAME(req->thread->native_handle(), "snort3.regex");
+        auto* w = new std::thread(&RegexOffloadPool::worker, this, sc, i);
+        SET_THREAD_NAME(w->native_handle(), "snort3.regex");
+        workers.emplace_back(w);
     }
 }
 
-ThreadRegexOffload::~ThreadRegexOffload()
+RegexOffloadPool::~RegexOffloadPool()
 {
-    for ( auto* req : idle )
     {
-        req->thread->join();
-        delete req->thread;
+        std::lock_guard<std::mutex> lock(mutex);
+        go = false;
+        cond.notify_all();
+    }
+
+    for ( auto* w : workers )
+    {
+        w->join();
+        delete w;
     }
 }
 
-void ThreadRegexOffload::stop()
+unsigned RegexOffloadPool::submit(unsigned slot, RegexRequest* req)
 {
-    RegexOffload::stop();
+    // the worker increments sleepers before checking pending and push
+    // increments pending before checking sleepers so one of us sees the
+    // other and the wakeup can't be lost
+    unsigned depth = queues.push(slot, req);
 
-    for ( auto* req : idle )
+    if ( sleepers )
     {
-        std::unique_lock<std::mutex> lock(req->mutex);
-        req->go = false;
-        req->cond.notify_one();
+        std::lock_guard<std::mutex> lock(mutex);
+        cond.notify_one();
     }
+    return depth;
+}
+
+RegexRequest* RegexOffloadPool::next(unsigned id)
+{
+    const unsigned nq = queues.size();
+    const unsigned nw = workers.size();
+
+    for ( unsigned i = 0; i < nq; ++i )
+    {
+        unsigned q = (id + i) % nq;
+
+        if ( q % nw != id )
+            continue;
+
+        if ( RegexRequest* req = queues.pop(q) )
+            return req;
+    }
+
+    for ( unsigned i = 1; i < nq; ++i )
+    {
+        unsigned q = (id + i) % nq;
+
+        if ( q % nw == id )
+            continue;
+
+        if ( RegexRequest* req = queues.pop(q) )
+        {
+            pc.offload_steals++;
+            return req;
+        }
+    }
+    return nullptr;
+}
+
+bool RegexOffloadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    sleepers++;
+    cond.wait(lock, [this]{ return !go or queues.get_pending() > 0; });
+    sleepers--;
+    return go;
+}
+
+void RegexOffloadPool::search(RegexRequest* req)
+{
+    assert(req->packet);
+    assert(req->packet->is_offloaded());
+    assert(req->packet->context->searches.items.size() > 0);
+
+    SnortConfig::set_conf(const_cast<SnortConfig*>(req->packet->context->conf));
+    IpsContext* c = req->packet->context;
+    Mpse::MpseRespType resp_ret;
+
+    c->searches.offload_search();
+
+    do
+    {
+        resp_ret = c->searches.receive_offload_responses();
+    }
+    while (resp_ret == Mpse::MPSE_RESP_NOT_COMPLETE);
+
+    if (resp_ret == Mpse::MPSE_RESP_COMPLETE_FAIL)
+    {
+        if (c->searches.can_fallback())
+        {
+            c->searches.search_sync();
+            pc.offload_fallback++;
+        }
+        pc.offload_failures++;
+    }
+
+    c->searches.items.clear();
+    req->offload = false;
+
+#ifdef REG_TEST
+    {
+        std::unique_lock<std::mutex> lock(req->sync_mutex);
+        req->sync_cond.notify_one();
+    }
+#endif
+}
+
+void RegexOffloadPool::worker(SnortConfig* initial_config, unsigned id)
+{
+    // slots past the packet threads are reserved for offload (see num_slots)
+    set_instance_id(ThreadConfig::get_instance_max() + id);
+    SnortConfig::set_conf(initial_config);
+
+    while ( true )
+    {
+        if ( RegexRequest* req = next(id) )
+            search(req);
+
+        else if ( !wait() )
+            break;
+    }
+    ModuleManager::accumulate_module("search_engine");
+    ModuleManager::accumulate_module("detection");
+
+    // FIXIT-M break this over-coupling. In reality we shouldn't be evaluating latency in offload.
+    PacketLatency::tterm();
+    RuleLatency::tterm();
+}
+
+//--------------------------------------------------------------------------
+// async (threads) offload implementation
+//--------------------------------------------------------------------------
+
+ThreadRegexOffload::ThreadRegexOffload(unsigned max) : RegexOffload(max)
+{
+    pool = RegexOffloadPool::acquire(max);
+    slot = get_instance_id();
+}
+
+ThreadRegexOffload::~ThreadRegexOffload()
+{
+    RegexOffloadPool::release();
+}
+
+void ThreadRegexOffload::stop()
+{
+    // the pool is stopped when the last packet thread releases it
+    RegexOffload::stop();
 }
 
 void ThreadRegexOffload::put(Packet* p)
@@ -226,13 +564,13 @@ void ThreadRegexOffload::put(Packet* p)
     busy.emplace_back(req);
     p->context->regex_req_it = std::prev(busy.end());
 
-    {
-        std::unique_lock<std::mutex> lock(req->mutex);
-        req->packet = p;
+    req->packet = p;
+    req->offload = true;
 
-        req->offload = true;
-        req->cond.notify_one();
-    }
+    unsigned depth = pool->submit(slot, req);
+
+    if ( depth > pc.offload_queue_max )
+        pc.offload_queue_max = depth;
 
 #ifdef REG_TEST
     {
@@ -269,67 +607,70 @@ bool ThreadRegexOffload::get(Packet*& p)
     return false;
 }
 
-void ThreadRegexOffload::worker(
-    RegexRequest* req, SnortConfig* initial_config, unsigned id)
+//--------------------------------------------------------------------------
+// unit tests
+//--------------------------------------------------------------------------
+
+#ifdef UNIT_TEST
+TEST_CASE("RequestQueues pending", "[regex_offload]")
 {
-    set_instance_id(id);
-    SnortConfig::set_conf(initial_config);
+    RegexRequest reqs[2];
+    RequestQueues queues(2, 2);
 
-    while ( true )
-    {
-        {
-            std::unique_lock<std::mutex> lock(req->mutex);
-            req->cond.wait_for(lock, std::chrono::seconds(1),
-                [&]{ return !req->go || req->offload; });
+    CHECK(queues.get_pending() == 0);
+    CHECK(queues.pop(0) == nullptr);
+    CHECK(queues.get_pending() == 0);
 
-            if ( !req->go )
-                break;
+    CHECK(queues.push(0, &reqs[0]) == 1);
+    CHECK(queues.push(1, &reqs[1]) == 1);
+    CHECK(queues.get_pending() == 2);
 
-            if ( !req->offload )
-                continue;
-        }
+    CHECK(queues.pop(1) == &reqs[1]);
+    CHECK(queues.pop(1) == nullptr);
+    CHECK(queues.pop(0) == &reqs[0]);
+    CHECK(queues.get_pending() == 0);
+}
 
-        assert(req->packet);
-        assert(req->packet->is_offloaded());
-        assert(req->packet->context->searches.items.size() > 0);
+TEST_CASE("RequestQueues submit and complete race", "[regex_offload]")
+{
+    const unsigned max = 4096;
+    const unsigned num_workers = 3;
 
-        SnortConfig::set_conf(const_cast<SnortConfig*>(req->packet->context->conf));
-        IpsContext* c = req->packet->context;
-        Mpse::MpseRespType resp_ret;
+    std::vector<RegexRequest> reqs(max);
+    RequestQueues queues(1, max);
 
-        c->searches.offload_search();
+    std::atomic<unsigned> taken { 0 };
+    std::atomic<bool> bogus { false };
 
-        do
+    // workers take requests as soon as they are visible and check that the
+    // count never drops below zero or wraps around
+    auto worker = [&]()
+    {
+        while ( taken < max )
         {
-            resp_ret = c->searches.receive_offload_responses();
-        }
-        while (resp_ret == Mpse::MPSE_RESP_NOT_COMPLETE);
+            if ( queues.pop(0) )
+                taken++;
 
-        if (resp_ret == Mpse::MPSE_RESP_COMPLETE_FAIL)
-        {
-            if (c->searches.can_fallback())
-            {
-                c->searches.search_sync();
-                pc.offload_fallback++;
-            }
-            pc.offload_failures++;
+            int n = queues.get_pending();
+
+            if ( n < 0 or n > (int)max )
+                bogus = true;
         }
+    };
 
-        c->searches.items.clear();
-        req->offload = false;
+    std::vector<std::thread> workers;
 
-#ifdef REG_TEST
-        {
-            std::unique_lock<std::mutex> lock(req->sync_mutex);
-            req->sync_cond.notify_one();
-        }
-#endif
-    }
-    ModuleManager::accumulate_module("search_engine");
-    ModuleManager::accumulate_module("detection");
+    for ( unsigned i = 0; i < num_workers; ++i )
+        workers.emplace_back(worker);
 
-    // FIXIT-M break this over-coupling. In reality we shouldn't be evaluating latency in offload.
-    PacketLatency::tterm();
-    RuleLatency::tterm();
-}
+    for ( auto& req : reqs )
+        queues.push(0, &req);
 
+    for ( auto& w : workers )
+        w.join();
+
+    CHECK(!bogus);
+    CHECK(taken == max);
+    CHECK(queues.get_pending() == 0);
+}
+#endif
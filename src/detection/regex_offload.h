@@ -25,12 +25,12 @@
 // There are two flavors: MPSE and thread.  The MpseRegexOffload interfaces to
 // an MPSE that is capable of regex offload such as the RXP whereas
 // ThreadRegexOffload implements the regex search in auxiliary threads w/o
-// requiring extra MPSE instances.  presently all offload is per packet thread;
-// packet threads do not share offload resources.
+// requiring extra MPSE instances.  each packet thread has its own set of
+// requests but the ThreadRegexOffload workers are shared by all packet
+// threads; each worker serves its own packet threads' queues first and
+// steals from the others when idle.
 
-#include <condition_variable>
 #include <list>
-#include <thread>
 
 namespace snort
 {
@@ -39,6 +39,7 @@ struct Packet;
 struct SnortConfig;
 }
 struct RegexRequest;
+class RegexOffloadPool;
 
 class RegexOffload
 {
@@ -88,7 +89,8 @@ public:
     bool get(snort::Packet*&) override;
 
 private:
-    static void worker(RegexRequest*, snort::SnortConfig*, unsigned id);
+    RegexOffloadPool* pool;
+    unsigned slot;
 };
 
 #endif
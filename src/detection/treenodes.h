@@ -22,6 +22,7 @@
 
 // rule header (RTN) and body (OTN) nodes
 
+#include <memory>
 #include <string>
 
 #include "detection/signature.h"
@@ -38,6 +39,7 @@ namespace snort
 class IpsOption;
 struct Packet;
 }
+struct LatencyHistogram;
 struct RuleTreeNode;
 struct PortObject;
 struct OutputSet;
@@ -73,6 +75,9 @@ struct OtnState
     uint64_t latency_timeouts = 0;
     uint64_t latency_suspends = 0;
 
+    // totals only; merged from the first tree node used only by this rule
+    std::shared_ptr<LatencyHistogram> latency;
+
     bool is_active() const
     { return elapsed > CLOCK_ZERO || checks > 0; }
 };
@@ -25,8 +25,13 @@
 
 using namespace snort;
 
+static std::atomic<uint32_t> policy_generation { 0 };
+
 FilePolicyBase::FilePolicyBase()
-{ ref_count = 1; }
+{
+    ref_count = 1;
+    generation = ++policy_generation;
+}
 
 FilePolicyBase::~FilePolicyBase()
 { assert(!ref_count); }
@@ -159,10 +159,16 @@ public:
     void add_ref()
     { ++ref_count; }
 
+    // unique to this instance so verdicts cached under an earlier
+    // configuration aren't used after a reload
+    uint32_t get_generation() const
+    { return generation; }
+
     SO_PUBLIC static void delete_file_policy(FilePolicyBase*);
 
 private:
     std::atomic_uint ref_count;
+    uint32_t generation;
 };
 
 inline void initFilePosition(FilePosition* position, uint64_t processed_size)
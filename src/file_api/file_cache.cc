@@ -23,6 +23,8 @@
 
 #include "file_cache.h"
 
+#include <algorithm>
+
 #include "flow/flow_key.h"
 #include "hash/hash_defs.h"
 #include "hash/xhash.h"
@@ -40,6 +42,7 @@
 #include "file_module.h"
 #include "file_service.h"
 #include "file_stats.h"
+#include "file_verdict_cache.h"
 
 #define DEFAULT_FILE_LOOKUP_TIMEOUT_CACHED_ITEM 3600    // 1 hour
 
@@ -88,16 +91,53 @@ static int64_t time_elapsed_ms(struct timeval* now, struct timeval* expire_time,
     return lookup_timeout * 1000 + timersub_ms(now, expire_time);
 }
 
+static_assert(sizeof(FileHashKey) % sizeof(uint32_t) == 0, "key is hashed by words");
+
 FileCache::FileCache(int64_t max_files_cached)
 {
     max_files = max_files_cached;
-    fileHash = new ExpectedFileCache(max_files, sizeof(FileHashKey), sizeof(FileNode));
-    fileHash->set_max_nodes(max_files);
+
+    while ( num_shards < max_shards and max_files / (num_shards * 2) >= min_files_per_shard )
+        num_shards *= 2;
+
+    shards = new Shard[num_shards];
+    int64_t per_shard = max_files / num_shards;
+
+    for ( unsigned i = 0; i < num_shards; ++i )
+    {
+        Shard& s = shards[i];
+        s.fileHash = new ExpectedFileCache(per_shard, sizeof(FileHashKey), sizeof(FileNode));
+        s.fileHash->set_max_nodes(per_shard);
+    }
 }
 
 FileCache::~FileCache()
 {
-    delete fileHash;
+    for ( unsigned i = 0; i < num_shards; ++i )
+        delete shards[i].fileHash;
+
+    delete[] shards;
+    delete verdict_cache;
+}
+
+FileCache::Shard& FileCache::get_shard(const FileHashKey& hashKey)
+{
+    if ( num_shards == 1 )
+        return shards[0];
+
+    const uint32_t* w = (const uint32_t*)&hashKey;
+    uint64_t h = 0;
+
+    for ( unsigned i = 0; i < sizeof(hashKey) / sizeof(*w); ++i )
+        h = (h ^ w[i]) * 0x9E3779B97F4A7C15ull;
+
+    return shards[(h >> 32) & (num_shards - 1)];
+}
+
+void FileCache::set_verdict_cache(size_t memcap, time_t ttl)
+{
+    delete verdict_cache;
+    verdict_cache = memcap ? new FileVerdictCache(memcap, ttl) : nullptr;
 }
 
 void FileCache::set_block_timeout(int64_t timeout)
@@ -112,8 +152,6 @@ void FileCache::set_lookup_timeout(int64_t timeout)
 
 void FileCache::set_max_files(int64_t max)
 {
-    std::lock_guard<std::mutex> lock(cache_mutex);
-
     int64_t minimal_files = ThreadConfig::get_instance_max() + 1;
     if (max < minimal_files)
     {
@@ -123,11 +161,21 @@ void FileCache::set_max_files(int64_t max)
     }
     else
         max_files = max;
-    fileHash->set_max_nodes(max_files);
+
+    int64_t per_shard = std::max<int64_t>(max_files / num_shards, 1);
+
+    for ( unsigned i = 0; i < num_shards; ++i )
+    {
+        std::lock_guard<std::mutex> lock(shards[i].cache_mutex);
+        shards[i].fileHash->set_max_nodes(per_shard);
+    }
 }
 
+// caller holds the shard lock
 FileContext* FileCache::find_add(const FileHashKey& hashKey, int64_t timeout)
 {
+    ExpectedFileCache* fileHash = get_shard(hashKey).fileHash;
+
     if ( !fileHash->get_num_nodes() )
         return nullptr;
 
@@ -177,13 +225,14 @@ FileContext* FileCache::add(const FileHashKey& hashKey, int64_t timeout, bool &c
     struct timeval time_to_add = { static_cast<time_t>(timeout), 0 };
     timeradd(&now, &time_to_add, &new_node.cache_expire_time);
 
-    std::lock_guard<std::mutex> lock(cache_mutex);
+    Shard& shard = get_shard(hashKey);
+    std::lock_guard<std::mutex> lock(shard.cache_mutex);
     FileContext* file = find_add(hashKey, timeout);
 
     if (!file)
     {
         new_node.file = new FileContext;
-        int ret = fileHash->insert((void*)&hashKey, &new_node);
+        int ret = shard.fileHash->insert((void*)&hashKey, &new_node);
         cache_expire = new_node.cache_expire_time.tv_sec;
 
         if (ret != HASH_OK)
@@ -219,7 +268,9 @@ FileContext* FileCache::add(const FileHashKey& hashKey, int64_t timeout, bool &c
 
 FileContext* FileCache::find(const FileHashKey& hashKey, int64_t timeout, int64_t& cache_expire)
 {
-    std::lock_guard<std::mutex> lock(cache_mutex);
+    Shard& shard = get_shard(hashKey);
+    std::lock_guard<std::mutex> lock(shard.cache_mutex);
+    ExpectedFileCache* fileHash = shard.fileHash;
 
     if ( !fileHash->get_num_nodes() )
         return nullptr;
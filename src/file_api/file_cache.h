@@ -22,6 +22,7 @@
 #define FILE_CACHE_H
 
 #include <atomic>
+#include <ctime>
 #include <mutex>
 
 #include "sfip/sf_ip.h"
@@ -30,6 +31,7 @@
 #include "file_config.h"
 
 class ExpectedFileCache;
+class FileVerdictCache;
 
 PADDING_GUARD_BEGIN
     struct FileHashKey
@@ -60,6 +62,11 @@ public:
     void set_block_timeout(int64_t);
     void set_lookup_timeout(int64_t);
     void set_max_files(int64_t);
+    void set_verdict_cache(size_t memcap, time_t ttl);
+
+    FileVerdictCache* get_verdict_cache()
+    { return verdict_cache; }
+
     snort::FileContext* add(const FileHashKey&, int64_t timeout, bool &cache_full, int64_t& cache_expire, bool cache_sync = false);
     snort::FileContext* get_file(snort::Flow*, uint64_t file_id, bool to_create, bool using_cache_entry);
     FileVerdict cached_verdict_lookup(snort::Packet*, snort::FileInfo*,
@@ -76,12 +83,30 @@ private:
     int store_verdict(snort::Flow*, snort::FileInfo*, int64_t timeout, bool &cache_full, bool is_cacheable);
     void publish_file_cache_event(snort::Flow* flow, snort::FileInfo* file, int64_t timeout);
 
-    /* The hash table of expected files */
-    ExpectedFileCache* fileHash = nullptr;
+    // the expected files are split into shards so packet threads working
+    // on different files don't contend for one lock.  the entries can't be
+    // read lock free since callers update the returned FileContext.
+    struct Shard
+    {
+        /* The hash table of expected files */
+        ExpectedFileCache* fileHash = nullptr;
+        std::mutex cache_mutex;
+    };
+
+    Shard& get_shard(const FileHashKey&);
+
+    static constexpr unsigned max_shards = 16;
+    static constexpr int64_t min_files_per_shard = 1024;
+
+    Shard* shards = nullptr;
+    unsigned num_shards = 1;
+
+    // final signature verdicts by SHA-256, shared across flows
+    FileVerdictCache* verdict_cache = nullptr;
+
     std::atomic<int64_t> block_timeout{DEFAULT_FILE_BLOCK_TIMEOUT};
     std::atomic<int64_t> lookup_timeout{DEFAULT_FILE_LOOKUP_TIMEOUT};
     int64_t max_files = DEFAULT_MAX_FILES_CACHED;
-    std::mutex cache_mutex;
 };
 
 #endif
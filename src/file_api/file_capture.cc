@@ -40,6 +40,7 @@
 #include "utils/stats.h"
 #include "utils/util.h"
 
+#include "file_capture_writer.h"
 #include "file_mempool.h"
 #include "file_stats.h"
 
@@ -50,13 +51,9 @@
 using namespace snort;
 
 FileMemPool* FileCapture::file_mempool = nullptr;
+FileCaptureWriter* FileCapture::writer = nullptr;
 int64_t FileCapture::capture_block_size = 0;
-
-std::mutex FileCapture::capture_mutex;
-std::condition_variable FileCapture::capture_cv;
-std::thread* FileCapture::file_storer = nullptr;
-std::queue<FileCapture*> FileCapture::files_waiting;
-bool FileCapture::running = true;
+size_t FileCapture::block_data_offset = sizeof(FileCaptureBlock);
 
 FileCaptureState FileCapture::error_capture(FileCaptureState state)
 {
@@ -64,32 +61,6 @@ FileCaptureState FileCapture::error_capture(FileCaptureState state)
     return state;
 }
 
-// Only one writer thread supported
-void FileCapture::writer_thread()
-{
-    SET_THREAD_NAME(pthread_self(), "snort3.filecap");
-
-    while (true)
-    {
-        // Wait until there are files
-        std::unique_lock<std::mutex> lk(capture_mutex);
-        capture_cv.wait(lk, [] { return !running or !files_waiting.empty(); });
-
-        // When !running we write out any remaining files before exiting.
-        // FIXIT-L should take dirty_pig into account. But this thread does not have convenient
-        // access to snort_conf.
-        if (files_waiting.empty())
-            break;
-
-        FileCapture* file = files_waiting.front();
-        files_waiting.pop();
-        lk.unlock();
-
-        file->store_file();
-        delete file;
-    }
-}
-
 FileCapture::FileCapture(int64_t min_size, int64_t max_size)
 {
     capture_size = 0;
@@ -136,12 +107,23 @@ FileCapture::~FileCapture()
         delete file_info;
 }
 
-void FileCapture::init(int64_t memcap, int64_t block_size)
+void FileCapture::init(int64_t memcap, int64_t block_size, unsigned writer_threads,
+    unsigned uring_depth, bool direct_io)
 {
+    if (direct_io and (block_size % FileCaptureWriter::direct_io_align))
+    {
+        ErrorMessage("File inspect: capture_block_size must be a multiple of %zu "
+            "for direct I/O, direct I/O disabled\n", FileCaptureWriter::direct_io_align);
+        direct_io = false;
+    }
+
     capture_block_size = block_size;
-    init_mempool(memcap, capture_block_size);
+    init_mempool(memcap, capture_block_size, direct_io);
     file_counts.file_buffers_max = get_buffers_max();
-    file_storer = new std::thread(writer_thread);
+
+    // FIXIT-L should take dirty_pig into account when exiting. But the writer does
+    // not have convenient access to snort_conf.
+    writer = FileCaptureWriter::create(writer_threads, uring_depth, direct_io);
 }
 
 /*
@@ -150,17 +132,12 @@ void FileCapture::init(int64_t memcap, int64_t block_size)
  */
 void FileCapture::exit()
 {
+    if (writer)
     {
-        std::lock_guard<std::mutex> lk(capture_mutex);
-        running = false;
-    }
-    capture_cv.notify_one();
-
-    if (file_storer)
-    {
-        file_storer->join();
-        delete file_storer;
-        file_storer = nullptr;
+        // any queued files are written out first
+        writer->stop();
+        delete writer;
+        writer = nullptr;
     }
 }
 
@@ -171,9 +148,20 @@ void FileCapture::exit()
  *    int64_t max_file_mem: memcap in megabytes
  *    int64_t block_len:  file block size (metadata size excluded)
  */
-void FileCapture::init_mempool(int64_t max_file_mem, int64_t block_len)
+void FileCapture::init_mempool(int64_t max_file_mem, int64_t block_len, bool direct_io)
 {
     int64_t block_size = block_len + sizeof (FileCapture);
+    size_t align = 0;
+
+    // the block header gets a whole page so the data is aligned
+    if (direct_io)
+    {
+        align = FileCaptureWriter::direct_io_align;
+        block_data_offset = align;
+        block_size = block_len + align;
+    }
+    else
+        block_data_offset = sizeof(FileCaptureBlock);
 
     if (block_size <= 0)
         return;
@@ -186,7 +174,7 @@ void FileCapture::init_mempool(int64_t max_file_mem, int64_t block_len)
 
     int max_files = max_file_mem_in_bytes / block_size;
 
-    file_mempool = new FileMemPool(max_files, block_size);
+    file_mempool = new FileMemPool(max_files, block_size, align);
 }
 
 inline FileCaptureBlock* FileCapture::create_file_buffer()
@@ -244,7 +232,7 @@ inline FileCaptureState FileCapture::save_to_file_buffer(const uint8_t* file_dat
         const uint8_t* file_end = file_data + data_size;
 
         /*can't hold all, use current block first*/
-        memcpy((uint8_t*)lastBlock + lastBlock->length + sizeof (*lastBlock),
+        memcpy(get_block_data(lastBlock) + lastBlock->length,
             file_current, available_bytes);
 
         lastBlock->length = capture_block_size;
@@ -268,14 +256,14 @@ inline FileCaptureState FileCapture::save_to_file_buffer(const uint8_t* file_dat
             /*Save data to the new block*/
             if (file_current + capture_block_size < file_end)
             {
-                memcpy((uint8_t*)last + sizeof(*new_block),
+                memcpy(get_block_data(last),
                     file_current,  capture_block_size);
                 new_block->length =  capture_block_size;
                 file_current += capture_block_size;
             }
             else
             {
-                memcpy((uint8_t*)last + sizeof(*new_block),
+                memcpy(get_block_data(last),
                     file_current,  file_end - file_current);
 
                 new_block->length = file_end - file_current;
@@ -285,7 +273,7 @@ inline FileCaptureState FileCapture::save_to_file_buffer(const uint8_t* file_dat
     }
     else
     {
-        memcpy((uint8_t*)lastBlock + lastBlock->length + sizeof(*lastBlock),
+        memcpy(get_block_data(lastBlock) + lastBlock->length,
             file_data, data_size);
 
         lastBlock->length += data_size;
@@ -431,92 +419,27 @@ FileCaptureBlock* FileCapture::get_file_data(uint8_t** buff, int* size)
         return nullptr;
     }
 
-    *buff = (uint8_t*)current_block + sizeof(*current_block);
+    *buff = get_block_data(current_block);
     *size = current_block->length;
 
     current_block = current_block->next;
     return (current_block);
 }
 
-/*
- * writing file data to the disk.
- *
- * In the case of interrupt errors, the write is retried, but only for a
- * finite number of times.
- */
-void FileCapture::write_file_data(uint8_t* buf, size_t buf_len, FILE* fh)
-{
-    int max_retries = 3;
-    size_t bytes_written = 0;
-    int err;
-
-    /* Nothing to write or nothing to write to */
-    if ((buf == nullptr) || (fh == nullptr))
-        return;
-
-    /* writing several times */
-    do
-    {
-        size_t bytes_left = buf_len - bytes_written;
-
-        bytes_written += fwrite(buf + bytes_written, 1, bytes_left, fh);
-
-        err = ferror(fh);
-        if (err && (err != EINTR) && (err != EAGAIN))
-        {
-            break;
-        }
-
-        max_retries--;
-    }
-    while ((max_retries > 0) && (bytes_written < buf_len));
-
-    if (bytes_written < buf_len)
-    {
-        ErrorMessage("File inspect: disk writing error - %s!\n", get_error(err));
-    }
-}
-
 // Store files on local disk
 void FileCapture::store_file()
 {
     if (!file_info)
         return;
 
-    const std::string& file_full_name = file_info->get_file_name();
-
-    FILE* fh = fopen(file_full_name.c_str(), "wx");
-    if (!fh)        
-    {
-        return;
-    }
-    // Check the file buffer
-    uint8_t* buff = nullptr;
-    int size = 0;
-    void* file_mem;
-
-    do
-    {
-        file_mem = get_file_data(&buff, &size);
-        // Get file from file buffer
-        if (!buff || !size )
-        {
-            fclose(fh);
-            return;
-        }
-
-        write_file_data(buff, size, fh);
-    }
-    while (file_mem);
-
-    fclose(fh);
+    FileCaptureWriter::write_file(this);
 }
 
 // Queue files to be stored to disk
 std::string FileCapture::store_file_async()
 {
-    // send data to the writer thread
-    if (!file_info)
+    // send data to the writer
+    if (!file_info or !writer)
         return std::string();
 
     uint8_t* sha = file_info->get_file_sig_sha256();
@@ -529,9 +452,7 @@ std::string FileCapture::store_file_async()
     get_instance_file(file_full_name, file_name.c_str());
     file_info->set_file_name(file_full_name.c_str(), file_full_name.size());
 
-    std::lock_guard<std::mutex> lk(capture_mutex);
-    files_waiting.push(this);
-    capture_cv.notify_one();
+    writer->submit(this);
     return file_full_name;
 }
 
@@ -541,6 +462,8 @@ void FileCapture::print_mem_usage()
     if (file_mempool)
     {
         int64_t block_size = get_block_size() + sizeof (FileCapture);
+        if (block_data_offset > sizeof(FileCaptureBlock))
+            block_size = get_block_size() + block_data_offset;
         if (block_size & 7)
             block_size += (8 - (block_size & 7));
         LogCount("Max file buffer capacity", file_mempool->total_objects());
@@ -549,6 +472,9 @@ void FileCapture::print_mem_usage()
         LogCount("Buffers in release list", file_mempool->released());
         LogCount("Memory usage in bytes", file_mempool->allocated() * block_size);
     }
+
+    if (writer)
+        writer->print_stats();
 }
 
 int64_t FileCapture::get_buffers_max()
@@ -570,6 +496,13 @@ int64_t FileCapture::get_buffers_in_use()
 //--------------------------------------------------------------------------
 
 #ifdef UNIT_TEST
+void FileCapture::term_mempool()
+{
+    delete file_mempool;
+    file_mempool = nullptr;
+    block_data_offset = sizeof(FileCaptureBlock);
+}
+
 TEST_CASE ("Should not segfault when file mempool is not configured", "[file_capture]")
 {
     FileCapture fc(0, 0);
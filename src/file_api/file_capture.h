@@ -31,13 +31,9 @@
 // 3) Then file data can be read through file_capture_read()
 // 4) Finally, file data must be released from mempool file_capture_release()
 
-#include <condition_variable>
-#include <mutex>
-#include <queue>
-#include <thread>
-
 #include "file_api.h"
 
+class FileCaptureWriter;
 class FileMemPool;
 
 namespace snort
@@ -57,7 +53,9 @@ public:
     ~FileCapture();
 
     // this must be called during snort init
-    static void init(int64_t memcap, int64_t block_size);
+    // files are written by writer_threads or by io_uring when uring_depth > 0
+    static void init(int64_t memcap, int64_t block_size, unsigned writer_threads = 1,
+        unsigned uring_depth = 0, bool direct_io = false);
 
     // Capture file data to local buffer
     // This is the main function call to enable file capture
@@ -100,22 +98,25 @@ public:
     void get_file_reset() { current_block = head; }
     void set_data(const uint8_t* file_data, const uint32_t size) {current_data = file_data; current_data_len = size;}
 
+#ifdef UNIT_TEST
+    // undo init so other tests see no mempool
+    static void term_mempool();
+#endif
+
 private:
 
-    static void init_mempool(int64_t max_file_mem, int64_t block_size);
-    static void writer_thread();
+    static void init_mempool(int64_t max_file_mem, int64_t block_size, bool direct_io);
     inline FileCaptureBlock* create_file_buffer();
     inline FileCaptureState save_to_file_buffer(const uint8_t* file_data, int data_size,
         int64_t max_size);
-    void write_file_data(uint8_t* buf, size_t buf_len, FILE* fh);
+
+    static uint8_t* get_block_data(FileCaptureBlock* block)
+    { return (uint8_t*)block + block_data_offset; }
 
     static FileMemPool* file_mempool;
+    static FileCaptureWriter* writer;
     static int64_t capture_block_size;
-    static std::mutex capture_mutex;
-    static std::condition_variable capture_cv;
-    static std::thread* file_storer;
-    static std::queue<FileCapture*> files_waiting;
-    static bool running;
+    static size_t block_data_offset;  // aligned for direct I/O
 
     uint64_t capture_size;
     FileCaptureBlock* last;  /* last block of file data */
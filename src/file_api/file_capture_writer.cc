@@ -0,0 +1,782 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// file_capture_writer.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "file_capture_writer.h"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+#include "log/log_stats.h"
+#include "log/messages.h"
+#include "main/thread.h"
+#include "utils/util.h"
+
+#include "file_capture.h"
+
+#ifdef UNIT_TEST
+#include "catch/snort_catch.h"
+
+#include "file_lib.h"
+#endif
+
+using namespace snort;
+
+static std::atomic<uint64_t> queue_depth(0);
+static std::atomic<uint64_t> queue_max(0);
+static std::atomic<uint64_t> latency_max(0);
+static std::atomic<uint64_t> latency_total(0);
+static std::atomic<uint64_t> files_written(0);
+static std::atomic<uint64_t> bytes_written(0);
+static std::atomic<uint64_t> write_errors(0);
+
+static uint64_t get_usecs()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+static void update_max(std::atomic<uint64_t>& max, uint64_t val)
+{
+    uint64_t cur = max;
+    while ( val > cur and !max.compare_exchange_weak(cur, val) );
+}
+
+//-------------------------------------------------------------------------
+// common
+//-------------------------------------------------------------------------
+
+void FileCaptureWriter::submit(FileCapture* file)
+{
+    {
+        std::lock_guard<std::mutex> lk(queue_mutex);
+        files.push(file);
+    }
+    update_max(queue_max, ++queue_depth);
+    queue_cv.notify_one();
+}
+
+FileCapture* FileCaptureWriter::next(bool wait)
+{
+    std::unique_lock<std::mutex> lk(queue_mutex);
+
+    if ( wait )
+        queue_cv.wait(lk, [this] { return !running or !files.empty(); });
+
+    // when !running write out any remaining files before exiting
+    if ( files.empty() )
+        return nullptr;
+
+    FileCapture* file = files.front();
+    files.pop();
+    return file;
+}
+
+bool FileCaptureWriter::open(FileWrite& fw, bool direct)
+{
+    const std::string& name = fw.file->get_file_info()->get_file_name();
+    int flags = O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC;
+
+    fw.start = get_usecs();
+    fw.direct = false;
+
+    if ( direct )
+    {
+        fw.fd = ::open(name.c_str(), flags | O_DIRECT, 0666);
+
+        // some file systems don't support it
+        if ( fw.fd >= 0 )
+            fw.direct = true;
+
+        else if ( errno == EINVAL )
+            fw.fd = ::open(name.c_str(), flags, 0666);
+    }
+    else
+        fw.fd = ::open(name.c_str(), flags, 0666);
+
+    // an existing file is the same file
+    if ( fw.fd < 0 and errno != EEXIST )
+    {
+        ErrorMessage("File inspect: can't create %s - %s\n", name.c_str(), get_error(errno));
+        ++write_errors;
+    }
+    return fw.fd >= 0;
+}
+
+bool FileCaptureWriter::close_file(FileWrite& fw)
+{
+    if ( fw.fd < 0 )
+        return false;
+
+    uint64_t size = fw.file->get_file_capture_size();
+
+    // drop the padding of the last block
+    if ( !fw.failed and fw.size > size and ftruncate(fw.fd, size) )
+        fw.failed = true;
+
+    if ( fw.failed )
+    {
+        ErrorMessage("File inspect: disk writing error - %s!\n",
+            fw.file->get_file_info()->get_file_name().c_str());
+        ++write_errors;
+    }
+    else
+    {
+        uint64_t usecs = get_usecs() - fw.start;
+        update_max(latency_max, usecs);
+        latency_total += usecs;
+        bytes_written += size;
+        ++files_written;
+    }
+    close(fw.fd);
+    fw.fd = -1;
+
+    return !fw.failed;
+}
+
+void FileCaptureWriter::finish(FileWrite& fw)
+{
+    close_file(fw);
+
+    delete fw.file;
+    fw.file = nullptr;
+    --queue_depth;
+}
+
+uint64_t FileCaptureWriter::get_queue_depth()
+{ return queue_depth; }
+
+uint64_t FileCaptureWriter::get_queue_max()
+{ return queue_max; }
+
+uint64_t FileCaptureWriter::get_latency_max()
+{ return latency_max; }
+
+void FileCaptureWriter::print_stats() const
+{
+    uint64_t files = files_written;
+
+    LogValue("Writer", get_name());
+    LogCount("Files written", files);
+    LogCount("Bytes written", bytes_written);
+    LogCount("Write errors", write_errors);
+    LogCount("Max files queued", queue_max);
+    LogCount("Avg write usecs", files ? latency_total / files : 0);
+    LogCount("Max write usecs", latency_max);
+}
+
+// after a short direct write the rest is unaligned so it goes through the
+// page cache; finish still drops any padding
+bool FileCaptureWriter::end_direct(FileWrite& fw, size_t written)
+{
+    if ( !fw.direct or !(written % direct_io_align) )
+        return true;
+
+    int flags = fcntl(fw.fd, F_GETFL);
+
+    if ( flags < 0 or fcntl(fw.fd, F_SETFL, flags & ~O_DIRECT) < 0 )
+        return false;
+
+    fw.direct = false;
+    return true;
+}
+
+// the next block and its length, padded for direct I/O
+static uint8_t* get_block(FileCapture* file, bool direct, size_t& len, bool& more)
+{
+    uint8_t* buf = nullptr;
+    int size = 0;
+
+    more = file->get_file_data(&buf, &size) != nullptr;
+
+    if ( !buf or size <= 0 )
+        return nullptr;
+
+    len = size;
+
+    // only the last block can be partial and every block has room to pad
+    if ( direct and (len % FileCaptureWriter::direct_io_align) )
+    {
+        size_t pad = FileCaptureWriter::direct_io_align - (len % FileCaptureWriter::direct_io_align);
+        memset(buf + len, 0, pad);
+        len += pad;
+    }
+    return buf;
+}
+
+// the blocks go to the kernel as is, IOV_MAX at a time
+void FileCaptureWriter::write_blocks(FileWrite& fw)
+{
+    struct iovec iov[IOV_MAX];
+    bool more = true;
+
+    fw.file->get_file_reset();
+
+    while ( more )
+    {
+        int n = 0;
+
+        while ( more and n < IOV_MAX )
+        {
+            size_t len;
+            uint8_t* buf = get_block(fw.file, fw.direct, len, more);
+
+            if ( !buf )
+                break;
+
+            iov[n].iov_base = buf;
+            iov[n++].iov_len = len;
+        }
+
+        struct iovec* v = iov;
+
+        while ( n > 0 )
+        {
+            ssize_t sent = pwritev(fw.fd, v, n, fw.size);
+
+            if ( sent < 0 and errno == EINTR )
+                continue;
+
+            if ( sent <= 0 )
+            {
+                fw.failed = true;
+                return;
+            }
+
+            fw.size += sent;
+
+            if ( !end_direct(fw, sent) )
+            {
+                fw.failed = true;
+                return;
+            }
+
+            // skip what was written and resume within a partial block
+            while ( n > 0 and (size_t)sent >= v->iov_len )
+            {
+                sent -= v->iov_len;
+                ++v;
+                --n;
+            }
+            if ( n > 0 )
+            {
+                v->iov_base = (uint8_t*)v->iov_base + sent;
+                v->iov_len -= sent;
+            }
+        }
+    }
+}
+
+bool FileCaptureWriter::write_file(FileCapture* file)
+{
+    FileWrite fw;
+    fw.file = file;
+
+    if ( !open(fw, false) )
+        return false;
+
+    write_blocks(fw);
+    return close_file(fw);
+}
+
+//-------------------------------------------------------------------------
+// threads
+//-------------------------------------------------------------------------
+
+class ThreadWriter : public FileCaptureWriter
+{
+public:
+    ThreadWriter(unsigned threads, bool direct);
+
+    void stop() override;
+
+    const char* get_name() const override
+    { return "threads"; }
+
+private:
+    void run();
+
+    std::vector<std::thread*> threads;
+};
+
+ThreadWriter::ThreadWriter(unsigned n, bool direct) : FileCaptureWriter(direct)
+{
+    for ( unsigned i = 0; i < n; ++i )
+        threads.emplace_back(new std::thread(&ThreadWriter::run, this));
+}
+
+void ThreadWriter::stop()
+{
+    {
+        std::lock_guard<std::mutex> lk(queue_mutex);
+        running = false;
+    }
+    queue_cv.notify_all();
+
+    for ( auto t : threads )
+    {
+        t->join();
+        delete t;
+    }
+    threads.clear();
+}
+
+void ThreadWriter::run()
+{
+    SET_THREAD_NAME(pthread_self(), "snort3.filecap");
+
+    while ( FileCapture* file = next(true) )
+    {
+        FileWrite fw;
+        fw.file = file;
+
+        if ( open(fw, direct_io) )
+            write_blocks(fw);
+
+        finish(fw);
+    }
+}
+
+//-------------------------------------------------------------------------
+// io_uring
+//-------------------------------------------------------------------------
+
+#ifdef HAVE_LIBURING
+
+class UringWriter : public FileCaptureWriter
+{
+public:
+    UringWriter(bool direct) : FileCaptureWriter(direct) { }
+    ~UringWriter() override;
+
+    bool init(unsigned depth);
+    void stop() override;
+
+    const char* get_name() const override
+    { return "io_uring"; }
+
+private:
+    struct Write
+    {
+        FileWrite* fw;
+        uint8_t* buf;
+        size_t len;
+        uint64_t offset;
+    };
+
+    void run();
+    bool start(FileCapture*);
+    void fill();
+    void prep(Write*);
+    void complete(struct io_uring_cqe*);
+
+    struct io_uring ring;
+    std::thread* thread = nullptr;
+
+    // the file whose blocks are being submitted; it may need more
+    // writes than the ring has room for
+    FileWrite* current = nullptr;
+    bool more = false;
+
+    unsigned depth = 0;
+    unsigned in_flight = 0;
+};
+
+UringWriter::~UringWriter()
+{
+    assert(!thread);
+
+    if ( depth )
+        io_uring_queue_exit(&ring);
+}
+
+bool UringWriter::init(unsigned d)
+{
+    int ret = io_uring_queue_init(d, &ring, 0);
+
+    if ( ret < 0 )
+    {
+        // eg the kernel is too old or io_uring is disabled
+        WarningMessage("File inspect: io_uring unavailable - %s, using a writer thread\n",
+            get_error(-ret));
+        return false;
+    }
+    depth = d;
+    thread = new std::thread(&UringWriter::run, this);
+    return true;
+}
+
+void UringWriter::stop()
+{
+    {
+        std::lock_guard<std::mutex> lk(queue_mutex);
+        running = false;
+    }
+    queue_cv.notify_all();
+
+    thread->join();
+    delete thread;
+    thread = nullptr;
+}
+
+void UringWriter::prep(Write* w)
+{
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+    assert(sqe);
+
+    io_uring_prep_write(sqe, w->fw->fd, w->buf, w->len, w->offset);
+    io_uring_sqe_set_data(sqe, w);
+
+    w->fw->pending++;
+    in_flight++;
+}
+
+bool UringWriter::start(FileCapture* file)
+{
+    FileWrite* fw = new FileWrite;
+    fw->file = file;
+
+    if ( !open(*fw, direct_io) )
+    {
+        finish(*fw);
+        delete fw;
+        return false;
+    }
+
+    file->get_file_reset();
+    current = fw;
+    more = true;
+    return true;
+}
+
+// queue block writes until the ring is full
+void UringWriter::fill()
+{
+    while ( in_flight < depth )
+    {
+        if ( !current )
+        {
+            FileCapture* file = next(in_flight == 0);
+
+            if ( !file )
+                return;
+
+            if ( !start(file) )
+                continue;
+        }
+
+        FileWrite* fw = current;
+        size_t len = 0;
+        uint8_t* buf = (more and !fw->failed) ? get_block(fw->file, fw->direct, len, more) : nullptr;
+
+        if ( buf )
+        {
+            prep(new Write { fw, buf, len, fw->size });
+            fw->size += len;
+        }
+
+        if ( !buf or !more )
+        {
+            current = nullptr;
+
+            if ( !fw->pending )
+            {
+                finish(*fw);
+                delete fw;
+            }
+        }
+    }
+}
+
+void UringWriter::complete(struct io_uring_cqe* cqe)
+{
+    Write* w = (Write*)io_uring_cqe_get_data(cqe);
+    FileWrite* fw = w->fw;
+    int res = cqe->res;
+
+    in_flight--;
+    fw->pending--;
+
+    if ( res == -EINTR or res == -EAGAIN or (res > 0 and (size_t)res < w->len and
+        end_direct(*fw, res)) )
+    {
+        // write the rest
+        if ( res > 0 )
+        {
+            w->buf += res;
+            w->len -= res;
+            w->offset += res;
+        }
+        prep(w);
+        return;
+    }
+
+    // nothing written is an error too
+    if ( res <= 0 or (size_t)res < w->len )
+        fw->failed = true;
+
+    delete w;
+
+    if ( !fw->pending and fw != current )
+    {
+        finish(*fw);
+        delete fw;
+    }
+}
+
+void UringWriter::run()
+{
+    SET_THREAD_NAME(pthread_self(), "snort3.filecap");
+
+    while ( true )
+    {
+        fill();
+
+        // stopped and nothing queued
+        if ( !in_flight )
+            break;
+
+        io_uring_submit(&ring);
+
+        struct io_uring_cqe* cqe;
+        int ret = io_uring_wait_cqe(&ring, &cqe);
+
+        if ( ret == -EINTR )
+            continue;
+
+        assert(ret == 0);
+
+        unsigned head;
+        unsigned n = 0;
+
+        io_uring_for_each_cqe(&ring, head, cqe)
+        {
+            complete(cqe);
+            n++;
+        }
+        io_uring_cq_advance(&ring, n);
+    }
+}
+
+#endif
+
+//-------------------------------------------------------------------------
+// factory
+//-------------------------------------------------------------------------
+
+FileCaptureWriter* FileCaptureWriter::create(unsigned threads, unsigned uring_depth, bool direct_io)
+{
+#ifdef HAVE_LIBURING
+    if ( uring_depth )
+    {
+        UringWriter* w = new UringWriter(direct_io);
+
+        if ( w->init(uring_depth) )
+            return w;
+
+        delete w;
+    }
+#else
+    if ( uring_depth )
+        WarningMessage("File inspect: built without io_uring, using writer threads\n");
+#endif
+
+    return new ThreadWriter(threads ? threads : 1, direct_io);
+}
+
+//-------------------------------------------------------------------------
+// unit tests
+//-------------------------------------------------------------------------
+
+#ifdef UNIT_TEST
+
+static constexpr int64_t test_block_size = 2 * FileCaptureWriter::direct_io_align;
+
+// the last piece is copied by reserve_file
+static FileCapture* make_capture(const std::vector<uint8_t>& data, const std::string& name)
+{
+    FileCapture* fc = new FileCapture(0, data.size());
+    size_t off = 0;
+
+    while ( data.size() - off > 3000 )
+    {
+        FilePosition pos = off ? SNORT_FILE_MIDDLE : SNORT_FILE_START;
+        CHECK(fc->process_buffer(data.data() + off, 3000, pos) == FILE_CAPTURE_SUCCESS);
+        off += 3000;
+    }
+    fc->process_buffer(data.data() + off, data.size() - off, off ? SNORT_FILE_END : SNORT_FILE_FULL);
+
+    FileInfo info;
+    info.set_file_size(data.size());
+    CHECK(fc->reserve_file(&info) == FILE_CAPTURE_SUCCESS);
+    fc->get_file_info()->set_file_name(name.c_str(), name.size());
+
+    return fc;
+}
+
+static bool same_file(const std::string& name, const std::vector<uint8_t>& data)
+{
+    FILE* fh = fopen(name.c_str(), "r");
+
+    if ( !fh )
+        return false;
+
+    std::vector<uint8_t> got(data.size() + 1);
+    size_t n = fread(got.data(), 1, got.size(), fh);
+    fclose(fh);
+    unlink(name.c_str());
+
+    return n == data.size() and !memcmp(got.data(), data.data(), n);
+}
+
+static void write_files(FileCaptureWriter* w)
+{
+    char dir[] = "/tmp/filecap_XXXXXX";
+    REQUIRE(mkdtemp(dir));
+
+    std::vector<std::vector<uint8_t>> files;
+    std::vector<std::string> names;
+
+    // partial, exact, and multiple blocks
+    for ( size_t size : { 1UL, 100UL, 4096UL, 8192UL, 8193UL, 50000UL, 100000UL } )
+    {
+        std::vector<uint8_t> data(size);
+
+        for ( size_t i = 0; i < size; ++i )
+            data[i] = (uint8_t)(i * 7 + size);
+
+        names.emplace_back(std::string(dir) + "/" + std::to_string(size));
+        w->submit(make_capture(data, names.back()));
+        files.emplace_back(std::move(data));
+    }
+
+    w->stop();
+    CHECK(FileCaptureWriter::get_queue_depth() == 0);
+
+    for ( unsigned i = 0; i < files.size(); ++i )
+        CHECK(same_file(names[i], files[i]));
+
+    rmdir(dir);
+    delete w;
+}
+
+TEST_CASE("captured files are written", "[file_capture_writer]")
+{
+    // blocks are aligned so both buffered and direct writes can be tested
+    FileCapture::init(4, test_block_size, 1, 0, true);
+    FileCapture::exit();
+
+    SECTION("threads")
+    {
+        write_files(FileCaptureWriter::create(3, 0, false));
+    }
+    SECTION("threads with direct I/O")
+    {
+        write_files(FileCaptureWriter::create(2, 0, true));
+    }
+    SECTION("io_uring")
+    {
+        write_files(FileCaptureWriter::create(1, 4, false));
+    }
+    SECTION("io_uring with direct I/O")
+    {
+        write_files(FileCaptureWriter::create(1, 4, true));
+    }
+    CHECK(FileCaptureWriter::get_queue_max() > 0);
+    CHECK(FileCapture::get_buffers_in_use() == 0);
+
+    FileCapture::term_mempool();
+}
+
+class ShortWriter : public ThreadWriter
+{
+public:
+    ShortWriter() : ThreadWriter(0, true) { }
+
+    using FileCaptureWriter::FileWrite;
+    using FileCaptureWriter::end_direct;
+};
+
+TEST_CASE("short direct writes continue buffered", "[file_capture_writer]")
+{
+    char name[] = "/tmp/filecap_XXXXXX";
+    int fd = mkstemp(name);
+    REQUIRE(fd >= 0);
+
+    ShortWriter::FileWrite fw;
+    fw.fd = fd;
+    fw.direct = true;
+
+    // whole blocks keep direct I/O
+    CHECK(ShortWriter::end_direct(fw, 2 * FileCaptureWriter::direct_io_align));
+    CHECK(fw.direct);
+
+    CHECK(ShortWriter::end_direct(fw, FileCaptureWriter::direct_io_align + 100));
+    CHECK(!fw.direct);
+    CHECK(!(fcntl(fd, F_GETFL) & O_DIRECT));
+
+    close(fd);
+    unlink(name);
+}
+
+TEST_CASE("store_file writes on the calling thread", "[file_capture_writer]")
+{
+    FileCapture::init(4, test_block_size, 1, 0, true);
+    FileCapture::exit();
+
+    char dir[] = "/tmp/filecap_XXXXXX";
+    REQUIRE(mkdtemp(dir));
+
+    std::vector<uint8_t> data(10000);
+
+    for ( size_t i = 0; i < data.size(); ++i )
+        data[i] = (uint8_t)(i * 3);
+
+    std::string name = std::string(dir) + "/sync";
+    FileCapture* fc = make_capture(data, name);
+
+    fc->store_file();
+    CHECK(same_file(name, data));
+
+    delete fc;
+    rmdir(dir);
+
+    CHECK(FileCapture::get_buffers_in_use() == 0);
+    FileCapture::term_mempool();
+}
+
+#endif
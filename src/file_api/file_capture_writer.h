@@ -0,0 +1,117 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// file_capture_writer.h
+
+#ifndef FILE_CAPTURE_WRITER_H
+#define FILE_CAPTURE_WRITER_H
+
+// writes captured files to disk straight from their mempool blocks.
+//
+// packet threads queue a FileCapture with submit() and move on.  the
+// writer owns it from then on and deletes it, releasing its blocks, once
+// the file is on disk.  there are two implementations:
+//
+// - io_uring: one thread keeps up to depth block writes in flight across
+//   all queued files.  only available when built with liburing and when
+//   the kernel allows a ring to be set up.
+// - threads: each thread writes one file at a time with pwritev, all the
+//   blocks of the file in one call.
+//
+// with direct I/O the files are opened O_DIRECT.  blocks are then aligned
+// by FileCapture, the last block is written padded and the file is
+// truncated to its real size afterwards.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+
+namespace snort
+{
+class FileCapture;
+}
+
+class FileCaptureWriter
+{
+public:
+    // alignment of buffers, lengths, and offsets for direct I/O
+    static constexpr size_t direct_io_align = 4096;
+
+    // uses io_uring if uring_depth > 0 and it is available, else threads
+    static FileCaptureWriter* create(unsigned threads, unsigned uring_depth, bool direct_io);
+
+    virtual ~FileCaptureWriter() = default;
+
+    // takes ownership of the file
+    void submit(snort::FileCapture*);
+
+    // writes the file through the page cache on the calling thread,
+    // the caller keeps the file
+    static bool write_file(snort::FileCapture*);
+
+    // write out any queued files and stop
+    virtual void stop() = 0;
+
+    virtual const char* get_name() const = 0;
+
+    // files waiting to be written or being written
+    static uint64_t get_queue_depth();
+    static uint64_t get_queue_max();
+
+    // usecs to write one file, open to close
+    static uint64_t get_latency_max();
+
+    void print_stats() const;
+
+protected:
+    struct FileWrite
+    {
+        snort::FileCapture* file;
+        uint64_t start;         // usecs
+        uint64_t size = 0;      // bytes submitted
+        int fd = -1;
+        unsigned pending = 0;   // writes in flight
+        bool direct = false;
+        bool failed = false;
+    };
+
+    FileCaptureWriter(bool d) : direct_io(d) { }
+
+    // nullptr once stopped and the queue is empty
+    snort::FileCapture* next(bool wait);
+
+    static bool open(FileWrite&, bool direct);
+    static bool close_file(FileWrite&);
+    void finish(FileWrite&);
+
+    // writes all blocks with pwritev
+    static void write_blocks(FileWrite&);
+
+    // false if a short direct write can't continue
+    static bool end_direct(FileWrite&, size_t written);
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::queue<snort::FileCapture*> files;
+    bool running = true;
+    bool direct_io;
+};
+
+#endif
@@ -38,6 +38,8 @@
 #define DEFAULT_FILE_CAPTURE_BLOCK_SIZE     32768       // 32 KiB
 #define DEFAULT_MAX_FILES_CACHED            65536
 #define DEFAULT_MAX_FILES_PER_FLOW          128
+#define DEFAULT_FILE_SIGNATURE_MEM          64          // 64 MiB
+#define DEFAULT_FILE_VERDICT_CACHE_TTL      3600        // 1 hour
 
 #define FILE_ID_NAME "file_inspect"
 #define FILE_ID_HELP "configure file inspection"
@@ -61,9 +63,16 @@ public:
     int64_t capture_max_size = DEFAULT_FILE_CAPTURE_MAX_SIZE;
     int64_t capture_min_size = DEFAULT_FILE_CAPTURE_MIN_SIZE;
     int64_t capture_block_size = DEFAULT_FILE_CAPTURE_BLOCK_SIZE;
+    unsigned capture_writer_threads = 1;
+    unsigned capture_io_uring_depth = 0;
+    bool capture_direct_io = false;
     int64_t file_depth =  0;
     int64_t max_files_cached = DEFAULT_MAX_FILES_CACHED;
     uint64_t max_files_per_flow = DEFAULT_MAX_FILES_PER_FLOW;
+    unsigned signature_threads = 0;
+    int64_t signature_memcap = DEFAULT_FILE_SIGNATURE_MEM;
+    int64_t verdict_cache_memcap = 0;
+    int64_t verdict_cache_ttl = DEFAULT_FILE_VERDICT_CACHE_TTL;
 
     int64_t show_data_depth = DEFAULT_FILE_SHOW_DATA_DEPTH;
     bool trace_type = false;
@@ -0,0 +1,417 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// file_hasher.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "file_hasher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <queue>
+
+#include "utils/util.h"
+
+#include "file_stats.h"
+
+#ifdef UNIT_TEST
+#include "catch/snort_catch.h"
+#endif
+
+std::vector<std::thread*> FileHasher::helpers;
+
+static std::mutex run_mutex;
+static std::condition_variable run_cv;
+static std::queue<FileHashJob*> run_queue;
+static bool running = false;
+
+static std::atomic<uint64_t> queue_depth(0);
+static std::atomic<uint64_t> queue_max(0);
+
+static size_t memcap = 0;
+static std::atomic<size_t> memory(0);
+
+//-------------------------------------------------------------------------
+// job
+//-------------------------------------------------------------------------
+
+FileHashJob::FileHashJob()
+{ ctx = EVP_MD_CTX_new(); }
+
+FileHashJob::~FileHashJob()
+{
+    FileHasher::release(incoming.capacity() + working.capacity());
+    EVP_MD_CTX_free(ctx);
+}
+
+void FileHashJob::update(const uint8_t* data, size_t len)
+{
+    std::unique_lock<std::mutex> lk(mutex);
+
+    if ( incoming.size() >= max_pending )
+    {
+        file_counts.signature_waits++;
+        cv.wait(lk, [this] { return incoming.size() < max_pending; });
+    }
+
+    size_t size = incoming.size() + len;
+
+    if ( size > incoming.capacity() )
+    {
+        // grow as insert would but charge it first
+        size_t cap = std::max(size, 2 * incoming.capacity());
+
+        if ( !FileHasher::charge(cap - incoming.capacity()) )
+        {
+            // at the memcap, hash it here once the helper is done with the rest
+            if ( queued )
+            {
+                file_counts.signature_waits++;
+                cv.wait(lk, [this] { return !queued; });
+            }
+            EVP_DigestUpdate(ctx, data, len);
+            file_counts.signature_bytes_inline += len;
+            return;
+        }
+        incoming.reserve(cap);
+    }
+
+    incoming.insert(incoming.end(), data, data + len);
+    file_counts.signature_bytes_offloaded += len;
+
+    if ( queued )
+        return;
+
+    queued = true;
+    lk.unlock();
+
+    FileHasher::schedule(this);
+}
+
+EVP_MD_CTX* FileHashJob::sync()
+{
+    std::unique_lock<std::mutex> lk(mutex);
+
+    if ( queued )
+    {
+        file_counts.signature_waits++;
+        cv.wait(lk, [this] { return !queued; });
+    }
+    return ctx;
+}
+
+void FileHashJob::release()
+{
+    {
+        std::lock_guard<std::mutex> lk(mutex);
+
+        if ( queued )
+        {
+            released = true;
+            return;
+        }
+    }
+    delete this;
+}
+
+// hash what has been appended so far; the packet thread keeps appending
+// to the other buffer meanwhile
+bool FileHashJob::run()
+{
+    {
+        std::lock_guard<std::mutex> lk(mutex);
+
+        if ( incoming.empty() )
+            return false;
+
+        incoming.swap(working);
+    }
+    cv.notify_all();
+
+    EVP_DigestUpdate(ctx, working.data(), working.size());
+    working.clear();
+
+    return true;
+}
+
+void FileHashJob::trim()
+{
+    size_t freed = 0;
+
+    for ( auto* buf : { &incoming, &working } )
+    {
+        if ( buf->capacity() > max_idle )
+        {
+            assert(buf->empty());
+            freed += buf->capacity();
+            std::vector<uint8_t>().swap(*buf);
+        }
+    }
+    FileHasher::release(freed);
+}
+
+//-------------------------------------------------------------------------
+// helpers
+//-------------------------------------------------------------------------
+
+void FileHasher::helper()
+{
+    SET_THREAD_NAME(pthread_self(), "snort3.filesig");
+
+    while ( true )
+    {
+        std::unique_lock<std::mutex> lk(run_mutex);
+        run_cv.wait(lk, [] { return !running or !run_queue.empty(); });
+
+        // when !running finish any queued jobs before exiting
+        if ( run_queue.empty() )
+            break;
+
+        FileHashJob* job = run_queue.front();
+        run_queue.pop();
+        queue_depth--;
+        lk.unlock();
+
+        while ( job->run() );
+
+        bool released;
+        {
+            std::lock_guard<std::mutex> jlk(job->mutex);
+
+            // update may have appended since the last run
+            if ( !job->incoming.empty() )
+            {
+                schedule(job);
+                continue;
+            }
+            job->trim();
+            job->queued = false;
+            released = job->released;
+
+            // the owner may delete the job as soon as the lock is released
+            if ( !released )
+                job->cv.notify_all();
+        }
+
+        if ( released )
+            delete job;
+    }
+}
+
+void FileHasher::schedule(FileHashJob* job)
+{
+    {
+        std::lock_guard<std::mutex> lk(run_mutex);
+        run_queue.push(job);
+    }
+    uint64_t depth = ++queue_depth;
+    uint64_t max = queue_max;
+
+    while ( depth > max and !queue_max.compare_exchange_weak(max, depth) );
+
+    run_cv.notify_one();
+}
+
+bool FileHasher::charge(size_t n)
+{
+    size_t used = memory;
+
+    do
+    {
+        if ( used + n > memcap )
+            return false;
+    }
+    while ( !memory.compare_exchange_weak(used, used + n) );
+
+    return true;
+}
+
+void FileHasher::release(size_t n)
+{
+    assert(memory >= n);
+    memory -= n;
+}
+
+void FileHasher::init(unsigned threads, size_t cap)
+{
+    assert(helpers.empty());
+    running = true;
+    memcap = cap;
+
+    for ( unsigned i = 0; i < threads; ++i )
+        helpers.emplace_back(new std::thread(helper));
+}
+
+// packet threads have exited so no more work can arrive
+void FileHasher::term()
+{
+    {
+        std::lock_guard<std::mutex> lk(run_mutex);
+        running = false;
+    }
+    run_cv.notify_all();
+
+    for ( auto t : helpers )
+    {
+        t->join();
+        delete t;
+    }
+    helpers.clear();
+}
+
+uint64_t FileHasher::get_queue_depth()
+{ return queue_depth; }
+
+uint64_t FileHasher::get_queue_max()
+{ return queue_max; }
+
+uint64_t FileHasher::get_memory()
+{ return memory; }
+
+//-------------------------------------------------------------------------
+// unit tests
+//-------------------------------------------------------------------------
+
+#ifdef UNIT_TEST
+
+static void digest(EVP_MD_CTX* ctx, uint8_t* out)
+{
+    unsigned len = 0;
+    EVP_DigestFinal_ex(ctx, out, &len);
+}
+
+static std::vector<uint8_t> test_data(uint8_t* expected)
+{
+    std::vector<uint8_t> data(3 * FileHashJob::max_pending);
+
+    for ( size_t i = 0; i < data.size(); ++i )
+        data[i] = (uint8_t)(i * 31 + (i >> 13));
+
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr);
+    EVP_DigestUpdate(ctx, data.data(), data.size());
+    digest(ctx, expected);
+    EVP_MD_CTX_free(ctx);
+
+    return data;
+}
+
+// interleave segments of odd sizes across files
+static void test_hash(std::vector<FileHashJob*>& jobs, const std::vector<uint8_t>& data,
+    const uint8_t* expected)
+{
+    for ( size_t off = 0; off < data.size(); )
+    {
+        size_t len = std::min<size_t>(1460 + off % 7000, data.size() - off);
+
+        for ( auto job : jobs )
+            job->update(data.data() + off, len);
+
+        off += len;
+    }
+
+    for ( auto job : jobs )
+    {
+        uint8_t sha[32];
+        digest(job->sync(), sha);
+        CHECK(!memcmp(sha, expected, sizeof(sha)));
+    }
+
+    // all hashed, so only small buffers are left
+    CHECK(FileHasher::get_memory() <= jobs.size() * 2 * FileHashJob::max_idle);
+
+    for ( auto job : jobs )
+        job->release();
+
+    jobs.clear();
+}
+
+TEST_CASE("helpers match inline hashing", "[file_hasher]")
+{
+    uint8_t expected[32];
+    std::vector<uint8_t> data = test_data(expected);
+
+    FileHasher::init(3, 64 * 1024 * 1024);
+    CHECK(FileHasher::enabled());
+
+    std::vector<FileHashJob*> jobs;
+
+    for ( unsigned i = 0; i < 8; ++i )
+    {
+        jobs.emplace_back(new FileHashJob);
+        EVP_DigestInit_ex(jobs.back()->sync(), EVP_sha256(), nullptr);
+    }
+
+    test_hash(jobs, data, expected);
+    CHECK(FileHasher::get_memory() == 0);
+
+    // released while busy
+    FileHashJob* job = new FileHashJob;
+    EVP_DigestInit_ex(job->sync(), EVP_sha256(), nullptr);
+    job->update(data.data(), data.size());
+    job->release();
+
+    FileHasher::term();
+    CHECK(!FileHasher::enabled());
+    CHECK(FileHasher::get_queue_max() > 0);
+    CHECK(FileHasher::get_memory() == 0);
+}
+
+TEST_CASE("memcap falls back to inline hashing", "[file_hasher]")
+{
+    uint8_t expected[32];
+    std::vector<uint8_t> data = test_data(expected);
+    std::vector<FileHashJob*> jobs;
+
+    file_counts.signature_bytes_inline = 0;
+
+    SECTION("none offloaded")
+    {
+        FileHasher::init(2, 0);
+
+        for ( unsigned i = 0; i < 2; ++i )
+        {
+            jobs.emplace_back(new FileHashJob);
+            EVP_DigestInit_ex(jobs.back()->sync(), EVP_sha256(), nullptr);
+        }
+        test_hash(jobs, data, expected);
+        CHECK(file_counts.signature_bytes_inline == 2 * data.size());
+    }
+    SECTION("some offloaded")
+    {
+        FileHasher::init(2, 1024 * 1024);
+
+        for ( unsigned i = 0; i < 8; ++i )
+        {
+            jobs.emplace_back(new FileHashJob);
+            EVP_DigestInit_ex(jobs.back()->sync(), EVP_sha256(), nullptr);
+        }
+        test_hash(jobs, data, expected);
+        CHECK(file_counts.signature_bytes_inline > 0);
+        CHECK(file_counts.signature_bytes_inline < 8 * data.size());
+    }
+    CHECK(FileHasher::get_memory() == 0);
+    FileHasher::term();
+}
+
+#endif
+
@@ -0,0 +1,113 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// file_hasher.h
+
+#ifndef FILE_HASHER_H
+#define FILE_HASHER_H
+
+// computes file SHA-256 signatures on helper threads so packet threads
+// don't spend their time hashing large files.
+//
+// a packet thread appends each file segment to the file's FileHashJob and
+// moves on.  a job is on at most one helper at a time so its segments are
+// hashed in order while different files are hashed concurrently.  the
+// packet thread only waits for a job at file end, when a partial signature
+// is flushed, or when the job falls more than max_pending bytes behind.
+// the buffers of all jobs count against a memcap; past it, segments are
+// hashed on the packet thread.
+// OpenSSL selects the SHA-256 implementation for the cpu (SHA-NI, AVX2).
+
+#include <openssl/evp.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class FileHashJob
+{
+public:
+    FileHashJob();
+
+    // hash data, maybe later
+    void update(const uint8_t*, size_t);
+
+    // wait until all data is hashed; the context can then be used directly
+    // until the next update
+    EVP_MD_CTX* sync();
+
+    // called by the owner instead of delete
+    void release();
+
+    static constexpr size_t max_pending = 4 * 1024 * 1024;
+    static constexpr size_t max_idle = 64 * 1024;   // buffer kept when idle
+
+private:
+    friend class FileHasher;
+    ~FileHashJob();
+
+    // helper thread; true if there was data
+    bool run();
+
+    // helper thread with mutex held; free large buffers once all is hashed
+    void trim();
+
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    std::vector<uint8_t> incoming;  // appended by the packet thread
+    std::vector<uint8_t> working;   // hashed by the helper
+
+    EVP_MD_CTX* ctx;
+    bool queued = false;            // on a helper or waiting for one
+    bool released = false;
+};
+
+class FileHasher
+{
+public:
+    // 0 threads keeps hashing on the packet threads
+    // memcap is the total buffer bytes of all jobs
+    static void init(unsigned threads, size_t memcap);
+    static void term();
+
+    static bool enabled()
+    { return !helpers.empty(); }
+
+    // files waiting for a helper
+    static uint64_t get_queue_depth();
+    static uint64_t get_queue_max();
+
+    // buffer bytes held by jobs
+    static uint64_t get_memory();
+
+private:
+    friend class FileHashJob;
+
+    static bool charge(size_t);
+    static void release(size_t);
+
+    static void schedule(FileHashJob*);
+    static void helper();
+
+    static std::vector<std::thread*> helpers;
+};
+
+#endif
@@ -93,7 +93,13 @@ static void file_config_show(const FileConfig* fc)
         ConfigLogger::log_value("type_depth", fc->file_type_depth);
 
     if ( ConfigLogger::log_flag("enable_signature", FileService::is_file_signature_enabled()) )
+    {
         ConfigLogger::log_value("signature_depth", fc->file_signature_depth);
+        ConfigLogger::log_value("signature_threads", fc->signature_threads);
+        ConfigLogger::log_value("signature_memcap", fc->signature_memcap);
+        ConfigLogger::log_value("verdict_cache_memcap", fc->verdict_cache_memcap);
+        ConfigLogger::log_value("verdict_cache_ttl", fc->verdict_cache_ttl);
+    }
 
     if ( ConfigLogger::log_flag("block_timeout_lookup", fc->block_timeout_lookup) )
         ConfigLogger::log_value("block_timeout", fc->file_block_timeout);
@@ -104,6 +110,9 @@ static void file_config_show(const FileConfig* fc)
         ConfigLogger::log_value("capture_max_size", fc->capture_max_size);
         ConfigLogger::log_value("capture_min_size", fc->capture_min_size);
         ConfigLogger::log_value("capture_block_size", fc->capture_block_size);
+        ConfigLogger::log_value("capture_writer_threads", fc->capture_writer_threads);
+        ConfigLogger::log_value("capture_io_uring_depth", fc->capture_io_uring_depth);
+        ConfigLogger::log_flag("capture_direct_io", fc->capture_direct_io);
     }
 
     ConfigLogger::log_value("lookup_timeout", fc->file_lookup_timeout);
@@ -56,11 +56,13 @@
 #include "file_capture.h"
 #include "file_config.h"
 #include "file_flows.h"
+#include "file_hasher.h"
 #include "file_inspect.h"
 #include "file_module.h"
 #include "file_segment.h"
 #include "file_service.h"
 #include "file_stats.h"
+#include "file_verdict_cache.h"
 
 using namespace snort;
 
@@ -520,6 +522,9 @@ FileContext::~FileContext ()
     if (file_signature_context)
         EVP_MD_CTX_free((EVP_MD_CTX*)file_signature_context);
 
+    if (signature_job)
+        signature_job->release();
+
     if (file_capture)
         stop_file_capture();
 
@@ -635,13 +640,40 @@ FileVerdict FileContext::file_signature_lookup(Packet* p)
     return FILE_VERDICT_UNKNOWN;
 }
 
+// the policy may capture the file as part of the lookup so the cache is
+// only used when no policy captures files
+FileVerdict FileContext::cached_signature_lookup(Packet* p, FilePolicyBase* policy)
+{
+    FileCache* file_cache = FileService::get_file_cache();
+    FileVerdictCache* cache = file_cache ? file_cache->get_verdict_cache() : nullptr;
+
+    if ( !cache or FileService::is_file_capture_enabled() )
+        return policy->signature_lookup(p, this);
+
+    FileVerdict v;
+    time_t now = packet_time();
+    uint32_t generation = policy->get_generation();
+
+    if ( cache->find(sha256, policy_id, generation, now, v) )
+    {
+        file_counts.verdict_cache_hits++;
+        return v;
+    }
+
+    file_counts.verdict_cache_misses++;
+    v = policy->signature_lookup(p, this);
+    cache->add(sha256, policy_id, generation, v, now);
+
+    return v;
+}
+
 void FileContext::finish_signature_lookup(Packet* p, bool final_lookup, FilePolicyBase* policy)
 {
     Flow* flow = p->flow;
 
     if (get_file_sig_sha256())
     {
-        verdict = policy->signature_lookup(p, this);
+        verdict = cached_signature_lookup(p, policy);
         FILE_DEBUG(file_trace, DEFAULT_TRACE_OPTION_ID, TRACE_DEBUG_LEVEL,
             p, "finish signature lookup verdict %d\n", verdict);
         if ( verdict != FILE_VERDICT_UNKNOWN || final_lookup )
@@ -981,6 +1013,24 @@ void FileContext::process_file_type(Packet* pkt,const uint8_t* file_data, int da
         find_file_type_from_ips(pkt, file_data, data_size, position);
 }
 
+// with signature threads the digest context of a multi segment file is
+// owned by signature_job and may only be used here once the job is synced
+void* FileContext::sync_signature()
+{
+    if (signature_job)
+        return signature_job->sync();
+
+    return file_signature_context;
+}
+
+void FileContext::update_signature(const uint8_t* file_data, int data_size)
+{
+    if (signature_job)
+        signature_job->update(file_data, data_size);
+    else
+        EVP_DigestUpdate((EVP_MD_CTX*)file_signature_context, file_data, data_size);
+}
+
 void FileContext::process_file_signature_sha256(const uint8_t* file_data, int data_size,
     FilePosition position)
 {
@@ -998,18 +1048,21 @@ void FileContext::process_file_signature_sha256(const uint8_t* file_data, int da
     {
     case SNORT_FILE_START:
     {
-        if (!file_signature_context)
+        if (FileHasher::enabled() and !signature_job)
+            signature_job = new FileHashJob;
+        else if (!file_signature_context and !signature_job)
             file_signature_context = EVP_MD_CTX_new();
 
-        EVP_MD_CTX* ctx = (EVP_MD_CTX*)file_signature_context;
+        EVP_MD_CTX* ctx = (EVP_MD_CTX*)sync_signature();
         EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr);
-        EVP_DigestUpdate(ctx, file_data, data_size);
+        update_signature(file_data, data_size);
         FILE_DEBUG(file_trace, DEFAULT_TRACE_OPTION_ID, TRACE_DEBUG_LEVEL, GET_CURRENT_PACKET,
             "position is start of file\n");
         if (file_state.sig_state == FILE_SIG_FLUSH)
         {
             if (!sha256)
                 sha256 = (uint8_t*)snort_alloc(SHA256_HASH_SIZE);
+            ctx = (EVP_MD_CTX*)sync_signature();
             EVP_MD_CTX* tmp = EVP_MD_CTX_new();
             if (tmp && EVP_MD_CTX_copy_ex(tmp, ctx) == 1)
             {
@@ -1024,16 +1077,16 @@ void FileContext::process_file_signature_sha256(const uint8_t* file_data, int da
 
     case SNORT_FILE_MIDDLE:
     {
-        if (!file_signature_context)
+        if (!file_signature_context and !signature_job)
             return;
-        EVP_MD_CTX* ctx = (EVP_MD_CTX*)file_signature_context;
-        EVP_DigestUpdate(ctx, file_data, data_size);
+        update_signature(file_data, data_size);
         FILE_DEBUG(file_trace, DEFAULT_TRACE_OPTION_ID, TRACE_DEBUG_LEVEL, GET_CURRENT_PACKET,
             "position is middle of the file\n");
         if (file_state.sig_state == FILE_SIG_FLUSH)
         {
             if (!sha256)
                 sha256 = (uint8_t*)snort_alloc(SHA256_HASH_SIZE);
+            EVP_MD_CTX* ctx = (EVP_MD_CTX*)sync_signature();
             EVP_MD_CTX* tmp = EVP_MD_CTX_new();
             if (tmp && EVP_MD_CTX_copy_ex(tmp, ctx) == 1)
             {
@@ -1048,9 +1101,9 @@ void FileContext::process_file_signature_sha256(const uint8_t* file_data, int da
 
     case SNORT_FILE_END:
     {
-        if (!file_signature_context)
+        if (!file_signature_context and !signature_job)
             return;
-        EVP_MD_CTX* ctx = (EVP_MD_CTX*)file_signature_context;
+        EVP_MD_CTX* ctx = (EVP_MD_CTX*)sync_signature();
         EVP_DigestUpdate(ctx, file_data, data_size);
         sha256 = new uint8_t[SHA256_HASH_SIZE];
         unsigned int out_len = 0;
@@ -39,6 +39,7 @@ const std::string VerdictName[] =
 {"Unknown", "Log", "Stop", "Block", "Reset", "Pending", "Stop Capture", "INVALID"};
 
 class FileConfig;
+class FileHashJob;
 class FileInspect;
 class FileSegments;
 
@@ -213,6 +214,7 @@ private:
     uint64_t processed_bytes = 0;
     void* file_type_context;
     void* file_signature_context;
+    FileHashJob* signature_job = nullptr;
     FileSegments* file_segments;
     FileInspect* inspector;
     FileConfig*  config;
@@ -224,6 +226,9 @@ private:
     bool force_adv_log = false;
 
     void finalize_file_type();
+    void* sync_signature();
+    void update_signature(const uint8_t* file_data, int data_size);
+    FileVerdict cached_signature_lookup(Packet*, FilePolicyBase*);
     void finish_signature_lookup(Packet*, bool, FilePolicyBase*);
     void find_file_type_from_ips(Packet*, const uint8_t *file_data, int data_size, FilePosition);
     void process_file_type(Packet*, const uint8_t* file_data, int data_size, FilePosition);
@@ -31,6 +31,10 @@
 
 #include "file_mempool.h"
 
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
 #include "log/messages.h"
 #include "utils/util.h"
 
@@ -46,7 +50,10 @@ void FileMemPool::free_pools()
 {
     if (datapool != nullptr)
     {
-        snort_free(datapool);
+        if (align)
+            free(datapool);
+        else
+            snort_free(datapool);
         datapool = nullptr;
     }
 
@@ -61,7 +68,7 @@ void FileMemPool::free_pools()
  *   obj_size    - size of the items
  */
 
-FileMemPool::FileMemPool(uint64_t num_objects, size_t o_size)
+FileMemPool::FileMemPool(uint64_t num_objects, size_t o_size, size_t a)
 {
     unsigned int i;
 
@@ -69,9 +76,22 @@ FileMemPool::FileMemPool(uint64_t num_objects, size_t o_size)
         return;
 
     obj_size = o_size;
+    align = a;
 
     // this is the basis pool that represents all the *data pointers in the list
-    datapool = (void**)snort_calloc(num_objects, obj_size);
+    if ( align )
+    {
+        assert(!(obj_size % align));
+        void* pool = nullptr;
+
+        if ( posix_memalign(&pool, align, num_objects * obj_size) )
+            return;
+
+        memset(pool, 0, num_objects * obj_size);
+        datapool = (void**)pool;
+    }
+    else
+        datapool = (void**)snort_calloc(num_objects, obj_size);
 
     /* sets up the memory list */
     free_list = cbuffer_init(num_objects);
@@ -39,7 +39,8 @@ class FileMemPool
 {
 public:
 
-    FileMemPool(uint64_t num_objects, size_t obj_size);
+    // objects are aligned to align bytes when given, eg for direct I/O
+    FileMemPool(uint64_t num_objects, size_t obj_size, size_t align = 0);
     ~FileMemPool();
 
     // Allocate a new object from the FileMemPool
@@ -73,6 +74,7 @@ private:
     int remove(CircularBuffer* cb, void* obj);
 
     void** datapool = nullptr; /* memory buffer */
+    size_t align = 0;          /* datapool is from posix_memalign if set */
     uint64_t total = 0;
     CircularBuffer* free_list = nullptr;
     CircularBuffer* released_list = nullptr;
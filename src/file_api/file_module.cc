@@ -75,6 +75,15 @@ static const Parameter file_id_params[] =
     { "capture_block_size", Parameter::PT_INT, "8:max53", "32768",
       "file capture block size in bytes" },
 
+    { "capture_writer_threads", Parameter::PT_INT, "1:64", "1",
+      "number of threads writing captured files when io_uring isn't used" },
+
+    { "capture_io_uring_depth", Parameter::PT_INT, "0:4096", "0",
+      "captured file block writes in flight with io_uring; 0 uses writer threads" },
+
+    { "capture_direct_io", Parameter::PT_BOOL, nullptr, "false",
+      "write captured files with O_DIRECT; capture_block_size must be a multiple of 4096" },
+
     { "max_files_cached", Parameter::PT_INT, "8:max53", "65536",
       "maximal number of files cached in memory" },
 
@@ -99,6 +108,18 @@ static const Parameter file_id_params[] =
     { "decompress_buffer_size", Parameter::PT_INT, "1024:max31", "100000",
       "file decompression buffer size" },
 
+    { "signature_threads", Parameter::PT_INT, "0:64", "0",
+      "number of threads computing file signatures; 0 computes them on packet threads" },
+
+    { "signature_memcap", Parameter::PT_INT, "0:max32", "64",
+      "memcap for file data waiting for signature threads in megabytes" },
+
+    { "verdict_cache_memcap", Parameter::PT_INT, "0:max32", "0",
+      "memcap for signature verdicts cached by SHA-256 in megabytes; 0 disables" },
+
+    { "verdict_cache_ttl", Parameter::PT_INT, "1:max31", "3600",
+      "seconds a cached signature verdict is used" },
+
     { nullptr, Parameter::PT_MAX, nullptr, nullptr, nullptr }
 };
 
@@ -111,6 +132,16 @@ static const PegInfo file_pegs[] =
     { CountType::MAX, "max_concurrent_files", "maximum files processed concurrently on a flow" },
     { CountType::MAX, "buffers_max", "maximum number of file buffers that can be allocated" },
     { CountType::NOW, "buffers_in_use", "number of file buffers currently in use" },
+    { CountType::SUM, "signature_bytes_offloaded", "number of file bytes hashed by signature threads" },
+    { CountType::SUM, "signature_waits", "number of times a packet thread waited for a signature thread" },
+    { CountType::SUM, "signature_bytes_inline", "number of file bytes hashed on packet threads at the signature memcap" },
+    { CountType::NOW, "signature_queue_depth", "number of files waiting for a signature thread" },
+    { CountType::MAX, "signature_queue_max", "maximum number of files waiting for a signature thread" },
+    { CountType::SUM, "verdict_cache_hits", "number of signature verdicts found in the verdict cache" },
+    { CountType::SUM, "verdict_cache_misses", "number of signature lookups not found in the verdict cache" },
+    { CountType::NOW, "capture_queue_depth", "number of captured files waiting to be written or being written" },
+    { CountType::MAX, "capture_queue_max", "maximum number of captured files waiting to be written" },
+    { CountType::MAX, "capture_write_usecs_max", "maximum time to write a captured file in microseconds" },
     { CountType::END, nullptr, nullptr }
 };
 
@@ -193,6 +224,15 @@ bool FileIdModule::set(const char*, Value& v, SnortConfig*)
     else if ( v.is("capture_block_size") )
         fc->capture_block_size = v.get_int64();
 
+    else if ( v.is("capture_writer_threads") )
+        fc->capture_writer_threads = v.get_uint32();
+
+    else if ( v.is("capture_io_uring_depth") )
+        fc->capture_io_uring_depth = v.get_uint32();
+
+    else if ( v.is("capture_direct_io") )
+        fc->capture_direct_io = v.get_bool();
+
     else if ( v.is("max_files_cached") )
         fc->max_files_cached = v.get_int64();
 
@@ -214,6 +254,18 @@ bool FileIdModule::set(const char*, Value& v, SnortConfig*)
     else if ( v.is("decompress_buffer_size") )
         FileService::decode_conf.set_decompress_buffer_size(v.get_uint32());
 
+    else if ( v.is("signature_threads") )
+        fc->signature_threads = v.get_uint32();
+
+    else if ( v.is("signature_memcap") )
+        fc->signature_memcap = v.get_int64();
+
+    else if ( v.is("verdict_cache_memcap") )
+        fc->verdict_cache_memcap = v.get_int64();
+
+    else if ( v.is("verdict_cache_ttl") )
+        fc->verdict_cache_ttl = v.get_int64();
+
     else if ( v.is("rules_file") )
     {
         magic_file = "include ";
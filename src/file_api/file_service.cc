@@ -38,6 +38,7 @@
 #include "file_cache.h"
 #include "file_capture.h"
 #include "file_flows.h"
+#include "file_hasher.h"
 #include "file_stats.h"
 
 using namespace snort;
@@ -54,6 +55,13 @@ DecodeConfig FileService::decode_conf;
 static int64_t max_files_cached = 0;
 static int64_t capture_memcap = 0;
 static int64_t capture_block_size = 0;
+static unsigned capture_writer_threads = 0;
+static unsigned capture_io_uring_depth = 0;
+static bool capture_direct_io = false;
+static unsigned signature_threads = 0;
+static int64_t signature_memcap = 0;
+static int64_t verdict_cache_memcap = 0;
+static int64_t verdict_cache_ttl = 0;
 
 void FileService::init()
 {
@@ -86,14 +94,30 @@ void FileService::post_init()
         max_files_cached = conf->max_files_cached;
         file_cache->set_block_timeout(conf->file_block_timeout);
         file_cache->set_lookup_timeout(conf->file_lookup_timeout);
+        file_cache->set_verdict_cache(conf->verdict_cache_memcap * 1024 * 1024,
+            conf->verdict_cache_ttl);
+        verdict_cache_memcap = conf->verdict_cache_memcap;
+        verdict_cache_ttl = conf->verdict_cache_ttl;
     }
 
     if (file_capture_enabled)
     {
-        FileCapture::init(conf->capture_memcap, conf->capture_block_size);
+        FileCapture::init(conf->capture_memcap, conf->capture_block_size,
+            conf->capture_writer_threads, conf->capture_io_uring_depth, conf->capture_direct_io);
         capture_memcap = conf->capture_memcap;
         capture_block_size = conf->capture_block_size;
+        capture_writer_threads = conf->capture_writer_threads;
+        capture_io_uring_depth = conf->capture_io_uring_depth;
+        capture_direct_io = conf->capture_direct_io;
     }
+
+    if (file_signature_enabled and conf->signature_threads and !FileHasher::enabled())
+    {
+        FileHasher::init(conf->signature_threads, conf->signature_memcap * 1024 * 1024);
+        signature_threads = conf->signature_threads;
+        signature_memcap = conf->signature_memcap;
+    }
+
     const SnortConfig* sc = SnortConfig::get_conf();
     conf->snort_protocol_id = sc->proto_ref->find("file_id");
 }
@@ -109,14 +133,28 @@ void FileService::verify_reload(const SnortConfig* sc)
     if (max_files_cached != conf->max_files_cached)
         ReloadError("Changing file_inspect.max_files_cached requires a restart.\n");
 
+    if (verdict_cache_memcap != conf->verdict_cache_memcap or
+        verdict_cache_ttl != conf->verdict_cache_ttl)
+        ReloadError("Changing file_inspect.verdict_cache_* requires a restart.\n");
+
     if (file_capture_enabled)
     {
         if (capture_memcap != conf->capture_memcap)
             ReloadError("Changing file_inspect.capture_memcap requires a restart.\n");
         if (capture_block_size != conf->capture_block_size)
             ReloadError("Changing file_inspect.capture_block_size requires a restart.\n");
+        if (capture_writer_threads != conf->capture_writer_threads or
+            capture_io_uring_depth != conf->capture_io_uring_depth or
+            capture_direct_io != conf->capture_direct_io)
+            ReloadError("Changing file_inspect.capture writer settings requires a restart.\n");
     }
 
+    if (file_signature_enabled and signature_threads != conf->signature_threads)
+        ReloadError("Changing file_inspect.signature_threads requires a restart.\n");
+
+    if (file_signature_enabled and signature_threads and signature_memcap != conf->signature_memcap)
+        ReloadError("Changing file_inspect.signature_memcap requires a restart.\n");
+
     if (conf->snort_protocol_id == UNKNOWN_PROTOCOL_ID)
     {
         conf->snort_protocol_id = sc->proto_ref->find("file_id");
@@ -130,6 +168,7 @@ void FileService::close()
 
     MimeSession::exit();
     FileCapture::exit();
+    FileHasher::term();
 }
 
 void FileService::thread_init()
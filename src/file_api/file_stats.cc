@@ -35,8 +35,12 @@
 #include "utils/stats.h"
 #include "utils/util.h"
 
+#include "file_cache.h"
 #include "file_capture.h"
+#include "file_capture_writer.h"
+#include "file_hasher.h"
 #include "file_service.h"
+#include "file_verdict_cache.h"
 
 using namespace snort;
 
@@ -59,6 +63,11 @@ void file_counts_update_buffers()
 {
     file_counts.file_buffers_max = FileCapture::get_buffers_max();
     file_counts.file_buffers_in_use = FileCapture::get_buffers_in_use();
+    file_counts.signature_queue_depth = FileHasher::get_queue_depth();
+    file_counts.signature_queue_max = FileHasher::get_queue_max();
+    file_counts.capture_queue_depth = FileCaptureWriter::get_queue_depth();
+    file_counts.capture_queue_max = FileCaptureWriter::get_queue_max();
+    file_counts.capture_write_usecs_max = FileCaptureWriter::get_latency_max();
 }
 
 void file_stats_sum()
@@ -195,6 +204,26 @@ void file_stats_print()
     }
     LogText(buff);
 
+    FileCache* file_cache = FileService::get_file_cache();
+    FileVerdictCache* verdict_cache = file_cache ? file_cache->get_verdict_cache() : nullptr;
+
+    if ( verdict_cache )
+    {
+        LogLabel("verdict cache shards");
+        snprintf(buff, sizeof(buff), "%25.25s %-10s %-10s %-10s %-10s", "Shard",
+            "Hits", "Misses", "Inserts", "Evictions");
+        LogText(buff);
+
+        for ( unsigned i = 0; i < FileVerdictCache::num_shards; ++i )
+        {
+            FileVerdictCache::Stats vs = verdict_cache->get_stats(i);
+            snprintf(buff, sizeof(buff), "%25u " FMTu64("-10") " " FMTu64("-10") " "
+                FMTu64("-10") " " FMTu64("-10"), i, vs.hits, vs.misses, vs.inserts,
+                vs.evictions);
+            LogText(buff);
+        }
+    }
+
 #if 0
     LogLabel("file type verdicts");  // FIXIT-RC should be fixed
 
@@ -38,6 +38,16 @@ struct FileCounts
     PegCount max_concurrent_files_per_flow;
     PegCount file_buffers_max;              // maximum number of file buffers that can be allocated
     PegCount file_buffers_in_use;
+    PegCount signature_bytes_offloaded;
+    PegCount signature_waits;
+    PegCount signature_bytes_inline;
+    PegCount signature_queue_depth;
+    PegCount signature_queue_max;
+    PegCount verdict_cache_hits;
+    PegCount verdict_cache_misses;
+    PegCount capture_queue_depth;
+    PegCount capture_queue_max;
+    PegCount capture_write_usecs_max;
     PegCount files_buffered_total;
     PegCount files_released_total;
     PegCount files_freed_total;
@@ -0,0 +1,340 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// file_verdict_cache.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "file_verdict_cache.h"
+
+#include <cstring>
+
+#include "hash/hashes.h"
+
+#ifdef UNIT_TEST
+#include <thread>
+#include <vector>
+#include "catch/snort_catch.h"
+#endif
+
+static_assert(FileVerdictCache::num_shards == 16, "shard is picked by the top 4 bits");
+static_assert(SHA256_HASH_SIZE == 4 * sizeof(uint64_t), "key is 4 words");
+
+// the low 24 bits of the generation are enough to tell reloads apart
+static inline uint64_t make_meta(uint32_t policy_id, uint32_t generation, FileVerdict v)
+{ return ((uint64_t)generation << 40) | ((uint64_t)policy_id << 8) | (uint8_t)v; }
+
+FileVerdictCache::FileVerdictCache(size_t memcap, time_t t) : ttl(t)
+{
+    size_t buckets = memcap / (num_shards * ways * sizeof(Entry));
+    uint32_t n = 1;
+
+    while ( n * 2 <= buckets and n < (1u << 30) )
+        n *= 2;
+
+    mask = n - 1;
+
+    for ( auto& s : shards )
+    {
+        s.entries = new Entry[n * ways]();
+        s.hits = s.misses = s.inserts = s.evictions = 0;
+    }
+}
+
+FileVerdictCache::~FileVerdictCache()
+{
+    for ( auto& s : shards )
+        delete[] s.entries;
+}
+
+bool FileVerdictCache::same_key(const Entry& e, const uint64_t* key, uint64_t meta)
+{
+    if ( (e.meta.load(std::memory_order_relaxed) >> 8) != (meta >> 8) )
+        return false;
+
+    for ( unsigned i = 0; i < 4; ++i )
+        if ( e.key[i].load(std::memory_order_relaxed) != key[i] )
+            return false;
+
+    return true;
+}
+
+void FileVerdictCache::write(Entry& e, const uint64_t* key, uint64_t meta, uint32_t expire)
+{
+    uint32_t seq = e.seq.load(std::memory_order_relaxed);
+
+    e.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for ( unsigned i = 0; i < 4; ++i )
+        e.key[i].store(key[i], std::memory_order_relaxed);
+
+    e.meta.store(meta, std::memory_order_relaxed);
+    e.expire.store(expire, std::memory_order_relaxed);
+
+    e.seq.store(seq + 2, std::memory_order_release);
+}
+
+bool FileVerdictCache::find(const uint8_t* sha256, uint32_t policy_id, uint32_t generation,
+    time_t now, FileVerdict& v)
+{
+    uint64_t key[4];
+    memcpy(key, sha256, sizeof(key));
+
+    uint64_t policy = make_meta(policy_id, generation, FILE_VERDICT_UNKNOWN) >> 8;
+
+    Shard& s = get_shard(key);
+    Entry* e = get_bucket(s, key);
+
+    for ( unsigned w = 0; w < ways; ++w, ++e )
+    {
+        uint32_t seq = e->seq.load(std::memory_order_acquire);
+
+        if ( seq & 1 )
+            continue;
+
+        uint64_t k[4];
+
+        for ( unsigned i = 0; i < 4; ++i )
+            k[i] = e->key[i].load(std::memory_order_relaxed);
+
+        uint64_t meta = e->meta.load(std::memory_order_relaxed);
+        uint32_t expire = e->expire.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if ( e->seq.load(std::memory_order_relaxed) != seq )
+            continue;
+
+        if ( memcmp(k, key, sizeof(key)) or (meta >> 8) != policy or expire <= (uint32_t)now )
+            continue;
+
+        v = (FileVerdict)(meta & 0xff);
+        s.hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    s.misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void FileVerdictCache::add(const uint8_t* sha256, uint32_t policy_id, uint32_t generation,
+    FileVerdict v, time_t now)
+{
+    if ( !is_cacheable(v) )
+        return;
+
+    uint64_t key[4];
+    memcpy(key, sha256, sizeof(key));
+
+    Shard& s = get_shard(key);
+    Entry* b = get_bucket(s, key);
+    uint64_t meta = make_meta(policy_id, generation, v);
+    uint32_t expire = (uint32_t)(now + ttl);
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+    Entry* victim = nullptr;
+    bool update = false;
+
+    // writers are serialized so the entries are stable here
+    for ( unsigned w = 0; w < ways; ++w )
+    {
+        Entry& e = b[w];
+
+        if ( same_key(e, key, meta) )
+        {
+            victim = &e;
+            update = true;
+            break;
+        }
+
+        if ( !victim or e.expire.load(std::memory_order_relaxed) <
+            victim->expire.load(std::memory_order_relaxed) )
+            victim = &e;
+    }
+
+    if ( !update and victim->expire.load(std::memory_order_relaxed) > (uint32_t)now )
+        s.evictions.fetch_add(1, std::memory_order_relaxed);
+
+    write(*victim, key, meta, expire);
+    s.inserts.fetch_add(1, std::memory_order_relaxed);
+}
+
+FileVerdictCache::Stats FileVerdictCache::get_stats(unsigned shard) const
+{
+    const Shard& s = shards[shard];
+    return { s.hits.load(), s.misses.load(), s.inserts.load(), s.evictions.load() };
+}
+
+
+//-------------------------------------------------------------------------
+// unit tests
+//-------------------------------------------------------------------------
+
+#ifdef UNIT_TEST
+
+static void make_sha(uint8_t* sha, uint64_t top, uint64_t bucket, uint64_t id)
+{
+    uint64_t key[4] = { top << 60, bucket, id, ~id };
+    memcpy(sha, key, SHA256_HASH_SIZE);
+}
+
+TEST_CASE("verdict cache find and expire", "[file_verdict_cache]")
+{
+    FileVerdictCache cache(1 << 20, 10);
+    CHECK(cache.get_buckets() >= 256);
+
+    uint8_t sha[SHA256_HASH_SIZE];
+    make_sha(sha, 3, 7, 1);
+
+    FileVerdict v = FILE_VERDICT_UNKNOWN;
+    CHECK(!cache.find(sha, 1, 1, 100, v));
+
+    cache.add(sha, 1, 1, FILE_VERDICT_PENDING, 100);
+    CHECK(!cache.find(sha, 1, 1, 100, v));
+
+    cache.add(sha, 1, 1, FILE_VERDICT_BLOCK, 100);
+    CHECK(cache.find(sha, 1, 1, 109, v));
+    CHECK(v == FILE_VERDICT_BLOCK);
+
+    // policy is part of the key
+    CHECK(!cache.find(sha, 2, 1, 100, v));
+
+    // update in place
+    cache.add(sha, 1, 1, FILE_VERDICT_LOG, 105);
+    CHECK(cache.find(sha, 1, 1, 114, v));
+    CHECK(v == FILE_VERDICT_LOG);
+
+    CHECK(!cache.find(sha, 1, 1, 115, v));
+
+    FileVerdictCache::Stats stats = cache.get_stats(3);
+    CHECK(stats.hits == 2);
+    CHECK(stats.misses == 4);
+    CHECK(stats.inserts == 2);
+    CHECK(stats.evictions == 0);
+}
+
+TEST_CASE("verdict cache evicts closest to expiring", "[file_verdict_cache]")
+{
+    FileVerdictCache cache(0, 100);
+    CHECK(cache.get_buckets() == 1);
+
+    uint8_t sha[SHA256_HASH_SIZE];
+    FileVerdict v;
+
+    for ( unsigned i = 0; i <= FileVerdictCache::ways; ++i )
+    {
+        make_sha(sha, 0, 0, i);
+        cache.add(sha, 0, 1, FILE_VERDICT_LOG, 10 + i);
+    }
+
+    make_sha(sha, 0, 0, 0);
+    CHECK(!cache.find(sha, 0, 1, 20, v));
+
+    for ( unsigned i = 1; i <= FileVerdictCache::ways; ++i )
+    {
+        make_sha(sha, 0, 0, i);
+        CHECK(cache.find(sha, 0, 1, 20, v));
+    }
+    CHECK(cache.get_stats(0).evictions == 1);
+}
+
+TEST_CASE("verdict cache reload", "[file_verdict_cache]")
+{
+    FileVerdictCache cache(1 << 20, 100);
+
+    uint8_t sha[SHA256_HASH_SIZE];
+    make_sha(sha, 5, 9, 1);
+
+    // each configuration has its own policy
+    snort::FilePolicyBase* old_policy = new snort::FilePolicyBase;
+    snort::FilePolicyBase* new_policy = new snort::FilePolicyBase;
+    uint32_t old_gen = old_policy->get_generation();
+    uint32_t new_gen = new_policy->get_generation();
+    REQUIRE(old_gen != new_gen);
+
+    FileVerdict v = FILE_VERDICT_UNKNOWN;
+    cache.add(sha, 0, old_gen, FILE_VERDICT_BLOCK, 10);
+
+    // the reloaded policy doesn't see the old verdict
+    CHECK(!cache.find(sha, 0, new_gen, 11, v));
+
+    cache.add(sha, 0, new_gen, FILE_VERDICT_LOG, 11);
+    CHECK(cache.find(sha, 0, new_gen, 12, v));
+    CHECK(v == FILE_VERDICT_LOG);
+
+    // flows still on the old policy keep its verdict
+    CHECK(cache.find(sha, 0, old_gen, 12, v));
+    CHECK(v == FILE_VERDICT_BLOCK);
+
+    // only the low 24 bits of the generation are kept
+    CHECK(cache.find(sha, 0, new_gen + (1 << 24), 12, v));
+
+    snort::FilePolicyBase::delete_file_policy(old_policy);
+    snort::FilePolicyBase::delete_file_policy(new_policy);
+}
+
+TEST_CASE("verdict cache concurrent readers", "[file_verdict_cache]")
+{
+    FileVerdictCache cache(0, 1000);
+    std::atomic<bool> done(false);
+    std::atomic<unsigned> bad(0);
+
+    auto reader = [&]()
+    {
+        uint8_t sha[SHA256_HASH_SIZE];
+        FileVerdict v;
+
+        while ( !done )
+        {
+            for ( unsigned i = 0; i < 8; ++i )
+            {
+                make_sha(sha, 0, 0, i);
+
+                // the verdict always follows the id
+                if ( cache.find(sha, i, 1, 1, v) and v != (i & 1 ? FILE_VERDICT_BLOCK : FILE_VERDICT_LOG) )
+                    ++bad;
+            }
+        }
+    };
+
+    std::vector<std::thread> readers;
+
+    for ( unsigned t = 0; t < 3; ++t )
+        readers.emplace_back(reader);
+
+    uint8_t sha[SHA256_HASH_SIZE];
+
+    for ( unsigned n = 0; n < 20000; ++n )
+    {
+        unsigned i = n % 8;
+        make_sha(sha, 0, 0, i);
+        cache.add(sha, i, 1, i & 1 ? FILE_VERDICT_BLOCK : FILE_VERDICT_LOG, 1);
+    }
+
+    done = true;
+
+    for ( auto& t : readers )
+        t.join();
+
+    CHECK(bad == 0);
+}
+
+#endif
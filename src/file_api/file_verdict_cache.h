@@ -0,0 +1,110 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// file_verdict_cache.h
+
+#ifndef FILE_VERDICT_CACHE_H
+#define FILE_VERDICT_CACHE_H
+
+// signature verdicts by SHA-256 and file policy, shared by all packet
+// threads, so a popular file downloaded by many clients gets its verdict
+// without another signature lookup.  the policy generation is part of the
+// key so a reload never sees the verdicts of the previous policy.
+//
+// the table is split into shards by the leading bits of the SHA.  each
+// shard is an array of 4 way buckets allocated up front from the memcap.
+// lookups don't lock; every entry is a seqlock and a reader that races a
+// writer just misses.  inserts take the shard lock and replace an expired
+// entry or else the one closest to expiring.
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+
+#include "file_api.h"
+
+class FileVerdictCache
+{
+public:
+    struct Stats
+    {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t inserts;
+        uint64_t evictions;
+    };
+
+    static constexpr unsigned num_shards = 16;
+    static constexpr unsigned ways = 4;
+
+    FileVerdictCache(size_t memcap, time_t ttl);
+    ~FileVerdictCache();
+
+    // true and verdict set if a live entry exists
+    bool find(const uint8_t* sha256, uint32_t policy_id, uint32_t generation, time_t now,
+        FileVerdict&);
+
+    // only final verdicts are cached
+    void add(const uint8_t* sha256, uint32_t policy_id, uint32_t generation, FileVerdict,
+        time_t now);
+
+    static bool is_cacheable(FileVerdict v)
+    { return v == FILE_VERDICT_LOG or v == FILE_VERDICT_BLOCK or v == FILE_VERDICT_REJECT; }
+
+    unsigned get_buckets() const
+    { return mask + 1; }
+
+    Stats get_stats(unsigned shard) const;
+
+private:
+    struct Entry
+    {
+        std::atomic<uint32_t> seq;
+        std::atomic<uint32_t> expire;
+        std::atomic<uint64_t> meta;     // generation << 40 | policy id << 8 | verdict
+        std::atomic<uint64_t> key[4];
+    };
+
+    struct alignas(64) Shard
+    {
+        Entry* entries;
+        std::mutex mutex;
+
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> misses;
+        std::atomic<uint64_t> inserts;
+        std::atomic<uint64_t> evictions;
+    };
+
+    Shard& get_shard(const uint64_t* key)
+    { return shards[key[0] >> 60]; }
+
+    Entry* get_bucket(Shard& s, const uint64_t* key) const
+    { return s.entries + (key[1] & mask) * ways; }
+
+    static bool same_key(const Entry&, const uint64_t* key, uint64_t meta);
+    static void write(Entry&, const uint64_t* key, uint64_t meta, uint32_t expire);
+
+    Shard shards[num_shards];
+    uint32_t mask;
+    time_t ttl;
+};
+
+#endif
+
@@ -27,6 +27,7 @@
 #include "detection/detection_continuation.h"
 #include "detection/detection_engine.h"
 #include "flow/flow_control.h"
+#include "flow/flow_cost.h"
 #include "flow/ha.h"
 #include "flow/session.h"
 #include "framework/data_bus.h"
@@ -48,6 +49,8 @@ extern THREAD_LOCAL class FlowControl* flow_con;
 
 Flow::~Flow()
 {
+    FlowCost::close(*this);
+
     PolicySwitcher ps(this);
     EofEvent eof_event(this);
     DataBus::publish(intrinsic_pub_id, IntrinsicEventIds::FLOW_END, eof_event, this);
@@ -105,6 +108,7 @@ inline void Flow::clean()
     bitop = nullptr;
     filtering_state.clear();
 
+    FlowCost::close(*this);
     inspected_packet_count = 0;
     inspection_duration = 0;
 }
@@ -0,0 +1,248 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// flow_cost.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "flow_cost.h"
+
+#include <algorithm>
+
+#include "flow/flow.h"
+#include "main/snort_types.h"
+#include "time/packet_time.h"
+
+using namespace snort;
+
+// min heap on inspection time.  any packet on a flow that isn't costlier
+// than the root is one compare; costlier flows are looked up by key.
+class FlowCostTracker
+{
+public:
+    void update(const Flow&);
+    void close(const Flow&);
+    void get_top(std::vector<FlowCostEntry>&) const;
+
+private:
+    int find(const Flow&) const;
+    void sift_up(unsigned i);
+    void sift_down(unsigned i);
+    void remove(unsigned i);
+    void expire(time_t now);
+
+    FlowCostEntry heap[FlowCost::max_flows];
+    unsigned size = 0;
+    time_t next_expire = 0;
+};
+
+static THREAD_LOCAL FlowCostTracker* tracker = nullptr;
+static FlowCost::LabelFunc label_func = nullptr;
+
+// labels may not be known yet when a flow is first tracked and may be gone
+// when it closes so they are filled in once and updated when available
+static void snapshot(FlowCostEntry& e, const Flow& flow, bool relabel)
+{
+    e.usecs = flow.get_inspection_duration();
+    e.bytes = flow.flowstats.client_bytes + flow.flowstats.server_bytes;
+    e.packets = flow.flowstats.client_pkts + flow.flowstats.server_pkts;
+
+    if ( flow.service and (relabel or e.service.empty()) )
+        e.service = flow.service;
+
+    if ( label_func and (relabel or e.app.empty()) )
+    {
+        if ( const char* app = label_func(flow) )
+            e.app = app;
+    }
+}
+
+int FlowCostTracker::find(const Flow& flow) const
+{
+    for ( unsigned i = 0; i < size; ++i )
+    {
+        if ( !heap[i].closed and FlowKey::is_equal(&heap[i].key, flow.key) )
+            return i;
+    }
+    return -1;
+}
+
+void FlowCostTracker::sift_up(unsigned i)
+{
+    while ( i )
+    {
+        unsigned parent = (i - 1) / 2;
+
+        if ( heap[parent].usecs <= heap[i].usecs )
+            break;
+
+        std::swap(heap[i], heap[parent]);
+        i = parent;
+    }
+}
+
+void FlowCostTracker::sift_down(unsigned i)
+{
+    while ( true )
+    {
+        unsigned min = i;
+        unsigned left = 2 * i + 1;
+        unsigned right = left + 1;
+
+        if ( left < size and heap[left].usecs < heap[min].usecs )
+            min = left;
+
+        if ( right < size and heap[right].usecs < heap[min].usecs )
+            min = right;
+
+        if ( min == i )
+            break;
+
+        std::swap(heap[i], heap[min]);
+        i = min;
+    }
+}
+
+void FlowCostTracker::remove(unsigned i)
+{
+    if ( i != --size )
+    {
+        heap[i] = std::move(heap[size]);
+        sift_up(i);
+        sift_down(i);
+    }
+    heap[size] = FlowCostEntry();
+}
+
+void FlowCostTracker::expire(time_t now)
+{
+    next_expire = now + 1;
+    unsigned i = 0;
+
+    while ( i < size )
+    {
+        if ( heap[i].closed and heap[i].closed + FlowCost::closed_hold <= now )
+            remove(i);
+        else
+            ++i;
+    }
+}
+
+void FlowCostTracker::update(const Flow& flow)
+{
+    time_t now = packet_time();
+
+    if ( now >= next_expire )
+        expire(now);
+
+    uint64_t usecs = flow.get_inspection_duration();
+
+    // a tracked flow is never below the root so it is current when it's equal
+    if ( !flow.key or (size == FlowCost::max_flows and usecs <= heap[0].usecs) )
+        return;
+
+    int i = find(flow);
+
+    if ( i >= 0 )
+    {
+        snapshot(heap[i], flow, false);
+        sift_down(i);
+        return;
+    }
+
+    FlowCostEntry e;
+    e.key = *flow.key;
+    e.key_is_reversed = flow.flags.key_is_reversed;
+    snapshot(e, flow, true);
+
+    if ( size == FlowCost::max_flows )
+    {
+        heap[0] = std::move(e);
+        sift_down(0);
+        return;
+    }
+
+    heap[size] = std::move(e);
+    sift_up(size++);
+}
+
+void FlowCostTracker::close(const Flow& flow)
+{
+    // flows may be closed on a thread that didn't inspect them
+    if ( !size or !flow.key or flow.get_inspection_duration() < heap[0].usecs )
+        return;
+
+    int i = find(flow);
+
+    if ( i < 0 )
+        return;
+
+    snapshot(heap[i], flow, true);
+    heap[i].closed = packet_time();
+    sift_down(i);
+}
+
+void FlowCostTracker::get_top(std::vector<FlowCostEntry>& top) const
+{
+    top.insert(top.end(), heap, heap + size);
+
+    std::sort(top.begin(), top.end(),
+        [](const FlowCostEntry& lhs, const FlowCostEntry& rhs)
+        { return lhs.usecs > rhs.usecs; });
+}
+
+//-------------------------------------------------------------------------
+// api
+//-------------------------------------------------------------------------
+
+void FlowCost::set_label(LabelFunc f)
+{
+    label_func = f;
+}
+
+void FlowCost::tinit()
+{
+    if ( !tracker )
+        tracker = new FlowCostTracker;
+}
+
+void FlowCost::tterm()
+{
+    delete tracker;
+    tracker = nullptr;
+}
+
+void FlowCost::update(const Flow& flow)
+{
+    if ( tracker )
+        tracker->update(flow);
+}
+
+void FlowCost::close(const Flow& flow)
+{
+    if ( tracker )
+        tracker->close(flow);
+}
+
+void FlowCost::get_top(std::vector<FlowCostEntry>& top)
+{
+    if ( tracker )
+        tracker->get_top(top);
+}
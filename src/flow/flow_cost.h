@@ -0,0 +1,89 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// flow_cost.h
+
+#ifndef FLOW_COST_H
+#define FLOW_COST_H
+
+// per flow inspection cost.  flows already accumulate the time spent
+// inspecting their packets and each packet thread keeps a min heap of its
+// costliest flows, live or recently closed, so the few flows burning most
+// of the cpu can be found and trusted or blocked.  entries copy what they
+// report from the flow so they never point to it.
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "flow/flow_key.h"
+
+namespace snort
+{
+class Flow;
+}
+
+struct FlowCostEntry
+{
+    snort::FlowKey key = {};
+    bool key_is_reversed = false;
+
+    std::string service;
+    std::string app;
+
+    uint64_t usecs = 0;
+    uint64_t bytes = 0;
+    uint64_t packets = 0;
+
+    time_t closed = 0;              // packet time closed or 0 if live
+
+    double nsecs_per_byte() const
+    { return bytes ? 1000.0 * double(usecs) / double(bytes) : 0.0; }
+};
+
+class FlowCost
+{
+public:
+    // flows tracked per packet thread
+    static constexpr unsigned max_flows = 32;
+
+    // closed flows are dropped after this many seconds unless displaced
+    static constexpr time_t closed_hold = 300;
+
+    // returns a label such as the application name for the flow or nullptr
+    typedef const char* (*LabelFunc)(const snort::Flow&);
+
+    // set by the inspector that can name flows, nullptr to clear
+    static void set_label(LabelFunc);
+
+    static void tinit();
+    static void tterm();
+
+    // update this thread's top flows with the flow's inspection duration
+    static void update(const snort::Flow&);
+
+    // keep a snapshot of a tracked flow that is going away
+    static void close(const snort::Flow&);
+
+    // this thread's top flows, costliest first
+    static void get_top(std::vector<FlowCostEntry>&);
+};
+
+#endif
+
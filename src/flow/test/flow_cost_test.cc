@@ -0,0 +1,190 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// flow_cost_test.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <list>
+#include <vector>
+
+#include "flow/flow.h"
+#include "flow/flow_cost.h"
+#include "time/packet_time.h"
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+
+using namespace snort;
+
+static time_t now = 1000;
+
+namespace snort
+{
+Flow::~Flow()
+{
+    FlowCost::close(*this);
+}
+
+FlowDataStore::~FlowDataStore() = default;
+
+time_t packet_time() { return now; }
+}
+
+static const char* test_label(const Flow&)
+{ return "test_app"; }
+
+struct TestFlow
+{
+    FlowKey key = {};
+    Flow flow;
+
+    TestFlow(uint16_t port)
+    {
+        key.port_l = port;
+        flow.key = &key;
+    }
+
+    void inspect(uint64_t usecs)
+    {
+        flow.add_inspection_duration(usecs);
+        FlowCost::update(flow);
+    }
+};
+
+static std::vector<FlowCostEntry> get_top()
+{
+    std::vector<FlowCostEntry> top;
+    FlowCost::get_top(top);
+    return top;
+}
+
+TEST_GROUP(flow_cost)
+{
+    void setup() override
+    {
+        now = 1000;
+        FlowCost::tinit();
+        FlowCost::set_label(test_label);
+    }
+
+    void teardown() override
+    {
+        FlowCost::set_label(nullptr);
+        FlowCost::tterm();
+    }
+};
+
+TEST(flow_cost, costliest_first)
+{
+    TestFlow a(1), b(2), c(3);
+
+    a.inspect(100);
+    b.inspect(300);
+    c.inspect(200);
+    a.inspect(250);
+
+    auto top = get_top();
+
+    CHECK_EQUAL(3, top.size());
+    CHECK_EQUAL(350, top[0].usecs);
+    CHECK_EQUAL(1, top[0].key.port_l);
+    CHECK_EQUAL(300, top[1].usecs);
+    CHECK_EQUAL(200, top[2].usecs);
+    CHECK(top[0].closed == 0);
+    STRCMP_EQUAL("test_app", top[0].app.c_str());
+}
+
+TEST(flow_cost, keeps_top_n)
+{
+    std::list<TestFlow> flows;
+
+    for ( unsigned i = 0; i < FlowCost::max_flows + 8; ++i )
+    {
+        flows.emplace_back(i + 1);
+        flows.back().inspect(i + 1);
+    }
+
+    // an evicted flow comes back once it is costlier than the least
+    flows.front().inspect(1000);
+
+    auto top = get_top();
+
+    CHECK_EQUAL(FlowCost::max_flows, top.size());
+    CHECK_EQUAL(1001, top.front().usecs);
+    CHECK_EQUAL(1, top.front().key.port_l);
+    CHECK_EQUAL(flows.size() - FlowCost::max_flows + 2, top.back().usecs);
+}
+
+TEST(flow_cost, bytes)
+{
+    TestFlow f(1);
+    f.flow.flowstats.client_bytes = 600;
+    f.flow.flowstats.server_bytes = 400;
+
+    f.inspect(5000);
+    auto top = get_top();
+
+    CHECK_EQUAL(1000, top[0].bytes);
+    CHECK(top[0].nsecs_per_byte() == 5000.0);
+}
+
+TEST(flow_cost, closed_flows_are_kept_then_expire)
+{
+    TestFlow* f = new TestFlow(1);
+    f->inspect(1000);
+    delete f;
+
+    TestFlow live(2);
+    live.inspect(10);
+
+    auto top = get_top();
+    CHECK_EQUAL(2, top.size());
+    CHECK(top[0].closed == now);
+    CHECK_EQUAL(1000, top[0].usecs);
+
+    now += FlowCost::closed_hold;
+    live.inspect(10);
+
+    top = get_top();
+    CHECK_EQUAL(1, top.size());
+    CHECK_EQUAL(20, top[0].usecs);
+}
+
+TEST(flow_cost, reused_key_is_a_new_entry)
+{
+    TestFlow* f = new TestFlow(1);
+    f->inspect(500);
+    delete f;
+
+    TestFlow again(1);
+    again.inspect(100);
+
+    auto top = get_top();
+    CHECK_EQUAL(2, top.size());
+    CHECK(top[0].closed == now);
+    CHECK(top[1].closed == 0);
+    CHECK_EQUAL(100, top[1].usecs);
+}
+
+int main(int argc, char** argv)
+{
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
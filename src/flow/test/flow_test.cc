@@ -28,6 +28,7 @@
 #include "flow/flow.h"
 #include "flow/flow_config.h"
 #include "flow/flow_control.h"
+#include "flow/flow_cost.h"
 #include "flow/flow_stash.h"
 #include "flow/ha.h"
 #include "framework/inspector.h"
@@ -96,6 +97,8 @@ const SnortConfig* SnortConfig::get_conf() { return nullptr; }
 PolicySwitcher::PolicySwitcher(snort::Flow*) { }
 PolicySwitcher::~PolicySwitcher() { }
 
+void FlowCost::close(const Flow&) { }
+
 TEST_GROUP(nondefault_timeout)
 {
 };
@@ -38,7 +38,7 @@
 namespace snort
 {
 // this is the current version of the api
-#define SEAPI_VERSION ((BASE_API_VERSION << 16) | 3)
+#define SEAPI_VERSION ((BASE_API_VERSION << 16) | 4)
 
 struct SnortConfig;
 struct MpseApi;
@@ -104,6 +104,10 @@ public:
     virtual bool deserialize(const uint8_t*, size_t) { return false; }
     virtual void get_hash(std::string&) { }
 
+    // share the compiled state of an mpse of the same api with the same
+    // hash, eg from the previous config on reload; true if prep is skipped
+    virtual bool adopt(const Mpse&) { return false; }
+
     const char* get_method() { return method.c_str(); }
     void set_verbose(bool b = true) { verbose = b; }
 
@@ -23,6 +23,8 @@
 #include <string>
 #include <unordered_set>
 
+#include "hash/hashes.h"
+
 struct JSNormConfig
 {
     int64_t bytes_depth = -1;
@@ -33,6 +35,10 @@ struct JSNormConfig
     uint32_t pdf_max_dictionary_depth = 32;
     std::unordered_set<std::string> ignored_ids;
     std::unordered_set<std::string> ignored_props;
+    size_t cache_memcap = 0;
+
+    // of the options above, part of the normalized script cache key
+    uint8_t digest[SHA256_HASH_SIZE] = {};
 };
 
 #endif
@@ -41,6 +41,8 @@ enum PEG_COUNT
     PEG_BYTES = 0,
     PEG_IDENTIFIERS,
     PEG_IDENTIFIER_OVERFLOWS,
+    PEG_CACHE_HITS,
+    PEG_CACHE_MISSES,
     PEG_COUNT_MAX
 };
 
@@ -62,6 +64,23 @@ enum EventSid
 
 }
 
-using JSEvents = EventGen<jsn::EVENT__MAX_VALUE, jsn::EVENT__NONE, jsn::js_gid>;
+// remembers what was raised so a cached script can raise it again
+class JSEvents : public EventGen<jsn::EVENT__MAX_VALUE, jsn::EVENT__NONE, jsn::js_gid>
+{
+public:
+    void create_event(int sid)
+    {
+        EventGen::create_event(sid);
+
+        if (sid != jsn::EVENT__NONE)
+            raised[sid-1] = true;
+    }
+
+    const std::bitset<jsn::EVENT__MAX_VALUE>& get_raised() const
+    { return raised; }
+
+private:
+    std::bitset<jsn::EVENT__MAX_VALUE> raised = 0;
+};
 
 #endif
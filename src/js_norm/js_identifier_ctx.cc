@@ -23,6 +23,7 @@
 
 #include "js_identifier_ctx.h"
 
+#include <algorithm>
 #include <cassert>
 #include <memory.h>
 
@@ -63,6 +64,45 @@ static void init_norm_names()
 
 static int _init_norm_names __attribute__((unused)) = (static_cast<void>(init_norm_names()), 0);
 
+JSIdentifierCtx::NameArena::~NameArena()
+{
+    for (auto& b : blocks)
+        delete[] b.first;
+}
+
+const char* JSIdentifierCtx::NameArena::intern(std::string_view name)
+{
+    const size_t size = name.size() + 1;
+
+    while (size > (size_t)(end - pos))
+    {
+        if (block < blocks.size() and blocks[block].second >= size)
+        {
+            pos = blocks[block].first;
+            end = pos + blocks[block].second;
+            ++block;
+            continue;
+        }
+
+        // a name bigger than the next free block gets its own in front of it
+        const size_t n = std::max(size, block_size);
+        blocks.insert(blocks.begin() + block, { new char[n], n });
+    }
+
+    char* name_copy = pos;
+    memcpy(name_copy, name.data(), name.size());
+    name_copy[name.size()] = '\0';
+    pos += size;
+
+    return name_copy;
+}
+
+void JSIdentifierCtx::NameArena::reset()
+{
+    block = 0;
+    pos = end = nullptr;
+}
+
 JSIdentifierCtx::JSIdentifierCtx(int32_t depth, uint32_t max_scope_depth,
     const std::unordered_set<std::string>& ignored_ids_list,
     const std::unordered_set<std::string>& ignored_props_list)
@@ -71,7 +111,7 @@ JSIdentifierCtx::JSIdentifierCtx(int32_t depth, uint32_t max_scope_depth,
 {
     norm_name = norm_names;
     norm_name_end = norm_names + NORM_NAME_SIZE * std::min(depth, NORM_NAME_CNT);
-    scopes.emplace_back(JSProgramScopeType::GLOBAL);
+    scopes.push_back({JSProgramScopeType::GLOBAL, 0});
 
     init_ignored_names();
 }
@@ -92,11 +132,19 @@ const char* JSIdentifierCtx::substitute(const char* id_name, bool is_property)
     if (id_name[1] == '\0')
         return substitute(*id_name, is_property);
 
-    const auto it = id_names.find(id_name);
-    if (it != id_names.end() && is_substituted(it->second, is_property))
-        return is_property ? it->second.prop_name : it->second.id_name;
+    const std::string_view name(id_name);
+    NormId* id = id_names.find(name);
+
+    if (id && is_substituted(*id, is_property))
+        return is_property ? id->prop_name : id->id_name;
 
-    return acquire_norm_name(id_names[id_name]);
+    if (!id)
+    {
+        bool added;
+        id = &id_names.get(arena.intern(name), added);
+    }
+
+    return acquire_norm_name(*id);
 }
 
 bool JSIdentifierCtx::is_ignored(const char* id_name) const
@@ -139,7 +187,10 @@ void JSIdentifierCtx::init_ignored_names()
         if (iid.length() == 1)
             id_fast[(unsigned)iid[0]] = {iid.c_str(), nullptr, TYPE_IGNORED_ID};
         else
-            id_names[iid] = {iid.c_str(), nullptr, TYPE_IGNORED_ID};
+        {
+            bool added;
+            id_names.get(iid, added) = {iid.c_str(), nullptr, TYPE_IGNORED_ID};
+        }
 
     for (const auto& iprop : ignored_props_list)
     {
@@ -150,8 +201,10 @@ void JSIdentifierCtx::init_ignored_names()
         }
         else
         {
-            id_names[iprop].prop_name = iprop.c_str();
-            id_names[iprop].type |= TYPE_IGNORED_PROP;
+            bool added;
+            NormId& id = id_names.get(iprop, added);
+            id.prop_name = iprop.c_str();
+            id.type |= TYPE_IGNORED_PROP;
         }
     }
 }
@@ -163,7 +216,7 @@ bool JSIdentifierCtx::scope_push(JSProgramScopeType t)
     if (scopes.size() >= max_scope_depth)
         return false;
 
-    scopes.emplace_back(t);
+    scopes.push_back({t, (uint32_t)alias_log.size()});
     return true;
 }
 
@@ -171,10 +224,24 @@ bool JSIdentifierCtx::scope_pop(JSProgramScopeType t)
 {
     assert(t != JSProgramScopeType::GLOBAL && t != JSProgramScopeType::PROG_SCOPE_TYPE_MAX);
 
-    if (scopes.back().type() != t)
+    if (scopes.back().type != t)
         return false;
 
     assert(scopes.size() != 1);
+
+    // undo the aliases added in this scope
+    const uint32_t log_size = scopes.back().log_size;
+
+    while (alias_log.size() > log_size)
+    {
+        uint32_t& top = alias_tops[alias_log.back()];
+        assert(top == alias_values.size() - 1);
+
+        top = alias_values.back().prev;
+        alias_values.pop_back();
+        alias_log.pop_back();
+    }
+
     scopes.pop_back();
     return true;
 }
@@ -184,8 +251,13 @@ void JSIdentifierCtx::reset()
     memset(&id_fast, 0, sizeof(id_fast));
     norm_name = norm_names;
     id_names.clear();
+    aliases.clear();
+    alias_tops.clear();
+    alias_values.clear();
+    alias_log.clear();
+    arena.reset();
     scopes.clear();
-    scopes.emplace_back(JSProgramScopeType::GLOBAL);
+    scopes.push_back({JSProgramScopeType::GLOBAL, 0});
     init_ignored_names();
 }
 
@@ -194,20 +266,36 @@ void JSIdentifierCtx::add_alias(const char* alias, const std::string&& value)
     assert(alias);
     assert(!scopes.empty());
 
-    auto& a = aliases[alias];
-    a.emplace_back(std::move(value));
+    const std::string_view name(alias);
+    uint32_t* a = aliases.find(name);
+
+    if (!a)
+    {
+        bool added;
+        a = &aliases.get(arena.intern(name), added);
+        *a = alias_tops.size();
+        alias_tops.push_back(no_alias);
+    }
+
+    uint32_t& top = alias_tops[*a];
+    alias_values.push_back({arena.intern(value), top});
+    top = alias_values.size() - 1;
 
-    scopes.back().reference(a);
+    // the global scope is never popped
+    if (scopes.size() > 1)
+        alias_log.push_back(*a);
 }
 
 const char* JSIdentifierCtx::alias_lookup(const char* alias) const
 {
     assert(alias);
 
-    const auto& i = aliases.find(alias);
+    const uint32_t* a = aliases.find(alias);
+
+    if (!a or alias_tops[*a] == no_alias)
+        return nullptr;
 
-    return i != aliases.end() && !i->second.empty()
-        ? i->second.back().c_str() : nullptr;
+    return alias_values[alias_tops[*a]].value;
 }
 
 // advanced program scope access for testing
@@ -222,7 +310,7 @@ bool JSIdentifierCtx::scope_check(const std::list<JSProgramScopeType>& compare)
     auto cmp = compare.begin();
     for (auto it = scopes.begin(); it != scopes.end(); ++it, ++cmp)
     {
-        if (it->type() != *cmp)
+        if (it->type != *cmp)
             return false;
     }
     return true;
@@ -232,7 +320,7 @@ const std::list<JSProgramScopeType> JSIdentifierCtx::get_types() const
 {
     std::list<JSProgramScopeType> return_list;
     std::transform(scopes.cbegin(), scopes.cend(), std::back_inserter(return_list),
-        [](const ProgramScope& scope){ return scope.type(); });
+        [](const ProgramScope& scope){ return scope.type; });
     return return_list;
 }
 
@@ -23,7 +23,7 @@
 #include <cstdint>
 #include <list>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <unordered_set>
 #include <vector>
 
@@ -80,42 +80,140 @@ private:
         uint8_t type = 0;
     };
 
-    using Alias = std::vector<std::string>;
-    using AliasRef = std::list<Alias*>;
-    using AliasMap = std::unordered_map<std::string, Alias>;
-    using NameMap = std::unordered_map<std::string, NormId>;
-
-    class ProgramScope
+    // names live here for the life of the context, so the maps can key by view;
+    // reset rewinds it and keeps the blocks
+    class NameArena
     {
     public:
-        ProgramScope(JSProgramScopeType t) : t(t)
-        {}
+        NameArena() = default;
+        NameArena(const NameArena&) = delete;
+        ~NameArena();
 
-        ~ProgramScope()
-        { for (auto a : to_remove) a->pop_back(); }
+        // copy of the name, null terminated
+        const char* intern(std::string_view);
+        void reset();
 
-        void reference(Alias& a)
-        { to_remove.push_back(&a); }
+    private:
+        static constexpr size_t block_size = 16384;
 
-        JSProgramScopeType type() const
-        { return t; }
+        std::vector<std::pair<char*, size_t>> blocks;
+        size_t block = 0;
+        char* pos = nullptr;
+        char* end = nullptr;
+    };
+
+    // open addressed with linear probing, no removal; the map doesn't own
+    // the names, they must outlive it
+    template <typename T>
+    class NameMap
+    {
+    public:
+        NameMap()
+        { slots.resize(min_slots); }
+
+        T* find(std::string_view name)
+        {
+            Slot& s = slots[probe(name)];
+            return s.name ? &s.value : nullptr;
+        }
+
+        const T* find(std::string_view name) const
+        { return const_cast<NameMap*>(this)->find(name); }
+
+        T& get(std::string_view name, bool& added)
+        {
+            size_t i = probe(name);
+            added = !slots[i].name;
+
+            if (added)
+            {
+                if (2 * (count + 1) > slots.size())
+                {
+                    grow();
+                    i = probe(name);
+                }
+
+                slots[i].name = name.data();
+                slots[i].len = name.size();
+                ++count;
+            }
+
+            return slots[i].value;
+        }
+
+        void clear()
+        {
+            for (auto& s : slots)
+                s = Slot();
+            count = 0;
+        }
 
     private:
-        JSProgramScopeType t;
-        AliasRef to_remove{};
+        static constexpr size_t min_slots = 64;
+
+        struct Slot
+        {
+            const char* name = nullptr;
+            size_t len = 0;
+            T value{};
+        };
+
+        size_t probe(std::string_view name) const
+        {
+            const size_t mask = slots.size() - 1;
+            size_t i = std::hash<std::string_view>()(name) & mask;
+
+            while (slots[i].name and std::string_view(slots[i].name, slots[i].len) != name)
+                i = (i + 1) & mask;
+
+            return i;
+        }
+
+        void grow()
+        {
+            std::vector<Slot> old(slots.size() * 2);
+            old.swap(slots);
+
+            for (auto& s : old)
+                if (s.name)
+                    slots[probe(std::string_view(s.name, s.len))] = s;
+        }
+
+        std::vector<Slot> slots;
+        size_t count = 0;
+    };
+
+    // each alias keeps a stack of values through the entries' prev links;
+    // pushes are logged so popping a scope can undo its own
+    struct AliasValue
+    {
+        const char* value;
+        uint32_t prev;
     };
 
+    struct ProgramScope
+    {
+        JSProgramScopeType type;
+        uint32_t log_size;    // alias pushes before this scope
+    };
+
+    static constexpr uint32_t no_alias = UINT32_MAX;
+
     inline const char* substitute(unsigned char c, bool is_property);
     inline bool is_substituted(const NormId& id, bool is_property);
     inline const char* acquire_norm_name(NormId& id);
     inline void init_ignored_names();
 
-    // do not swap next two lines, the destructor frees them in the reverse order
-    AliasMap aliases;
-    std::list<ProgramScope> scopes;
+    NameArena arena;
+
+    NameMap<uint32_t> aliases;              // name -> index into alias_tops
+    std::vector<uint32_t> alias_tops;       // index into alias_values or no_alias
+    std::vector<AliasValue> alias_values;
+    std::vector<uint32_t> alias_log;        // index into alias_tops of each push
+    std::vector<ProgramScope> scopes;
 
     NormId id_fast[256];
-    NameMap id_names;
+    NameMap<NormId> id_names;
     const std::unordered_set<std::string>& ignored_ids_list;
     const std::unordered_set<std::string>& ignored_props_list;
 
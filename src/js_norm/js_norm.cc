@@ -28,6 +28,7 @@
 
 #include "js_identifier_ctx.h"
 #include "js_normalizer.h"
+#include "js_norm_cache.h"
 #include "js_norm_module.h"
 
 using namespace jsn;
@@ -77,11 +78,13 @@ JSNorm::~JSNorm()
 {
     delete idn_ctx;
     delete jsn_ctx;
+    delete[] cached_script;
 
     debug_log(4, js_trace, TRACE_PROC, nullptr, "context deleted\n");
 }
 
-void JSNorm::normalize(const void* in_data, size_t in_len, const void*& data, size_t& len)
+void JSNorm::normalize(const void* in_data, size_t in_len, const void*& data, size_t& len,
+    bool complete)
 {
     if (!alive)
     {
@@ -110,7 +113,36 @@ void JSNorm::normalize(const void* in_data, size_t in_len, const void*& data, si
     src_ptr = (const uint8_t*)in_data;
     src_end = src_ptr + in_len;
 
-    while (alive and pre_proc())
+    bool more = pre_proc();
+    JSNormCache* cache = nullptr;
+    JSNormCache::Key key;
+    PegCount pegs[PEG_CACHE_HITS] = { };
+    const auto raised = events.get_raised();
+
+    if (more and complete and !jsn_ctx and !cached_script and cacheable())
+        cache = JSNormCache::get(config->cache_memcap);
+
+    if (cache)
+    {
+        key = JSNormCache::make_key(*config, ext_script_type, src_ptr, src_end - src_ptr);
+
+        if (const JSNormCache::Entry* entry = cache->find(key))
+        {
+            JSNormModule::increment_peg_counts(PEG_CACHE_HITS);
+            from_cache(*entry, packet);
+            cache = nullptr;
+            more = false;
+        }
+        else
+        {
+            JSNormModule::increment_peg_counts(PEG_CACHE_MISSES);
+
+            for (int i = 0; i < PEG_CACHE_HITS; ++i)
+                pegs[i] = JSNormModule::get_peg_counts((PEG_COUNT)i);
+        }
+    }
+
+    while (more)
     {
         if (idn_ctx == nullptr)
             idn_ctx = new JSIdentifierCtx(config->identifier_depth,
@@ -131,18 +163,56 @@ void JSNorm::normalize(const void* in_data, size_t in_len, const void*& data, si
         src_ptr = next;
 
         alive = alive and post_proc(ret);
+        more = alive and pre_proc();
     }
 
-    if (jsn_ctx != nullptr)
+    if (cache and jsn_ctx)
     {
-        len = jsn_ctx->script_size();
-        data = jsn_ctx->get_script();
+        JSNormCache::Entry entry;
+
+        if (jsn_ctx->script_size())
+            entry.script.assign(jsn_ctx->get_script(), jsn_ctx->script_size());
+
+        entry.events = events.get_raised() & ~raised;
+        entry.bytes = JSNormModule::get_peg_counts(PEG_BYTES) - pegs[PEG_BYTES];
+        entry.identifiers = JSNormModule::get_peg_counts(PEG_IDENTIFIERS) - pegs[PEG_IDENTIFIERS];
+        entry.identifier_overflows = JSNormModule::get_peg_counts(PEG_IDENTIFIER_OVERFLOWS) -
+            pegs[PEG_IDENTIFIER_OVERFLOWS];
+
+        cache->add(key, std::move(entry));
     }
+
+    get_data(data, len);
+
     if (data and len)
         trace_logf(1, js_trace, TRACE_DUMP, packet,
             "js_data[%u]: %.*s\n", (unsigned)len, (int)len, (const char*)data);
 }
 
+void JSNorm::from_cache(const JSNormCache::Entry& entry, const Packet* packet)
+{
+    trace_logf(2, js_trace, TRACE_PROC, packet,
+        "normalized script found in cache\n");
+
+    if (!entry.script.empty())
+    {
+        cached_size = entry.script.size();
+        cached_script = new char[cached_size];
+        memcpy(cached_script, entry.script.data(), cached_size);
+    }
+
+    for (int sid = 1; sid < EVENT__MAX_VALUE; ++sid)
+        if (entry.events[sid-1])
+            events.create_event(sid);
+
+    JSNormModule::increment_peg_counts(PEG_BYTES, entry.bytes);
+    JSNormModule::increment_peg_counts(PEG_IDENTIFIERS, entry.identifiers);
+    JSNormModule::increment_peg_counts(PEG_IDENTIFIER_OVERFLOWS, entry.identifier_overflows);
+
+    // the whole script is done
+    alive = false;
+}
+
 void JSNorm::flush_data(const void*& data, size_t& len)
 {
     if (jsn_ctx != nullptr)
@@ -150,6 +220,13 @@ void JSNorm::flush_data(const void*& data, size_t& len)
         len = jsn_ctx->script_size();
         data = jsn_ctx->take_script();
     }
+    else if (cached_script != nullptr)
+    {
+        len = cached_size;
+        data = cached_script;
+        cached_script = nullptr;
+        cached_size = 0;
+    }
 }
 
 void JSNorm::flush_data()
@@ -158,6 +235,12 @@ void JSNorm::flush_data()
     {
         delete[] jsn_ctx->take_script();
     }
+    else
+    {
+        delete[] cached_script;
+        cached_script = nullptr;
+        cached_size = 0;
+    }
 }
 
 void JSNorm::get_data(const void*& data, size_t& len)
@@ -167,6 +250,11 @@ void JSNorm::get_data(const void*& data, size_t& len)
         len = jsn_ctx->script_size();
         data = jsn_ctx->get_script();
     }
+    else if (cached_script != nullptr)
+    {
+        len = cached_size;
+        data = cached_script;
+    }
 }
 
 bool JSNorm::pre_proc()
@@ -24,6 +24,7 @@
 
 #include "js_config.h"
 #include "js_enum.h"
+#include "js_norm_cache.h"
 
 namespace jsn
 {
@@ -46,7 +47,9 @@ public:
     void tick()
     { ++pdu_cnt; }
 
-    void normalize(const void*, size_t, const void*&, size_t&);
+    // complete means the input is the whole script, so the result can be
+    // cached and reused for the same script
+    void normalize(const void*, size_t, const void*&, size_t&, bool complete = false);
     void get_data(const void*&, size_t&);
     void flush_data(const void*&, size_t&);
     void flush_data();
@@ -58,6 +61,10 @@ protected:
     virtual bool pre_proc();
     virtual bool post_proc(int);
 
+    // whether the output depends only on the script, the config, and the script type
+    virtual bool cacheable() const
+    { return true; }
+
     bool alive;
     uint32_t pdu_cnt;
 
@@ -71,6 +78,13 @@ protected:
     JSEvents events;
     JSNormConfig* config;
     uint32_t generation_id;
+
+private:
+    void from_cache(const jsn::JSNormCache::Entry&, const Packet*);
+
+    // set when the output came from the cache
+    char* cached_script = nullptr;
+    size_t cached_size = 0;
 };
 
 }
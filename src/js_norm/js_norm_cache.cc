@@ -0,0 +1,158 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+// js_norm_cache.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "js_norm_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "main/thread.h"
+
+using namespace jsn;
+using namespace snort;
+
+static THREAD_LOCAL JSNormCache* js_norm_cache = nullptr;
+
+bool JSNormCache::Key::operator==(const Key& k) const
+{
+    return !memcmp(digest, k.digest, sizeof(digest));
+}
+
+size_t JSNormCache::KeyHash::operator()(const Key& k) const
+{
+    size_t h;
+    memcpy(&h, k.digest, sizeof(h));
+    return h;
+}
+
+JSNormCache* JSNormCache::get(size_t memcap)
+{
+    if (!memcap)
+        return nullptr;
+
+    if (!js_norm_cache)
+        js_norm_cache = new JSNormCache(memcap);
+
+    else if (js_norm_cache->get_memcap() != memcap)
+        js_norm_cache->set_memcap(memcap);
+
+    return js_norm_cache;
+}
+
+void JSNormCache::term()
+{
+    delete js_norm_cache;
+    js_norm_cache = nullptr;
+}
+
+static void add_names(std::string& s, const std::unordered_set<std::string>& names)
+{
+    std::vector<std::string> sorted(names.begin(), names.end());
+    std::sort(sorted.begin(), sorted.end());
+
+    s += std::to_string(sorted.size());
+    s += '\0';
+
+    for (const auto& n : sorted)
+    {
+        s += n;
+        s += '\0';
+    }
+}
+
+void JSNormCache::set_config_digest(JSNormConfig& config)
+{
+    std::string s;
+
+    s += std::to_string(config.bytes_depth) + ',';
+    s += std::to_string(config.identifier_depth) + ',';
+    s += std::to_string(config.max_template_nesting) + ',';
+    s += std::to_string(config.max_bracket_depth) + ',';
+    s += std::to_string(config.max_scope_depth) + ',';
+    s += std::to_string(config.pdf_max_dictionary_depth) + ',';
+
+    add_names(s, config.ignored_ids);
+    add_names(s, config.ignored_props);
+
+    sha256((const uint8_t*)s.data(), s.size(), config.digest);
+}
+
+JSNormCache::Key JSNormCache::make_key(const JSNormConfig& config, bool ext_script_type,
+    const uint8_t* src, size_t len)
+{
+    uint8_t buf[2 * SHA256_HASH_SIZE + 1];
+
+    sha256(src, len, buf);
+    memcpy(buf + SHA256_HASH_SIZE, config.digest, SHA256_HASH_SIZE);
+    buf[2 * SHA256_HASH_SIZE] = ext_script_type;
+
+    Key key;
+    sha256(buf, sizeof(buf), key.digest);
+
+    return key;
+}
+
+const JSNormCache::Entry* JSNormCache::find(const Key& key)
+{
+    auto it = map.find(key);
+
+    if (it == map.end())
+        return nullptr;
+
+    list.splice(list.begin(), list, it->second);
+    return &it->second->second;
+}
+
+void JSNormCache::add(const Key& key, Entry&& entry)
+{
+    size_t sz = entry_size(entry);
+
+    // one big bundle shouldn't flush everything else
+    if (sz > memcap / 8 or map.count(key))
+        return;
+
+    list.emplace_front(key, std::move(entry));
+    map[key] = list.begin();
+    size += sz;
+
+    prune();
+}
+
+void JSNormCache::set_memcap(size_t m)
+{
+    memcap = m;
+    prune();
+}
+
+void JSNormCache::prune()
+{
+    while (size > memcap and !list.empty())
+    {
+        auto& last = list.back();
+
+        size -= entry_size(last.second);
+        map.erase(last.first);
+        list.pop_back();
+    }
+}
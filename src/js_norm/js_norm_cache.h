@@ -0,0 +1,113 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+// js_norm_cache.h
+
+#ifndef JS_NORM_CACHE_H
+#define JS_NORM_CACHE_H
+
+// per-thread cache of normalized scripts.
+//
+// the same library scripts are served over and over, and normalizing a
+// whole script always gives the same output for the same config.  so a
+// script that is normalized in one go is remembered by the SHA-256 of its
+// bytes, the config digest, and the script type, along with the events
+// and pegs it produced.  a hit replays those instead of running the
+// tokenizer.  entries are evicted least recently used first to stay
+// within js_norm.cache_memcap.
+
+#include <bitset>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "framework/counts.h"
+#include "hash/hashes.h"
+
+#include "js_config.h"
+#include "js_enum.h"
+
+namespace jsn
+{
+
+class SO_PUBLIC JSNormCache
+{
+public:
+    struct Key
+    {
+        uint8_t digest[SHA256_HASH_SIZE];
+
+        bool operator==(const Key& k) const;
+    };
+
+    struct Entry
+    {
+        std::string script;
+        std::bitset<EVENT__MAX_VALUE> events;
+        PegCount bytes = 0;
+        PegCount identifiers = 0;
+        PegCount identifier_overflows = 0;
+    };
+
+    // the cache of this packet thread, nullptr if memcap is 0
+    static JSNormCache* get(size_t memcap);
+    static void term();
+
+    // sets config.digest, call once the config is complete
+    static void set_config_digest(JSNormConfig&);
+
+    static Key make_key(const JSNormConfig&, bool ext_script_type, const uint8_t* src, size_t len);
+
+    JSNormCache(size_t memcap) : memcap(memcap) { }
+
+    const Entry* find(const Key&);
+    void add(const Key&, Entry&&);
+
+    void set_memcap(size_t);
+
+    size_t get_memcap() const
+    { return memcap; }
+
+    size_t get_size() const
+    { return size; }
+
+    size_t get_count() const
+    { return map.size(); }
+
+private:
+    struct KeyHash
+    {
+        size_t operator()(const Key&) const;
+    };
+
+    using LruList = std::list<std::pair<Key, Entry>>;
+
+    static size_t entry_size(const Entry& e)
+    { return sizeof(LruList::value_type) + 2 * sizeof(Key) + e.script.size(); }
+
+    void prune();
+
+    LruList list;
+    std::unordered_map<Key, LruList::iterator, KeyHash> map;
+    size_t memcap;
+    size_t size = 0;
+};
+
+}
+
+#endif
@@ -27,6 +27,7 @@
 
 #include "js_config.h"
 #include "js_enum.h"
+#include "js_norm_cache.h"
 
 using namespace jsn;
 using namespace snort;
@@ -77,6 +78,9 @@ const Parameter JSNormModule::params[] =
     { "prop_ignore", Parameter::PT_LIST, prop_ignore_param, nullptr,
       "list of JavaScript ignored object properties which will not be normalized" },
 
+    { "cache_memcap", Parameter::PT_INT, "0:maxSZ", "0",
+      "maximum memory in bytes per packet thread for caching normalized scripts (0 disabled)" },
+
     { nullptr, Parameter::PT_MAX, nullptr, nullptr, nullptr }
 };
 
@@ -96,6 +100,8 @@ const PegInfo JSNormModule::peg_names[PEG_COUNT_MAX + 1] =
     { CountType::SUM, "bytes", "total number of bytes processed" },
     { CountType::SUM, "identifiers", "total number of unique identifiers processed" },
     { CountType::SUM, "identifier_overflows", "total number of unique identifier limit overflows" },
+    { CountType::SUM, "cache_hits", "total number of scripts whose normalization was found in cache" },
+    { CountType::SUM, "cache_misses", "total number of cacheable scripts not found in cache" },
     { CountType::END, nullptr, nullptr }
 };
 
@@ -170,6 +176,18 @@ bool JSNormModule::set(const char*, Value& v, SnortConfig*)
     {
         config->pdf_max_dictionary_depth = v.get_uint32();
     }
+    else if (v.is("cache_memcap"))
+    {
+        config->cache_memcap = v.get_size();
+    }
+
+    return true;
+}
+
+bool JSNormModule::end(const char* fqn, int, SnortConfig*)
+{
+    if (!strcmp(s_name, fqn))
+        JSNormCache::set_config_digest(*config);
 
     return true;
 }
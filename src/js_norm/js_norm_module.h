@@ -42,6 +42,7 @@ public:
 
     bool begin(const char*, int, snort::SnortConfig*) override;
     bool set(const char*, snort::Value&, snort::SnortConfig*) override;
+    bool end(const char*, int, snort::SnortConfig*) override;
 
     void set_trace(const snort::Trace*) const override;
     const snort::TraceOption* get_trace_options() const override;
@@ -57,6 +57,10 @@ protected:
     bool pre_proc() override;
     bool post_proc(int) override;
 
+    // scripts are extracted from the document as it goes
+    bool cacheable() const override
+    { return false; }
+
 private:
     char* state_buf = nullptr;
     int state_len = 0;
@@ -90,6 +90,33 @@ TEST_CASE("JSIdentifierCtx::substitute()", "[JSIdentifierCtx]")
         CHECK(ident_ctx.substitute(n[DEPTH].c_str(), false) == nullptr);
         CHECK(ident_ctx.substitute(n[DEPTH + 1].c_str(), false) == nullptr);
     }
+    SECTION("long names")
+    {
+        JSIdentifierCtx ident_ctx(DEPTH, SCOPE_DEPTH, s_ignored_ids, s_ignored_props);
+
+        const std::string a(100000, 'a');
+        const std::string b(100000, 'b');
+
+        CHECK(!strcmp(ident_ctx.substitute(a.c_str(), false), "var_0000"));
+        CHECK(!strcmp(ident_ctx.substitute("c1", false), "var_0001"));
+        CHECK(!strcmp(ident_ctx.substitute(b.c_str(), false), "var_0002"));
+        CHECK(!strcmp(ident_ctx.substitute(a.c_str(), false), "var_0000"));
+        CHECK(!strcmp(ident_ctx.substitute("c1", false), "var_0001"));
+    }
+    SECTION("reset")
+    {
+        JSIdentifierCtx ident_ctx(DEPTH, SCOPE_DEPTH, s_ignored_ids, s_ignored_props);
+
+        CHECK(!strcmp(ident_ctx.substitute("foo", false), "var_0000"));
+        CHECK(!strcmp(ident_ctx.substitute("bar", false), "var_0001"));
+
+        ident_ctx.reset();
+
+        CHECK(!strcmp(ident_ctx.substitute("bar", false), "var_0000"));
+        CHECK(!strcmp(ident_ctx.substitute("foo", false), "var_0001"));
+        CHECK(!strcmp(ident_ctx.substitute("console", false), "console"));
+        CHECK(!strcmp(ident_ctx.substitute("watch", true), "watch"));
+    }
     SECTION("ignored identifier - single char")
     {
         JSIdentifierCtx ident_ctx(DEPTH, SCOPE_DEPTH, s_ignored_ids, s_ignored_props);
@@ -186,6 +213,25 @@ TEST_CASE("JSIdentifierCtx::scopes", "[JSIdentifierCtx]")
 
         CHECK(ident_ctx.alias_lookup("c") == nullptr);
     }
+    SECTION("aliases redefined in scope")
+    {
+        ident_ctx.add_alias("a", "console.log");
+
+        REQUIRE(true == ident_ctx.scope_push(JSProgramScopeType::FUNCTION));
+        ident_ctx.add_alias("a", "document");
+        ident_ctx.add_alias("a", "eval");
+        ident_ctx.add_alias("c", "unescape");
+        CHECK(!strcmp(ident_ctx.alias_lookup("a"), "eval"));
+        CHECK(!strcmp(ident_ctx.alias_lookup("c"), "unescape"));
+
+        REQUIRE(true == ident_ctx.scope_pop(JSProgramScopeType::FUNCTION));
+        CHECK(!strcmp(ident_ctx.alias_lookup("a"), "console.log"));
+        CHECK(ident_ctx.alias_lookup("c") == nullptr);
+
+        ident_ctx.reset();
+        CHECK(ident_ctx.alias_lookup("a") == nullptr);
+        CHECK(true == ident_ctx.scope_check({GLOBAL}));
+    }
     SECTION("scope mismatch")
     {
         CHECK(false == ident_ctx.scope_pop(JSProgramScopeType::FUNCTION));
@@ -0,0 +1,131 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+// js_norm_cache_test.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstring>
+#include <string>
+
+#include "catch/catch.hpp"
+
+#include "js_norm/js_norm_cache.h"
+
+using namespace jsn;
+
+#ifdef CATCH_TEST_BUILD
+
+static JSNormCache::Key make_key(const JSNormConfig& config, const char* s)
+{ return JSNormCache::make_key(config, false, (const uint8_t*)s, strlen(s)); }
+
+TEST_CASE("cache key", "[JSNormCache]")
+{
+    JSNormConfig a;
+    JSNormConfig b;
+
+    JSNormCache::set_config_digest(a);
+    JSNormCache::set_config_digest(b);
+    CHECK(!memcmp(a.digest, b.digest, sizeof(a.digest)));
+
+    auto key = make_key(a, "var a = 1;");
+
+    SECTION("same script and config")
+    {
+        CHECK(key == make_key(b, "var a = 1;"));
+    }
+
+    SECTION("other script")
+    {
+        CHECK(!(key == make_key(a, "var a = 2;")));
+    }
+
+    SECTION("other script type")
+    {
+        CHECK(!(key == JSNormCache::make_key(a, true, (const uint8_t*)"var a = 1;", 10)));
+    }
+
+    SECTION("other config")
+    {
+        b.ignored_ids.insert("console");
+        JSNormCache::set_config_digest(b);
+        CHECK(!(key == make_key(b, "var a = 1;")));
+
+        // memcap doesn't change the output
+        a.cache_memcap = 1000;
+        JSNormCache::set_config_digest(a);
+        CHECK(key == make_key(a, "var a = 1;"));
+    }
+}
+
+TEST_CASE("cache eviction", "[JSNormCache]")
+{
+    JSNormConfig config;
+    JSNormCache::set_config_digest(config);
+
+    JSNormCache::Entry e;
+    e.script = std::string(100, 'x');
+    e.events.set(EVENT_BAD_TOKEN - 1);
+    e.bytes = 10;
+
+    const size_t size = sizeof(std::pair<JSNormCache::Key, JSNormCache::Entry>) +
+        2 * sizeof(JSNormCache::Key) + e.script.size();
+
+    JSNormCache cache(24 * size);
+    auto k1 = make_key(config, "1");
+    auto k2 = make_key(config, "2");
+
+    CHECK(cache.find(k1) == nullptr);
+
+    cache.add(k1, JSNormCache::Entry(e));
+    cache.add(k2, JSNormCache::Entry(e));
+    CHECK(cache.get_count() == 2);
+    CHECK(cache.get_size() == 2 * size);
+
+    const JSNormCache::Entry* hit = cache.find(k1);
+    REQUIRE(hit != nullptr);
+    CHECK(hit->script == e.script);
+    CHECK(hit->events.test(EVENT_BAD_TOKEN - 1));
+    CHECK(hit->bytes == 10);
+
+    // k1 was used last so k2 goes first
+    cache.set_memcap(size);
+    CHECK(cache.get_count() == 1);
+    CHECK(cache.find(k1) != nullptr);
+    CHECK(cache.find(k2) == nullptr);
+
+    // too big for what is left of the memcap
+    cache.add(k2, JSNormCache::Entry(e));
+    CHECK(cache.find(k2) == nullptr);
+}
+
+TEST_CASE("cache per thread", "[JSNormCache]")
+{
+    CHECK(JSNormCache::get(0) == nullptr);
+
+    JSNormCache* cache = JSNormCache::get(1000);
+    REQUIRE(cache != nullptr);
+    CHECK(JSNormCache::get(2000) == cache);
+    CHECK(cache->get_memcap() == 2000);
+
+    JSNormCache::term();
+}
+
+#endif
+
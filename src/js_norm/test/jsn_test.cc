@@ -26,6 +26,7 @@
 #include "catch/catch.hpp"
 
 #include "js_norm/js_norm.h"
+#include "js_norm/js_norm_module.h"
 
 using namespace jsn;
 using namespace snort;
@@ -277,4 +278,77 @@ TEST_CASE("blocking events", "[JSNorm]")
     CHECK(std::string((const char*)dst, dst_len) == exp);
 }
 
+TEST_CASE("cache", "[JSNorm]")
+{
+    JSNormConfig config;
+    config.cache_memcap = 1 << 20;
+    JSNormCache::set_config_digest(config);
+
+    const std::string src = "var a = 1 ; {)";
+    const std::string exp = "var var_0000=1;{";
+
+    const void* dst = nullptr;
+    size_t dst_len = 0;
+
+    const PegCount hits = JSNormModule::get_peg_counts(PEG_CACHE_HITS);
+    const PegCount misses = JSNormModule::get_peg_counts(PEG_CACHE_MISSES);
+    const PegCount bytes = JSNormModule::get_peg_counts(PEG_BYTES);
+
+    SECTION("not complete")
+    {
+        JSNorm jsn(&config);
+        jsn.normalize(src.c_str(), src.size(), dst, dst_len);
+
+        CHECK(std::string((const char*)dst, dst_len) == exp);
+        CHECK(JSNormModule::get_peg_counts(PEG_CACHE_MISSES) == misses);
+    }
+
+    SECTION("hit")
+    {
+        JSNorm jsn_1(&config);
+        jsn_1.normalize(src.c_str(), src.size(), dst, dst_len, true);
+
+        REQUIRE(dst != nullptr);
+        CHECK(std::string((const char*)dst, dst_len) == exp);
+        CHECK(JSNormModule::get_peg_counts(PEG_CACHE_MISSES) == misses + 1);
+
+        const PegCount miss_bytes = JSNormModule::get_peg_counts(PEG_BYTES) - bytes;
+
+        JSNorm jsn_2(&config);
+        jsn_2.normalize(src.c_str(), src.size(), dst, dst_len, true);
+
+        REQUIRE(dst != nullptr);
+        CHECK(std::string((const char*)dst, dst_len) == exp);
+        CHECK(JSNormModule::get_peg_counts(PEG_CACHE_HITS) == hits + 1);
+        CHECK(JSNormModule::get_peg_counts(PEG_BYTES) - bytes == 2 * miss_bytes);
+
+        // the output is handed over like the normalizer's
+        jsn_2.flush_data(dst, dst_len);
+        CHECK(std::string((const char*)dst, dst_len) == exp);
+        delete[] (const char*)dst;
+
+        // the script is done
+        jsn_2.normalize(src.c_str(), src.size(), dst, dst_len, true);
+        CHECK(dst == nullptr);
+    }
+
+    SECTION("other config")
+    {
+        JSNorm jsn_1(&config);
+        jsn_1.normalize(src.c_str(), src.size(), dst, dst_len, true);
+
+        JSNormConfig other = config;
+        other.ignored_ids.insert("a");
+        JSNormCache::set_config_digest(other);
+
+        JSNorm jsn_2(&other);
+        jsn_2.normalize(src.c_str(), src.size(), dst, dst_len, true);
+
+        CHECK(std::string((const char*)dst, dst_len) == "var a=1;{");
+        CHECK(JSNormModule::get_peg_counts(PEG_CACHE_HITS) == hits);
+    }
+
+    JSNormCache::term();
+}
+
 #endif
@@ -37,12 +37,14 @@
 #include "detection/ips_context.h"
 #include "detection/event_trace.h"
 #include "detection/tag.h"
+#include "decompress/file_decomp_pool.h"
 #include "file_api/file_service.h"
 #include "filters/detection_filter.h"
 #include "filters/rate_filter.h"
 #include "filters/sfrf.h"
 #include "filters/sfthreshold.h"
 #include "flow/flow.h"
+#include "flow/flow_cost.h"
 #include "flow/ha.h"
 #include "framework/data_bus.h"
 #include "latency/packet_latency.h"
@@ -387,6 +389,7 @@ void Analyzer::post_process_daq_pkt_msg(Packet* p)
         oops_handler->set_current_message(nullptr, nullptr);
         p->pkth = nullptr;  // No longer avail after finalize_message.
 
+        if ( !Stream::defer_finalize(p, verdict) )
         {
             // cppcheck-suppress unreadVariable
             Profile profile(daqPerfStats);
@@ -408,6 +411,7 @@ void Analyzer::process_daq_pkt_msg(DAQ_Msg_h msg, bool retry)
     const DAQ_PktHdr_t* pkthdr = daq_msg_get_pkthdr(msg);
 
     pc.analyzed_pkts++;
+    TimeProfilerStats::next_packet();
 
     if (!retry)
         packet_time_update(&pkthdr->ts);
@@ -440,7 +444,12 @@ void Analyzer::process_daq_pkt_msg(DAQ_Msg_h msg, bool retry)
 
     PacketManager::decode(p, pkthdr, data, data_len, false, retry);
 
-    if (process_packet(p))
+    bool done = process_packet(p);
+
+    if (p->flow)
+        FlowCost::update(*p->flow);
+
+    if (done)
     {
         post_process_daq_pkt_msg(p);
         switcher->stop();
@@ -655,11 +664,12 @@ void Analyzer::init_unprivileged()
     HighAvailabilityManager::thread_init();
     EventManager::open_outputs();
     FileService::thread_init();
+    File_Decomp_Set_Pool_Memcap(sc->file_decomp_pool_memcap);
     InspectorManager::thread_init();
     PacketTracer::thread_init();
     HostAttributesManager::initialize();
     RuleContext::set_enabled(sc->profiler->rule.show);
-    TimeProfilerStats::set_enabled(sc->profiler->time.show);
+    TimeProfilerStats::set_running(sc->profiler->time.show, sc->profiler->time.sample);
     packet_latency::set_force_enable(sc->latency->packet_latency.enabled() ||
         sc->latency->packet_latency.plugin_forced);
     rule_latency::set_force_enable(sc->latency->rule_latency.enabled());
@@ -677,6 +687,7 @@ void Analyzer::reinit(const SnortConfig* sc)
     PluginManager::thread_reinit(sc);
     Active::thread_init(sc);
     TraceApi::thread_reinit(sc->trace_config);
+    File_Decomp_Set_Pool_Memcap(sc->file_decomp_pool_memcap);
 }
 
 void Analyzer::term()
@@ -725,6 +736,7 @@ void Analyzer::term()
     EventTrace_Term();
     CleanupTag();
     FileService::thread_term();
+    File_Decomp_Pool_Term();
     PacketTracer::thread_term();
     PacketManager::thread_term();
 
@@ -28,6 +28,7 @@
 
 #include "actions/actions_module.h"
 #include "codecs/codec_module.h"
+#include "decompress/file_decomp_pool.h"
 #include "detection/detection_module.h"
 #include "detection/fp_config.h"
 #include "detection/rules.h"
@@ -209,6 +210,9 @@ static const Parameter search_engine_params[] =
     { "queue_limit", Parameter::PT_INT, "0:max32", "0",
       "maximum number of fast pattern matches to queue per packet (0 is unlimited)" },
 
+    { "reload_compile_threads", Parameter::PT_INT, "0:max32", "0",
+      "number of low priority threads compiling search engines on reload (0 compiles on the reload thread)" },
+
     { nullptr, Parameter::PT_MAX, nullptr, nullptr, nullptr }
 };
 
@@ -321,6 +325,57 @@ bool SearchEngineModule::set(const char*, Value& v, SnortConfig* sc)
     else if ( v.is("queue_limit") )
         fp->set_queue_limit(v.get_uint32());
 
+    else if ( v.is("reload_compile_threads") )
+        fp->set_reload_compile_threads(v.get_uint32());
+
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// file decompression module
+//-------------------------------------------------------------------------
+
+static const Parameter file_decomp_params[] =
+{
+    { "pool_memcap", Parameter::PT_INT, "0:maxSZ", "1048576",
+      "maximum bytes of idle decompression streams kept per packet thread" },
+
+    { nullptr, Parameter::PT_MAX, nullptr, nullptr, nullptr }
+};
+
+#define file_decomp_help \
+    "configure the SWF, PDF, and ZIP file decompressors"
+
+static const PegInfo file_decomp_pegs[] =
+{
+    { CountType::SUM, "pool_hits", "decompression streams reused from the pool" },
+    { CountType::SUM, "pool_misses", "decompression streams created because the pool was empty" },
+    { CountType::SUM, "pool_frees", "decompression streams freed because the pool was full" },
+    { CountType::MAX, "pool_max_bytes", "maximum bytes of idle decompression streams in the pool" },
+    { CountType::END, nullptr, nullptr }
+};
+
+class FileDecompModule : public Module
+{
+public:
+    FileDecompModule() : Module("file_decomp", file_decomp_help, file_decomp_params) { }
+    bool set(const char*, Value&, SnortConfig*) override;
+
+    const PegInfo* get_pegs() const override
+    { return file_decomp_pegs; }
+
+    PegCount* get_counts() const override
+    { return (PegCount*)&fd_pool_stats; }
+
+    Usage get_usage() const override
+    { return GLOBAL; }
+};
+
+bool FileDecompModule::set(const char*, Value& v, SnortConfig* sc)
+{
+    if ( v.is("pool_memcap") )
+        sc->file_decomp_pool_memcap = v.get_size();
+
     return true;
 }
 
@@ -2180,6 +2235,7 @@ void add_independent_modules()
     PluginManager::add_module(new ClassificationsModule);
     PluginManager::add_module(new CodecModule);
     PluginManager::add_module(new DetectionModule);
+    PluginManager::add_module(new FileDecompModule);
     PluginManager::add_module(new MemoryModule);
     PluginManager::add_module(new MPDataBusModule);
     PluginManager::add_module(new PacketTracerModule);
@@ -87,3 +87,14 @@ void ReloadTracker::update(const ControlConn* ctrlcon, const char* status)
 #endif
     LogMessage("Reload update: %s [%s]\n", status, current_command.c_str());
 }
+
+void ReloadTracker::progress(const char* status)
+{
+    if (!reload_in_progress)
+        return;
+
+    LogMessage("Reload progress: %s [%s]\n", status, current_command.c_str());
+
+    if (ctrl)
+        ctrl->respond("-- %s\n", status);
+}
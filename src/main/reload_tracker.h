@@ -38,6 +38,9 @@ public:
     static void failed(const ControlConn* ctrlcon, const char* reason);
     static void update(const ControlConn* ctrlcon, const char* status);
 
+    // progress of a reload step, also sent to the control connection
+    static void progress(const char* status);
+
 private:
     static bool reload_in_progress;
     static std::string current_command;
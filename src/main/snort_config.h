@@ -398,6 +398,10 @@ public:
     // paf_max; the HI splitter should pull from there
     unsigned max_pdu = 16384;
 
+    //------------------------------------------------------
+    // file_decomp module stuff
+    size_t file_decomp_pool_memcap = 1048576;
+
     //------------------------------------------------------
     ProfilerConfig* profiler = nullptr;
     ProfilerNodeMap* prof_map = nullptr;
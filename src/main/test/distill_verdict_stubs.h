@@ -22,12 +22,14 @@
 #include "detection/detection_engine.h"
 #include "detection/ips_context.h"
 #include "detection/tag.h"
+#include "decompress/file_decomp_pool.h"
 #include "file_api/file_service.h"
 #include "filters/detection_filter.h"
 #include "filters/rate_filter.h"
 #include "filters/sfrf.h"
 #include "filters/sfthreshold.h"
 #include "flow/flow_control.h"
+#include "flow/flow_cost.h"
 #include "flow/ha.h"
 #include "framework/data_bus.h"
 #include "latency/packet_latency.h"
@@ -76,6 +78,9 @@ THREAD_LOCAL class FlowControl* flow_con;
 void Profiler::start() { }
 void Profiler::stop(uint64_t) { }
 void Profiler::consolidate_stats(snort::ProfilerType) { }
+void snort::TimeProfilerStats::set_running(bool, unsigned) { }
+void snort::TimeProfilerStats::next_packet() { }
+void FlowCost::update(const snort::Flow&) { }
 void Swapper::apply(Analyzer&) { }
 Swapper::~Swapper() = default;
 void OopsHandler::tinit() { }
@@ -98,6 +103,8 @@ void sfthreshold_reset() { }
 void sfthreshold_free() { }
 void EventTrace_Init() { }
 void EventTrace_Term() { }
+void File_Decomp_Set_Pool_Memcap(size_t) { }
+void File_Decomp_Pool_Term() { }
 void detection_filter_init(DetectionFilterConfig*) { }
 void detection_filter_term() { }
 void RuleLatency::tterm() { }
@@ -224,6 +231,7 @@ void ModuleManager::accumulate_module(const char*) { }
 void Stream::handle_timeouts(bool) { }
 void Stream::purge_flows() { }
 bool Stream::set_packet_action_to_hold(Packet*) { return false; }
+bool Stream::defer_finalize(Packet*, DAQ_Verdict) { return false; }
 void Stream::init_active_response(const Packet*, Flow*) { }
 void Stream::drop_flow(const Packet* ) { }
 void Stream::block_flow(const Packet*) { }
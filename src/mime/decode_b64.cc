@@ -24,9 +24,12 @@
 
 #include "decode_b64.h"
 
+#include <algorithm>
+
 #include "utils/util_unfold.h"
 
 #include "decode_buffer.h"
+#include "decode_simd.h"
 
 using namespace snort;
 
@@ -157,6 +160,23 @@ int sf_base64decode(uint8_t* inbuf, uint32_t inbuf_size, uint8_t* outbuf, uint32
     outbuf_ptr = outbuf;
     while ((cursor < endofinbuf) && (n < max_base64_chars))
     {
+        /* Between groups, decode runs of plain base64 a vector at a time */
+        if (base64data_ptr == base64data)
+        {
+            uint32_t used = b64_decode_simd(cursor,
+                std::min<size_t>(endofinbuf - cursor, max_base64_chars - n),
+                outbuf_ptr, outbuf_size - *bytes_written);
+
+            if (used)
+            {
+                cursor += used;
+                n += used;
+                outbuf_ptr += used / 4 * 3;
+                *bytes_written += used / 4 * 3;
+                continue;
+            }
+        }
+
         if (sf_decode64tab[*cursor] != 100)
         {
             *base64data_ptr++ = *cursor;
@@ -24,12 +24,15 @@
 
 #include "decode_qp.h"
 
+#include <algorithm>
 #include <cctype>
 #include <cstdlib>
+#include <cstring>
 
 #include "utils/util_unfold.h"
 
 #include "decode_buffer.h"
+#include "decode_simd.h"
 
 using namespace snort;
 
@@ -110,6 +113,18 @@ int sf_qpdecode(const char* src, uint32_t slen, char* dst, uint32_t dlen, uint32
 
     while ( (*bytes_read < slen) && (*bytes_copied < dlen))
     {
+        // copy runs of plain text a vector at a time
+        uint32_t plain = qp_plain_span((const uint8_t*)src + *bytes_read,
+            std::min(slen - *bytes_read, dlen - *bytes_copied));
+
+        if ( plain )
+        {
+            memcpy(dst + *bytes_copied, src + *bytes_read, plain);
+            *bytes_read += plain;
+            *bytes_copied += plain;
+            continue;
+        }
+
         char ch = src[*bytes_read];
         *bytes_read += 1;
 
@@ -0,0 +1,423 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// decode_simd.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "decode_simd.h"
+
+#include "main/snort_types.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DECODE_X86 1
+#include <immintrin.h>
+#endif
+
+#ifdef UNIT_TEST
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "catch/snort_catch.h"
+
+#include "decode_b64.h"
+#include "decode_qp.h"
+#endif
+
+static DecodeSimd get_cpu_simd()
+{
+#ifdef DECODE_X86
+    __builtin_cpu_init();
+
+    if ( __builtin_cpu_supports("avx2") )
+        return DecodeSimd::AVX2;
+
+    if ( __builtin_cpu_supports("ssse3") )
+        return DecodeSimd::SSSE3;
+#endif
+    return DecodeSimd::NONE;
+}
+
+static const DecodeSimd cpu_simd = get_cpu_simd();
+static DecodeSimd use_simd = cpu_simd;
+
+DecodeSimd get_decode_simd()
+{ return use_simd; }
+
+void set_decode_simd(DecodeSimd s)
+{ use_simd = (s < cpu_simd) ? s : cpu_simd; }
+
+#ifdef DECODE_X86
+
+//-------------------------------------------------------------------------
+// base64
+//
+// each byte is validated and translated to its 6 bit value with nibble
+// lookups, then 4 values are packed into 3 bytes with multiply adds.  see
+// Mula and Lemire, Faster Base64 Encoding and Decoding Using AVX2
+// Instructions.
+//-------------------------------------------------------------------------
+
+__attribute__((target("ssse3")))
+static size_t b64_decode_ssse3(const uint8_t* in, size_t len, uint8_t* out, size_t room)
+{
+    const __m128i lut_lo = _mm_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_hi = _mm_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_2f = _mm_set1_epi8(0x2f);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i pack = _mm_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    size_t used = 0;
+    size_t o = 0;
+
+    while ( len - used >= 16 and room - o >= 16 )
+    {
+        __m128i str = _mm_loadu_si128((const __m128i*)(in + used));
+
+        __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_2f);
+        __m128i lo_nibbles = _mm_and_si128(str, mask_2f);
+        __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+        __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), zero)) != 0xffff )
+            break;
+
+        __m128i eq_2f = _mm_cmpeq_epi8(str, mask_2f);
+        __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+        str = _mm_add_epi8(str, roll);
+
+        str = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+        str = _mm_madd_epi16(str, _mm_set1_epi32(0x00011000));
+        str = _mm_shuffle_epi8(str, pack);
+
+        _mm_storeu_si128((__m128i*)(out + o), str);
+        used += 16;
+        o += 12;
+    }
+    return used;
+}
+
+__attribute__((target("avx2")))
+static size_t b64_decode_avx2(const uint8_t* in, size_t len, uint8_t* out, size_t room)
+{
+    const __m256i lut_lo = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lut_hi = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2f);
+    const __m256i pack = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+
+    size_t used = 0;
+    size_t o = 0;
+
+    while ( len - used >= 32 and room - o >= 32 )
+    {
+        __m256i str = _mm256_loadu_si256((const __m256i*)(in + used));
+
+        __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2f);
+        __m256i lo_nibbles = _mm256_and_si256(str, mask_2f);
+        __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+
+        if ( !_mm256_testz_si256(lo, hi) )
+            break;
+
+        __m256i eq_2f = _mm256_cmpeq_epi8(str, mask_2f);
+        __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+        str = _mm256_add_epi8(str, roll);
+
+        str = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+        str = _mm256_madd_epi16(str, _mm256_set1_epi32(0x00011000));
+        str = _mm256_shuffle_epi8(str, pack);
+        str = _mm256_permutevar8x32_epi32(str, lanes);
+
+        _mm256_storeu_si256((__m256i*)(out + o), str);
+        used += 32;
+        o += 24;
+    }
+
+    // finish with a half vector
+    return used + b64_decode_ssse3(in + used, len - used, out + o, room - o);
+}
+
+//-------------------------------------------------------------------------
+// quoted-printable
+//-------------------------------------------------------------------------
+
+// bytes 0x20-0x7e are plain except '='; signed compares put 0x80-0xff below
+// 0x20 so they are not
+__attribute__((target("ssse3")))
+static size_t qp_plain_ssse3(const uint8_t* in, size_t len)
+{
+    const __m128i below = _mm_set1_epi8(0x1f);
+    const __m128i above = _mm_set1_epi8(0x7f);
+    const __m128i eq = _mm_set1_epi8('=');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+
+    size_t n = 0;
+
+    while ( len - n >= 16 )
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + n));
+
+        __m128i ok = _mm_and_si128(_mm_cmpgt_epi8(v, below), _mm_cmplt_epi8(v, above));
+        ok = _mm_andnot_si128(_mm_cmpeq_epi8(v, eq), ok);
+        ok = _mm_or_si128(ok, _mm_cmpeq_epi8(v, tab));
+        ok = _mm_or_si128(ok, _mm_cmpeq_epi8(v, cr));
+        ok = _mm_or_si128(ok, _mm_cmpeq_epi8(v, lf));
+
+        unsigned bad = ~_mm_movemask_epi8(ok) & 0xffff;
+
+        if ( bad )
+            return n + __builtin_ctz(bad);
+
+        n += 16;
+    }
+    return n;
+}
+
+__attribute__((target("avx2")))
+static size_t qp_plain_avx2(const uint8_t* in, size_t len)
+{
+    const __m256i below = _mm256_set1_epi8(0x1f);
+    const __m256i above = _mm256_set1_epi8(0x7f);
+    const __m256i eq = _mm256_set1_epi8('=');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    size_t n = 0;
+
+    while ( len - n >= 32 )
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(in + n));
+
+        __m256i ok = _mm256_and_si256(_mm256_cmpgt_epi8(v, below), _mm256_cmpgt_epi8(above, v));
+        ok = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, eq), ok);
+        ok = _mm256_or_si256(ok, _mm256_cmpeq_epi8(v, tab));
+        ok = _mm256_or_si256(ok, _mm256_cmpeq_epi8(v, cr));
+        ok = _mm256_or_si256(ok, _mm256_cmpeq_epi8(v, lf));
+
+        uint32_t bad = ~(uint32_t)_mm256_movemask_epi8(ok);
+
+        if ( bad )
+            return n + __builtin_ctz(bad);
+
+        n += 32;
+    }
+    return n + qp_plain_ssse3(in + n, len - n);
+}
+
+#endif
+
+size_t b64_decode_simd(const uint8_t* in, size_t len, uint8_t* out, size_t room)
+{
+#ifdef DECODE_X86
+    switch ( use_simd )
+    {
+    case DecodeSimd::AVX2:
+        return b64_decode_avx2(in, len, out, room);
+    case DecodeSimd::SSSE3:
+        return b64_decode_ssse3(in, len, out, room);
+    default:
+        break;
+    }
+#else
+    UNUSED(in);
+    UNUSED(len);
+    UNUSED(out);
+    UNUSED(room);
+#endif
+    return 0;
+}
+
+size_t qp_plain_span(const uint8_t* in, size_t len)
+{
+#ifdef DECODE_X86
+    switch ( use_simd )
+    {
+    case DecodeSimd::AVX2:
+        return qp_plain_avx2(in, len);
+    case DecodeSimd::SSSE3:
+        return qp_plain_ssse3(in, len);
+    default:
+        break;
+    }
+#else
+    UNUSED(in);
+    UNUSED(len);
+#endif
+    return 0;
+}
+
+//-------------------------------------------------------------------------
+// unit tests
+//-------------------------------------------------------------------------
+
+#ifdef UNIT_TEST
+
+static const char b64_chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// base64 lines with an occasional stray byte and padding at the end
+static std::vector<uint8_t> make_b64(size_t size, unsigned seed, bool junk)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> v;
+
+    while ( v.size() < size )
+    {
+        v.push_back(b64_chars[rng() % 64]);
+
+        if ( junk and !(rng() % 997) )
+            v.push_back("!*\x80\t= "[rng() % 6]);
+    }
+    v.push_back('=');
+    v.push_back('=');
+    return v;
+}
+
+// mostly text with soft line breaks, escapes, and binary bytes
+static std::vector<uint8_t> make_qp(size_t size, unsigned seed)
+{
+    static const char* specials[] = { "=\r\n", "=\n", "=3D", "=0a", "=zz", "\x01", "\xe9", "=" };
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> v;
+
+    while ( v.size() < size )
+    {
+        if ( rng() % 61 )
+            v.push_back(0x20 + rng() % 95);
+        else
+        {
+            const char* s = specials[rng() % 8];
+            v.insert(v.end(), s, s + strlen(s));
+        }
+    }
+    return v;
+}
+
+static std::vector<uint8_t> b64_decode(std::vector<uint8_t>& in, uint32_t room, DecodeSimd s, int& ret)
+{
+    std::vector<uint8_t> out(room);
+    uint32_t n = 0;
+
+    set_decode_simd(s);
+    ret = snort::sf_base64decode(in.data(), in.size(), out.data(), room, &n);
+    set_decode_simd(DecodeSimd::AVX2);
+
+    out.resize(n);
+    return out;
+}
+
+static std::vector<uint8_t> qp_decode(const std::vector<uint8_t>& in, uint32_t room, DecodeSimd s,
+    uint32_t& read)
+{
+    std::vector<uint8_t> out(room);
+    uint32_t n = 0;
+    read = 0;
+
+    set_decode_simd(s);
+    sf_qpdecode((const char*)in.data(), in.size(), (char*)out.data(), room, &read, &n);
+    set_decode_simd(DecodeSimd::AVX2);
+
+    out.resize(n);
+    return out;
+}
+
+TEST_CASE("base64 vector decode matches scalar", "[decode_simd]")
+{
+    for ( unsigned seed = 1; seed <= 40; ++seed )
+    {
+        std::vector<uint8_t> in = make_b64(seed * 37, seed, seed & 1);
+
+        // roomy, tight, and short outputs
+        for ( uint32_t room : { (uint32_t)in.size(), (uint32_t)(in.size() * 3 / 4), 20u, 1u } )
+        {
+            int ret_s, ret_v, ret_a;
+            auto s = b64_decode(in, room, DecodeSimd::NONE, ret_s);
+            auto v = b64_decode(in, room, DecodeSimd::SSSE3, ret_v);
+            auto a = b64_decode(in, room, DecodeSimd::AVX2, ret_a);
+
+            CHECK(ret_s == ret_v);
+            CHECK(ret_s == ret_a);
+            CHECK(s == v);
+            CHECK(s == a);
+        }
+    }
+}
+
+TEST_CASE("base64 vector decode values", "[decode_simd]")
+{
+    std::vector<uint8_t> in((const uint8_t*)"TWFuIGlzIGRpc3Rpbmd1aXNoZWQsIG5vdCBvbmx5IGJ5IGhp",
+        (const uint8_t*)"TWFuIGlzIGRpc3Rpbmd1aXNoZWQsIG5vdCBvbmx5IGJ5IGhp" + 48);
+    std::string plain = "Man is distinguished, not only by hi";
+
+    int ret;
+    auto out = b64_decode(in, 64, DecodeSimd::AVX2, ret);
+
+    CHECK(ret == 0);
+    CHECK(std::string(out.begin(), out.end()) == plain);
+}
+
+TEST_CASE("quoted-printable vector decode matches scalar", "[decode_simd]")
+{
+    for ( unsigned seed = 1; seed <= 40; ++seed )
+    {
+        std::vector<uint8_t> in = make_qp(seed * 53, seed);
+
+        for ( uint32_t room : { (uint32_t)in.size(), (uint32_t)(in.size() / 2), 17u, 1u } )
+        {
+            uint32_t read_s, read_v, read_a;
+            auto s = qp_decode(in, room, DecodeSimd::NONE, read_s);
+            auto v = qp_decode(in, room, DecodeSimd::SSSE3, read_v);
+            auto a = qp_decode(in, room, DecodeSimd::AVX2, read_a);
+
+            CHECK(read_s == read_v);
+            CHECK(read_s == read_a);
+            CHECK(s == v);
+            CHECK(s == a);
+        }
+    }
+}
+
+#endif
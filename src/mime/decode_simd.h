@@ -0,0 +1,53 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// decode_simd.h
+
+#ifndef DECODE_SIMD_H
+#define DECODE_SIMD_H
+
+// vector fast paths for the base64 and quoted-printable decoders.
+//
+// these only handle the common case, long runs of ordinary input, and
+// stop at the first byte that needs the scalar decoder's attention, so
+// the scalar code still decides everything about padding, soft line
+// breaks, escapes, and junk.  the implementation is picked at startup
+// from what the cpu supports (AVX2, SSSE3, or none).
+
+#include <cstddef>
+#include <cstdint>
+
+enum class DecodeSimd { NONE, SSSE3, AVX2 };
+
+DecodeSimd get_decode_simd();
+
+// for tests and benchmarks; capped at what the cpu supports
+void set_decode_simd(DecodeSimd);
+
+// decodes whole vectors of base64 alphabet (no '=' or other bytes) and
+// returns the number of input bytes consumed, a multiple of 16.  the
+// output is consumed * 3 / 4 bytes but whole vectors are stored, so it
+// stops when out has less than a vector of room left.
+size_t b64_decode_simd(const uint8_t* in, size_t len, uint8_t* out, size_t room);
+
+// length of the leading run of bytes that quoted-printable copies as is:
+// printable ascii except '=' plus tab, cr, and lf
+size_t qp_plain_span(const uint8_t* in, size_t len);
+
+#endif
+
@@ -0,0 +1,135 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+// decode_benchmark.cc
+
+#ifdef BENCHMARK_TEST
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "catch/catch.hpp"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "mime/decode_b64.h"
+#include "mime/decode_qp.h"
+#include "mime/decode_simd.h"
+
+static const char b64_chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static std::vector<uint8_t> make_b64(size_t size)
+{
+    std::mt19937 rng(7);
+    std::vector<uint8_t> v;
+
+    while ( v.size() < size )
+        v.push_back(b64_chars[rng() % 64]);
+
+    v.push_back('=');
+    v.push_back('=');
+    return v;
+}
+
+// mostly text with soft line breaks and escapes
+static std::vector<uint8_t> make_qp(size_t size)
+{
+    static const char* specials[] = { "=\r\n", "=3D", "=0A", "\xe9" };
+    std::mt19937 rng(7);
+    std::vector<uint8_t> v;
+
+    while ( v.size() < size )
+    {
+        if ( rng() % 61 )
+            v.push_back(0x20 + rng() % 95);
+        else
+        {
+            const char* s = specials[rng() % 4];
+            v.insert(v.end(), s, s + strlen(s));
+        }
+    }
+    return v;
+}
+
+static size_t b64_decode(std::vector<uint8_t>& in, std::vector<uint8_t>& out, DecodeSimd s)
+{
+    uint32_t n = 0;
+
+    set_decode_simd(s);
+    snort::sf_base64decode(in.data(), in.size(), out.data(), out.size(), &n);
+
+    return n;
+}
+
+static size_t qp_decode(const std::vector<uint8_t>& in, std::vector<uint8_t>& out, DecodeSimd s)
+{
+    uint32_t read = 0;
+    uint32_t n = 0;
+
+    set_decode_simd(s);
+    sf_qpdecode((const char*)in.data(), in.size(), (char*)out.data(), out.size(), &read, &n);
+
+    return n;
+}
+
+TEST_CASE("base64 decode", "[decode_simd]")
+{
+    std::vector<uint8_t> in = make_b64(1 << 20);
+    std::vector<uint8_t> out(in.size());
+
+    BENCHMARK("scalar")
+    {
+        return b64_decode(in, out, DecodeSimd::NONE);
+    };
+    BENCHMARK("ssse3")
+    {
+        return b64_decode(in, out, DecodeSimd::SSSE3);
+    };
+    BENCHMARK("avx2")
+    {
+        return b64_decode(in, out, DecodeSimd::AVX2);
+    };
+
+    set_decode_simd(DecodeSimd::AVX2);
+}
+
+TEST_CASE("quoted-printable decode", "[decode_simd]")
+{
+    std::vector<uint8_t> in = make_qp(1 << 20);
+    std::vector<uint8_t> out(in.size());
+
+    BENCHMARK("scalar")
+    {
+        return qp_decode(in, out, DecodeSimd::NONE);
+    };
+    BENCHMARK("ssse3")
+    {
+        return qp_decode(in, out, DecodeSimd::SSSE3);
+    };
+    BENCHMARK("avx2")
+    {
+        return qp_decode(in, out, DecodeSimd::AVX2);
+    };
+
+    set_decode_simd(DecodeSimd::AVX2);
+}
+
+#endif
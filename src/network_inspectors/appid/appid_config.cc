@@ -276,6 +276,8 @@ void OdpContext::initialize(AppIdInspector& inspector)
     sip_matchers.finalize_patterns(*this);
     host_matchers.finalize_patterns();
     dns_matchers.finalize_patterns();
+    host_port_cache.finalize();
+    first_pkt_cache.finalize();
 }
 
 void OdpContext::reload()
@@ -140,6 +140,9 @@ void AppIdDiscovery::do_application_discovery(Packet* p, AppIdInspector& inspect
     AppidSessionDirection direction = APP_ID_FROM_INITIATOR;
     AppIdSession* asd = (AppIdSession*)p->flow->get_flow_data(AppIdSession::inspector_id);
 
+    if (asd and asd->is_discovery_finished() and do_finished_discovery(p, *asd, odp_ctxt))
+        return;
+
     if (!do_pre_discovery(p, asd, inspector, protocol, outer_protocol, direction, odp_ctxt))
         return;
 
@@ -160,6 +163,8 @@ void AppIdDiscovery::do_application_discovery(Packet* p, AppIdInspector& inspect
     do_post_discovery(p, *asd, is_discovery_done, service_id, client_id, payload_id, misc_id,
         change_bits);
 
+    asd->set_discovery_finished(asd->is_discovery_final());
+
     if (is_appid_cpu_profiling_running)
     {
         per_appid_cpu_timer.stop();
@@ -167,6 +172,40 @@ void AppIdDiscovery::do_application_discovery(Packet* p, AppIdInspector& inspect
     }
 }
 
+static inline AppidSessionDirection get_session_direction(const AppIdSession& asd, const Packet* p)
+{
+    if (asd.initiator_port)
+        return (asd.initiator_port == p->ptrs.sp) ? APP_ID_FROM_INITIATOR : APP_ID_FROM_RESPONDER;
+
+    const SfIp* ip = p->ptrs.ip_api.get_src();
+    return ip->fast_equals_raw(asd.get_initiator_ip()) ? APP_ID_FROM_INITIATOR : APP_ID_FROM_RESPONDER;
+}
+
+static void update_session_stats(const Packet* p, AppIdSession& asd, AppidSessionDirection direction)
+{
+    asd.session_packet_count++;
+    asd.stats.cpu_profiler_pkt_count++;
+
+    if (direction == APP_ID_FROM_INITIATOR)
+    {
+        asd.stats.initiator_bytes += p->pkth->pktlen;
+        if (p->dsize)
+        {
+            asd.init_pkts_without_reply++;
+            asd.init_bytes_without_reply += p->dsize;
+        }
+    }
+    else
+    {
+        asd.stats.responder_bytes += p->pkth->pktlen;
+        if (p->dsize)
+        {
+            asd.init_pkts_without_reply = 0;
+            asd.init_bytes_without_reply = 0;
+        }
+    }
+}
+
 static bool set_network_attributes(AppIdSession* asd, Packet* p, IpProtocol& protocol,
     IpProtocol& outer_protocol, AppidSessionDirection& direction)
 {
@@ -174,16 +213,7 @@ static bool set_network_attributes(AppIdSession* asd, Packet* p, IpProtocol& pro
     {
         protocol = asd->protocol;
         asd->flow = p->flow;
-
-        if (asd->initiator_port)
-            direction = (asd->initiator_port == p->ptrs.sp) ?
-                APP_ID_FROM_INITIATOR : APP_ID_FROM_RESPONDER;
-        else
-        {
-            const SfIp* ip = p->ptrs.ip_api.get_src();
-            direction = ip->fast_equals_raw(asd->get_initiator_ip()) ?
-                APP_ID_FROM_INITIATOR : APP_ID_FROM_RESPONDER;
-        }
+        direction = get_session_direction(*asd, p);
 
         asd->in_expected_cache = false;
     }
@@ -274,27 +304,7 @@ bool AppIdDiscovery::do_pre_discovery(Packet* p, AppIdSession*& asd, AppIdInspec
     // FIXIT-L - from this point on we always have a valid ptr to a Packet
     //           refactor to pass this as ref and delete any checks for null
     appid_stats.processed_packets++;
-    asd->session_packet_count++;
-    asd->stats.cpu_profiler_pkt_count++;
-
-    if (direction == APP_ID_FROM_INITIATOR)
-    {
-        asd->stats.initiator_bytes += p->pkth->pktlen;
-        if (p->dsize)
-        {
-            asd->init_pkts_without_reply++;
-            asd->init_bytes_without_reply += p->dsize;
-        }
-    }
-    else
-    {
-        asd->stats.responder_bytes += p->pkth->pktlen;
-        if (p->dsize)
-        {
-            asd->init_pkts_without_reply = 0;
-            asd->init_bytes_without_reply = 0;
-        }
-    }
+    update_session_stats(p, *asd, direction);
 
     if (!asd->get_session_flags(APPID_SESSION_PAYLOAD_SEEN) and p->dsize)
         asd->set_session_flags(APPID_SESSION_PAYLOAD_SEEN);
@@ -403,6 +413,27 @@ bool AppIdDiscovery::do_pre_discovery(Packet* p, AppIdSession*& asd, AppIdInspec
     return true;
 }
 
+// Return false if the flow must go back through discovery
+bool AppIdDiscovery::do_finished_discovery(Packet* p, AppIdSession& asd, OdpContext& odp_ctxt)
+{
+    if (asd.get_odp_ctxt_version() != odp_ctxt.get_version() or asd.has_pending_discovery(*p))
+    {
+        asd.set_discovery_finished(false);
+        return false;
+    }
+
+    // retransmits may still have to publish the first event, let the regular path decide
+    if (p->is_retry())
+        return false;
+
+    if (is_packet_ignored(p))
+        return true;
+
+    update_session_stats(p, asd, get_session_direction(asd, p));
+    appid_stats.bypassed_packets++;
+    return true;
+}
+
 void AppIdDiscovery::do_port_based_discovery(Packet* p, AppIdSession& asd, IpProtocol protocol,
     AppidSessionDirection direction)
 {
@@ -151,6 +151,7 @@ protected:
     std::vector<AppIdPatternMatchNode*> pattern_data;
 
 private:
+    static bool do_finished_discovery(snort::Packet* p, AppIdSession& asd, OdpContext& odp_ctxt);
     static bool do_pre_discovery(snort::Packet* p, AppIdSession*& asd, AppIdInspector& inspector,
         IpProtocol& protocol, IpProtocol& outer_protocol, AppidSessionDirection& direction,
         OdpContext& odp_ctxt);
@@ -29,6 +29,7 @@
 #include <sys/resource.h>
 
 #include "flow/flow.h"
+#include "flow/flow_cost.h"
 #include "main/analyzer_command.h"
 #include "main/snort_config.h"
 #include "managers/module_manager.h"
@@ -286,16 +287,23 @@ static void mod_dtor(Module* m)
     delete m;
 }
 
+static const char* flow_cost_label(const Flow& flow)
+{
+    return appid_api.get_application_name(flow, true);
+}
+
 static void appid_inspector_pinit()
 {
     AppIdSession::init();
     SshEventFlowData::init();
     TPLibHandler::get();
     AppIdPegCounts::init_peg_info();
+    FlowCost::set_label(flow_cost_label);
 }
 
 static void appid_inspector_pterm()
 {
+    FlowCost::set_label(nullptr);
     AppIdContext::pterm();
     TPLibHandler::pfini();
     AppIdPegCounts::cleanup_peg_info();
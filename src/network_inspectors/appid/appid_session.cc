@@ -1275,6 +1275,39 @@ bool AppIdSession::is_tp_processing_done() const
     return true;
 }
 
+// Scan flags that only mark a one time lookup as done rather than metadata to process
+#define SCAN_DONE_FLAGS (SCAN_HOST_PORT_FLAG | SCAN_CERTVIZ_ENABLED_FLAG)
+
+bool AppIdSession::is_discovery_final() const
+{
+    if (!api.flags.finished or api.is_appid_inspecting_session())
+        return false;
+
+    if (service_disco_state != APPID_DISCO_STATE_FINISHED or
+        client_disco_state != APPID_DISCO_STATE_FINISHED or
+        !is_tp_processing_done())
+        return false;
+
+    if (get_session_flags(APPID_SESSION_HTTP_SESSION | APPID_SESSION_CONTINUE |
+        APPID_SESSION_CHP_INSPECTING | APPID_SESSION_ENCRYPTED | APPID_SESSION_OOO_CHECK_TP |
+        APPID_SESSION_WAIT_FOR_EXTERNAL | APPID_SESSION_DO_NOT_DECRYPT))
+        return false;
+
+    return !(scan_flags & ~SCAN_DONE_FLAGS);
+}
+
+bool AppIdSession::has_pending_discovery(const Packet& p) const
+{
+    if (scan_flags & ~SCAN_DONE_FLAGS)
+        return true;
+
+    // decryption started, detection restarts on the decrypted data
+    if (p.flow->is_proxied() and !get_session_flags(APPID_SESSION_DECRYPTED))
+        return true;
+
+    return false;
+}
+
 bool AppIdSession::is_tp_appid_available() const
 {
     if (tp_appid_ctxt)
@@ -1436,6 +1469,9 @@ void AppIdSession::publish_appid_event(AppidChangeBits& change_bits, const Packe
     else if (change_bits.none())
         return;
 
+    // appids changed, e.g. from an http2 or ssl event, go back through discovery
+    discovery_finished = false;
+
     if (tsession and change_bits.test(APPID_TLSHOST_BIT))
     {
         tsession->set_tls_host_published(true);
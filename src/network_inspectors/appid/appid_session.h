@@ -798,6 +798,21 @@ public:
         return appid_previous_shadow_traffic_bits;
     }
 
+    // Flows whose service, client and payload are final skip discovery until
+    // an appid change or new metadata reopens the session
+    bool is_discovery_finished() const
+    {
+        return discovery_finished;
+    }
+
+    void set_discovery_finished(bool val)
+    {
+        discovery_finished = val;
+    }
+
+    bool is_discovery_final() const;
+    bool has_pending_discovery(const snort::Packet&) const;
+
 private:
     uint16_t prev_httpx_raw_packet = 0;
 
@@ -821,6 +836,7 @@ private:
     bool no_service_candidate = false;
     bool no_service_inspector = false;
     bool client_info_unpublished = false;
+    bool discovery_finished = false;
     string ssl_cert_key;
     uint32_t appid_shadow_traffic_bits = 0;
     uint32_t appid_previous_shadow_traffic_bits = 0;
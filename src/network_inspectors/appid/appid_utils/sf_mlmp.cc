@@ -23,7 +23,13 @@
 #include "config.h"
 #endif
 
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "sf_mlmp.h"
 
@@ -48,8 +54,14 @@ struct tPatternNode
     uint32_t patternId;
 
     tPatternNode* nextPattern;
+
+    /*level tag: tree holding this pattern, used to filter shared automaton matches */
+    const tMlmpTree* owner;
 };
 
+/*Nodes holding one distinct pattern of a single automaton tree, sorted by owner. */
+typedef std::vector<tPatternNode*> tSharedPatternNodes;
+
 struct tPatternPrimaryNode
 {
     tPatternNode patternNode;
@@ -66,6 +78,12 @@ struct tMlmpTree
     SearchTool* patternTree;
     tPatternPrimaryNode* patternList;
     uint32_t level;
+
+    /*patterns of all levels are in the root patternTree; set only in root */
+    bool single_automaton;
+
+    /*distinct patterns of the shared patternTree; set only in a single automaton root */
+    std::unordered_map<std::string, tSharedPatternNodes>* sharedPatterns;
 };
 
 /*Used to track matched patterns. */
@@ -77,8 +95,32 @@ struct tMatchedPatternList
     tMatchedPatternList* next;
 };
 
+/*Search state passed to sharedPatternMatcherCallback. */
+struct tMatchState
+{
+    tMatchedPatternList* matchList;
+
+    /*tree whose patterns are accepted */
+    const tMlmpTree* owner;
+};
+
+/*Orders shared pattern nodes by owner and finds the nodes of one owner. */
+struct tOwnerLess
+{
+    bool operator()(const tPatternNode* n1, const tPatternNode* n2) const
+    { return std::less<const tMlmpTree*>()(n1->owner, n2->owner); }
+
+    bool operator()(const tPatternNode* n, const tMlmpTree* t) const
+    { return std::less<const tMlmpTree*>()(n->owner, t); }
+
+    bool operator()(const tMlmpTree* t, const tPatternNode* n) const
+    { return std::less<const tMlmpTree*>()(t, n->owner); }
+};
+
 static int compareMlmpPatterns(const void* p1, const void* p2);
 static int createTreesRecursively(tMlmpTree* root);
+static void addTreesToAutomaton(tMlmpTree* root,
+    std::unordered_map<std::string, tSharedPatternNodes>& sharedPatterns);
 static void destroyTreesRecursively(tMlmpTree* root);
 static int addPatternRecursively(tMlmpTree* root, const tMlmpPattern* inputPatternList,
     void* metaData, uint32_t level);
@@ -87,16 +129,19 @@ static tPatternNode* urlPatternSelector(const tMatchedPatternList* matchList, co
 static tPatternNode* genericPatternSelector(const tMatchedPatternList* matchList, const
     uint8_t* payload);
 static void* mlmpMatchPatternCustom(tMlmpTree* root, tMlmpPattern* inputPatternList,
-    tPatternNode* (*callback)(const tMatchedPatternList*, const uint8_t*));
+    tPatternNode* (*callback)(const tMatchedPatternList*, const uint8_t*), SearchTool* automaton);
 static int patternMatcherCallback(void* id, void* unused_tree, int match_end_pos, void* data,
     void* unused_neg);
+static int sharedPatternMatcherCallback(void* id, void* unused_tree, int match_end_pos,
+    void* data, void* unused_neg);
 
 static uint32_t gPatternId = 1;
 
-tMlmpTree* mlmpCreate()
+tMlmpTree* mlmpCreate(bool single_automaton)
 {
     tMlmpTree* root = (tMlmpTree*)snort_calloc(sizeof(tMlmpTree));
     root->level = 0;
+    root->single_automaton = single_automaton;
     return root;
 }
 
@@ -110,6 +155,27 @@ int mlmpProcessPatterns(tMlmpTree* root)
 {
     int rvalue;
 
+    if (root->single_automaton)
+    {
+        root->sharedPatterns = new std::unordered_map<std::string, tSharedPatternNodes>;
+        addTreesToAutomaton(root, *root->sharedPatterns);
+
+        /*each distinct pattern is added once and resolved to its nodes on match */
+        root->patternTree = new SearchTool;
+
+        for (auto& shared : *root->sharedPatterns)
+        {
+            tSharedPatternNodes& nodes = shared.second;
+            const tMlmpPattern& pattern = nodes.front()->pattern;
+
+            std::sort(nodes.begin(), nodes.end(), tOwnerLess());
+            root->patternTree->add(pattern.pattern, pattern.patternSize, &nodes, true,
+                pattern.is_literal);
+        }
+        root->patternTree->prep();
+        return 0;
+    }
+
     rvalue = createTreesRecursively(root);
     if (rvalue)
         destroyTreesRecursively(root);
@@ -124,12 +190,14 @@ void mlmp_reload_patterns(tMlmpTree& root)
 
 void* mlmpMatchPatternUrl(tMlmpTree* root, tMlmpPattern* inputPatternList)
 {
-    return mlmpMatchPatternCustom(root, inputPatternList, urlPatternSelector);
+    return mlmpMatchPatternCustom(root, inputPatternList, urlPatternSelector,
+        root and root->single_automaton ? root->patternTree : nullptr);
 }
 
 void* mlmpMatchPatternGeneric(tMlmpTree* root, tMlmpPattern* inputPatternList)
 {
-    return mlmpMatchPatternCustom(root, inputPatternList, genericPatternSelector);
+    return mlmpMatchPatternCustom(root, inputPatternList, genericPatternSelector,
+        root and root->single_automaton ? root->patternTree : nullptr);
 }
 
 static inline bool match_is_domain_pattern(const tMatchedPatternList* mp, const uint8_t* payload)
@@ -142,8 +210,9 @@ static inline bool match_is_domain_pattern(const tMatchedPatternList* mp, const
            payload[mp->match_start_pos-1] == '.';
 }
 
+/*automaton is the shared search tool of a single automaton tree; nullptr otherwise */
 static void* mlmpMatchPatternCustom(tMlmpTree* rootNode, tMlmpPattern* inputPatternList,
-    tPatternNode* (*callback)(const tMatchedPatternList*, const uint8_t*))
+    tPatternNode* (*callback)(const tMatchedPatternList*, const uint8_t*), SearchTool* automaton)
 {
     tMatchedPatternList* mp = nullptr;
     void* data = nullptr;
@@ -154,9 +223,20 @@ static void* mlmpMatchPatternCustom(tMlmpTree* rootNode, tMlmpPattern* inputPatt
     if (!rootNode || !pattern || !pattern->pattern)
         return nullptr;
 
-    rootNode->patternTree->find_all((const char*)pattern->pattern, pattern->patternSize,
-        patternMatcherCallback, false, (void*)&mp);
+    if (automaton)
+    {
+        tMatchState state = { nullptr, rootNode };
+
+        automaton->find_all((const char*)pattern->pattern, pattern->patternSize,
+            sharedPatternMatcherCallback, false, (void*)&state);
 
+        mp = state.matchList;
+    }
+    else
+    {
+        rootNode->patternTree->find_all((const char*)pattern->pattern, pattern->patternSize,
+            patternMatcherCallback, false, (void*)&mp);
+    }
     primaryNode = (tPatternPrimaryNode*)callback(mp, pattern->pattern);
 
     while (mp)
@@ -170,7 +250,7 @@ static void* mlmpMatchPatternCustom(tMlmpTree* rootNode, tMlmpPattern* inputPatt
     {
         data = primaryNode->patternNode.userData;
         tmpData = mlmpMatchPatternCustom(primaryNode->nextLevelMatcher, ++inputPatternList,
-            callback);
+            callback, automaton);
         if (tmpData)
             data = tmpData;
     }
@@ -240,6 +320,39 @@ static int createTreesRecursively(tMlmpTree* rootNode)
     return 0;
 }
 
+/*key of a distinct pattern in the shared automaton. Patterns are added case insensitive,
+  so literals differing only in case are the same pattern. */
+static std::string sharedPatternKey(const tMlmpPattern& pattern)
+{
+    std::string key(1, pattern.is_literal ? 'l' : 'r');
+    key.append((const char*)pattern.pattern, pattern.patternSize);
+
+    if (pattern.is_literal)
+        std::transform(key.begin() + 1, key.end(), key.begin() + 1, ::tolower);
+
+    return key;
+}
+
+/*collects patterns of all levels for one automaton; nodes keep their owner as level tag */
+static void addTreesToAutomaton(tMlmpTree* rootNode,
+    std::unordered_map<std::string, tSharedPatternNodes>& sharedPatterns)
+{
+    for (tPatternPrimaryNode* primaryPatternNode = rootNode->patternList;
+        primaryPatternNode;
+        primaryPatternNode = primaryPatternNode->nextPrimaryNode)
+    {
+        if (primaryPatternNode->nextLevelMatcher)
+            addTreesToAutomaton(primaryPatternNode->nextLevelMatcher, sharedPatterns);
+
+        for (tPatternNode* ddPatternNode = &primaryPatternNode->patternNode;
+            ddPatternNode;
+            ddPatternNode = ddPatternNode->nextPattern)
+        {
+            sharedPatterns[sharedPatternKey(ddPatternNode->pattern)].emplace_back(ddPatternNode);
+        }
+    }
+}
+
 static void destroyTreesRecursively(tMlmpTree* rootNode)
 {
     tPatternPrimaryNode* primaryPatternNode;
@@ -267,6 +380,7 @@ static void destroyTreesRecursively(tMlmpTree* rootNode)
     }
 
     delete rootNode->patternTree;
+    delete rootNode->sharedPatterns;
     snort_free(rootNode);
 }
 
@@ -350,10 +464,9 @@ static tPatternNode* genericPatternSelector(const tMatchedPatternList* patternMa
     return patternSelector (patternMatchList, payload, false);
 }
 
-static int patternMatcherCallback(void* id, void*, int match_end_pos, void* data, void*)
+static void addMatchedPattern(tMatchedPatternList** matchList, tPatternNode* target,
+    int match_end_pos)
 {
-    tPatternNode* target = (tPatternNode*)id;
-    tMatchedPatternList** matchList = (tMatchedPatternList**)data;
     tMatchedPatternList* prevNode;
     tMatchedPatternList* tmpList;
     tMatchedPatternList* newNode;
@@ -368,7 +481,7 @@ static int patternMatcherCallback(void* id, void*, int match_end_pos, void* data
         if (cmp > 0 )
             continue;
         if (cmp == 0)
-            return 0;
+            return;
         break;
     }
 
@@ -387,6 +500,24 @@ static int patternMatcherCallback(void* id, void*, int match_end_pos, void* data
         newNode->next = prevNode->next;
         prevNode->next = newNode;
     }
+}
+
+static int patternMatcherCallback(void* id, void*, int match_end_pos, void* data, void*)
+{
+    addMatchedPattern((tMatchedPatternList**)data, (tPatternNode*)id, match_end_pos);
+    return 0;
+}
+
+static int sharedPatternMatcherCallback(void* id, void*, int match_end_pos, void* data, void*)
+{
+    const tSharedPatternNodes* nodes = (const tSharedPatternNodes*)id;
+    tMatchState* state = (tMatchState*)data;
+
+    /*shared automaton reports patterns of all levels and subtrees; take those of this tree */
+    auto range = std::equal_range(nodes->begin(), nodes->end(), state->owner, tOwnerLess());
+
+    for (auto it = range.first; it != range.second; ++it)
+        addMatchedPattern(&state->matchList, *it, match_end_pos);
 
     return 0;
 }
@@ -492,6 +623,7 @@ static int addPatternRecursively(tMlmpTree* rootNode, const tMlmpPattern* inputP
         tmpPrimaryNode->patternNode.partNum = 1;
         tmpPrimaryNode->patternNode.partTotal = partTotal;
         tmpPrimaryNode->patternNode.patternId = patternId;
+        tmpPrimaryNode->patternNode.owner = rootNode;
 
         if (prevPrimaryPatternNode)
         {
@@ -520,6 +652,7 @@ static int addPatternRecursively(tMlmpTree* rootNode, const tMlmpPattern* inputP
             newNode->partNum = partNum;
             newNode->partTotal = partTotal;
             newNode->patternId = patternId;
+            newNode->owner = rootNode;
             if (partNum < partTotal)
                 newNode->nextPattern = newNode+1;
             else
@@ -46,7 +46,11 @@ struct tMlmpPattern
 
 struct tMlmpTree;
 
-tMlmpTree* mlmpCreate();
+// With single_automaton, patterns of every level are compiled into one search
+// tool shared by the whole tree instead of one search tool per matched node.
+// Each distinct pattern is added once with the nodes holding it, so a match is
+// resolved to the nodes of the level being searched with a lookup.
+tMlmpTree* mlmpCreate(bool single_automaton = false);
 int mlmpAddPattern(tMlmpTree*, const tMlmpPattern*, void* metaData);
 int mlmpProcessPatterns(tMlmpTree*);
 void mlmp_reload_patterns(tMlmpTree&);
@@ -0,0 +1,138 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+// sf_mlmp_benchmark.cc
+
+#ifdef BENCHMARK_TEST
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "catch/catch.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "network_inspectors/appid/appid_utils/sf_mlmp.h"
+#include "search_engines/test/mpse_test_stubs.h"
+#include "utils/util.h"
+
+const snort::MpseApi* get_test_api()
+{ return (const snort::MpseApi*)se_ac_full; }
+
+// host/path shape of the ODP url patterns: many hosts, most with a handful of
+// paths, a few shared suffix domains and the ubiquitous "/" path
+static const unsigned bench_hosts = 4000;
+static const unsigned bench_paths = 4;
+
+static const uint8_t* bench_dup(const std::string& s)
+{
+    uint8_t* p = (uint8_t*)snort_alloc(s.size() + 1);
+    memcpy(p, s.c_str(), s.size() + 1);
+    return p;
+}
+
+static tMlmpTree* bench_create(bool single_automaton, std::vector<unsigned>& data)
+{
+    tMlmpTree* tree = mlmpCreate(single_automaton);
+    data.resize(bench_hosts * (bench_paths + 1));
+
+    for (unsigned h = 0; h < bench_hosts; ++h)
+    {
+        std::string host = "host" + std::to_string(h) + (h % 3 ? ".example.com" : ".cdn.net");
+
+        for (unsigned p = 0; p <= bench_paths; ++p)
+        {
+            std::string path = p ? "/app" + std::to_string(p) + "/" : "/";
+            tMlmpPattern patterns[3] = { };
+
+            patterns[0] = { bench_dup(host), host.size(), 0, true };
+            patterns[1] = { bench_dup(path), path.size(), 1, true };
+            patterns[2].pattern = nullptr;
+
+            mlmpAddPattern(tree, patterns, &data[h * (bench_paths + 1) + p]);
+        }
+    }
+    mlmpProcessPatterns(tree);
+    return tree;
+}
+
+static void* bench_match(tMlmpTree* tree, const char* host, const char* path)
+{
+    tMlmpPattern patterns[3] = { };
+    patterns[0] = { (const uint8_t*)host, strlen(host), 0, true };
+    patterns[1] = { (const uint8_t*)path, strlen(path), 1, true };
+    patterns[2].pattern = nullptr;
+    return mlmpMatchPatternUrl(tree, patterns);
+}
+
+TEST_CASE("mlmp url tree vs single automaton", "[mlmp]")
+{
+    std::vector<unsigned> tree_data;
+    std::vector<unsigned> flat_data;
+    tMlmpTree* tree = nullptr;
+    tMlmpTree* flat = nullptr;
+
+    BENCHMARK("build per level tree")
+    {
+        mlmpDestroy(tree);
+        tree = bench_create(false, tree_data);
+        return tree;
+    };
+
+    BENCHMARK("build single automaton")
+    {
+        mlmpDestroy(flat);
+        flat = bench_create(true, flat_data);
+        return flat;
+    };
+
+    const char* host = "www.host1234.example.com";
+    const char* path = "/app3/index.html?q=1";
+
+    REQUIRE(bench_match(tree, host, path) == &tree_data[1234 * (bench_paths + 1) + 3]);
+    REQUIRE(bench_match(flat, host, path) == &flat_data[1234 * (bench_paths + 1) + 3]);
+    REQUIRE(bench_match(flat, "www.host99.cdn.net", "/other") == &flat_data[99 * (bench_paths + 1)]);
+    REQUIRE(bench_match(flat, "unknown.org", "/app1/") == nullptr);
+
+    BENCHMARK("match per level tree")
+    {
+        return bench_match(tree, host, path);
+    };
+
+    BENCHMARK("match single automaton")
+    {
+        return bench_match(flat, host, path);
+    };
+
+    BENCHMARK("miss per level tree")
+    {
+        return bench_match(tree, "unknown.org", "/app1/");
+    };
+
+    BENCHMARK("miss single automaton")
+    {
+        return bench_match(flat, "unknown.org", "/app1/");
+    };
+
+    mlmpDestroy(tree);
+    mlmpDestroy(flat);
+}
+
+#endif
@@ -0,0 +1,128 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+// sf_mlmp_test.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "catch/catch.hpp"
+
+#include <cstring>
+#include <string>
+
+#include "network_inspectors/appid/appid_utils/sf_mlmp.h"
+#include "search_engines/test/mpse_test_stubs.h"
+#include "utils/util.h"
+
+#ifdef CATCH_TEST_BUILD
+
+const snort::MpseApi* get_test_api()
+{ return (const snort::MpseApi*)se_ac_full; }
+
+struct TestPattern
+{
+    const char* host;
+    const char* path;
+    int data;
+};
+
+// "/" and "/a/" are under several hosts, "cdn.net" is also a path
+static const TestPattern test_patterns[] =
+{
+    { "example.com", "/", 1 },
+    { "example.com", "/a/", 2 },
+    { "example.com", "/a/b/", 3 },
+    { "cdn.net", "/", 4 },
+    { "cdn.net", "/a/", 5 },
+    { "Mixed.org", "/cdn.net", 6 },
+    { "other.org", "/A/", 7 },
+};
+
+static const uint8_t* dup(const char* s)
+{
+    uint8_t* p = (uint8_t*)snort_alloc(strlen(s) + 1);
+    memcpy(p, s, strlen(s) + 1);
+    return p;
+}
+
+static tMlmpTree* create(bool single_automaton)
+{
+    tMlmpTree* tree = mlmpCreate(single_automaton);
+
+    for ( const auto& tp : test_patterns )
+    {
+        tMlmpPattern patterns[3] = { };
+        patterns[0] = { dup(tp.host), strlen(tp.host), 0, true };
+        patterns[1] = { dup(tp.path), strlen(tp.path), 1, true };
+
+        REQUIRE(mlmpAddPattern(tree, patterns, (void*)&tp.data) == 0);
+    }
+    REQUIRE(mlmpProcessPatterns(tree) == 0);
+    return tree;
+}
+
+static int match(tMlmpTree* tree, const char* host, const char* path)
+{
+    tMlmpPattern patterns[3] = { };
+    patterns[0] = { (const uint8_t*)host, strlen(host), 0, true };
+    patterns[1] = { (const uint8_t*)path, strlen(path), 1, true };
+
+    void* data = mlmpMatchPatternUrl(tree, patterns);
+    return data ? *(int*)data : 0;
+}
+
+TEST_CASE("single automaton matches like the per level tree", "[mlmp]")
+{
+    tMlmpTree* tree = create(false);
+    tMlmpTree* flat = create(true);
+
+    const struct
+    {
+        const char* host;
+        const char* path;
+        int data;
+    } lookups[] =
+    {
+        { "www.example.com", "/", 1 },
+        { "www.example.com", "/a/b/c.html", 3 },
+        { "www.example.com", "/x/a/", 2 },
+        { "img.cdn.net", "/a/index.html", 5 },
+        { "img.cdn.net", "/z", 4 },
+        { "www.MIXED.org", "/cdn.net", 6 },
+        // "/" belongs to other hosts and "cdn.net" is a path here
+        { "www.mixed.org", "/", 0 },
+        { "www.mixed.org", "/cdn.net.html", 6 },
+        { "www.other.org", "/a/", 7 },
+        { "unknown.org", "/a/", 0 },
+    };
+
+    for ( const auto& l : lookups )
+    {
+        CAPTURE(l.host);
+        CAPTURE(l.path);
+        CHECK(match(tree, l.host, l.path) == l.data);
+        CHECK(match(flat, l.host, l.path) == l.data);
+    }
+
+    mlmpDestroy(tree);
+    mlmpDestroy(flat);
+}
+
+#endif
+
@@ -647,11 +647,12 @@ static int http_pattern_match(void* id, void*, int match_end_pos, void* data, vo
 
 int HttpPatternMatchers::process_host_patterns(const DetectorHTTPPatterns& patterns, OdpContext& ctxt)
 {
+    // one automaton for all hosts and their paths rather than one per matched host
     if (!host_url_matcher)
-        host_url_matcher = mlmpCreate();
+        host_url_matcher = mlmpCreate(true);
 
     if (!rtmp_host_url_matcher)
-        rtmp_host_url_matcher = mlmpCreate();
+        rtmp_host_url_matcher = mlmpCreate(true);
 
     for (const auto& pat : patterns)
     {
@@ -23,10 +23,10 @@
 #include "config.h"
 #endif
 
-#include <map>
-
 #include "host_port_app_cache.h"
 
+#include <algorithm>
+
 #include "log/messages.h"
 #include "managers/inspector_manager.h"
 
@@ -103,6 +103,30 @@ inline bool check_ip_range(const SfIp& max, const SfIp& min, const SfIp& ip, con
     return false;
 }
 
+template<typename Key, typename Val>
+static Val* find_in_table(std::vector<std::pair<Key, Val>>& table, const Key& key)
+{
+    auto it = std::lower_bound(table.begin(), table.end(), key,
+        [](const std::pair<Key, Val>& entry, const Key& k) { return entry.first < k; });
+
+    if (it != table.end() and !(key < it->first))
+        return &it->second;
+
+    return nullptr;
+}
+
+template<typename Key, typename Val>
+static void insert_in_table(std::vector<std::pair<Key, Val>>& table, const Key& key, const Val& val)
+{
+    auto it = std::lower_bound(table.begin(), table.end(), key,
+        [](const std::pair<Key, Val>& entry, const Key& k) { return entry.first < k; });
+
+    if (it != table.end() and !(key < it->first))
+        it->second = val;
+    else
+        table.emplace(it, key, val);
+}
+
 HostPortVal* HostPortCache::find(const SfIp* ip, uint16_t port, IpProtocol protocol,
     const OdpContext& odp_ctxt)
 {
@@ -112,6 +136,9 @@ HostPortVal* HostPortCache::find(const SfIp* ip, uint16_t port, IpProtocol proto
     hk.port = (odp_ctxt.allow_port_wildcard_host_cache)? 0 : port;
     hk.proto = protocol;
 
+    if (finalized)
+        return find_in_table(host_port_table, hk);
+
     std::map<HostPortKey, HostPortVal>::iterator it;
     it = cache.find(hk);
     if (it != cache.end())
@@ -120,6 +147,14 @@ HostPortVal* HostPortCache::find(const SfIp* ip, uint16_t port, IpProtocol proto
         return nullptr;
 }
 
+void HostPortCache::add_host_port(const HostPortKey& hk, const HostPortVal& hv)
+{
+    if (finalized)
+        insert_in_table(host_port_table, hk, hv);
+    else
+        cache[ hk ] = hv;
+}
+
 bool HostPortCache::add(const SnortConfig*, const SfIp* ip, uint16_t port, IpProtocol proto,
     unsigned type, AppId appId)
 {
@@ -137,7 +172,7 @@ bool HostPortCache::add(const SnortConfig*, const SfIp* ip, uint16_t port, IpPro
     hv.appId = appId;
     hv.type = type;
 
-    cache[ hk ] = hv;
+    add_host_port(hk, hv);
 
     return true;
 }
@@ -147,6 +182,33 @@ const HostAppIdsVal* HostPortCache::find_on_first_pkt(const SfIp* ip, uint16_t p
 {
     uint16_t lookup_port = (odp_ctxt.allow_port_wildcard_firstpkt_cache)? 0 : port;
 
+    if (finalized)
+    {
+        if (!first_ip_table.empty())
+        {
+            HostPortKey hk;
+
+            hk.ip = *ip;
+            hk.port = lookup_port;
+            hk.proto = protocol;
+
+            const HostAppIdsVal* hv = find_in_table(first_ip_table, hk);
+            if (hv)
+                return hv;
+        }
+
+        for (const auto& entry : first_subnet_table)
+        {
+            if (entry.first.port == lookup_port and entry.first.proto == protocol and
+                check_ip_range(entry.first.max_network_range, entry.first.network_address, *ip, &entry.first.netmask[0]))
+            {
+                return &entry.second;
+            }
+        }
+
+        return nullptr;
+    }
+
     if (!cache_first_ip.empty())
     {
         HostPortKey hk;
@@ -173,6 +235,28 @@ const HostAppIdsVal* HostPortCache::find_on_first_pkt(const SfIp* ip, uint16_t p
     return nullptr;
 }
 
+void HostPortCache::add_first_ip(const HostPortKey& hk, const HostAppIdsVal& hv)
+{
+    if (finalized)
+        insert_in_table(first_ip_table, hk, hv);
+    else
+        cache_first_ip[ hk ] = hv;
+}
+
+void HostPortCache::add_first_subnet(const FirstPktkey& hk, const HostAppIdsVal& hv)
+{
+    if (finalized)
+    {
+        // keep multimap semantics, equivalent keys stay in insertion order
+        auto it = std::upper_bound(first_subnet_table.begin(), first_subnet_table.end(), hk,
+            [](const FirstPktkey& k, const std::pair<FirstPktkey, HostAppIdsVal>& entry)
+            { return k < entry.first; });
+        first_subnet_table.emplace(it, hk, hv);
+    }
+    else
+        cache_first_subnet.emplace(hk, hv);
+}
+
 bool HostPortCache::add_host(const SnortConfig*, const SfIp* ip, uint32_t* netmask, uint16_t port, IpProtocol proto,
     AppId protocol_appId, AppId client_appId, AppId web_appId, unsigned reinspect)
 {
@@ -194,7 +278,7 @@ bool HostPortCache::add_host(const SnortConfig*, const SfIp* ip, uint32_t* netma
         hv.web_appId = web_appId;
         hv.reinspect = reinspect;
 
-        cache_first_ip[ hk ] = hv;
+        add_first_ip(hk, hv);
     }
     else
     {
@@ -220,23 +304,49 @@ bool HostPortCache::add_host(const SnortConfig*, const SfIp* ip, uint32_t* netma
         hv.web_appId = web_appId;
         hv.reinspect = reinspect;
 
-        cache_first_subnet.emplace(hk, hv);
+        add_first_subnet(hk, hv);
     }
     return true;
 }
 
-void HostPortCache::dump()
+void HostPortCache::finalize()
 {
+    if (finalized)
+        return;
+
+    host_port_table.reserve(cache.size());
     for ( auto& kv : cache )
+        host_port_table.emplace_back(kv.first, kv.second);
+
+    first_ip_table.reserve(cache_first_ip.size());
+    for ( auto& kv : cache_first_ip )
+        first_ip_table.emplace_back(kv.first, kv.second);
+
+    first_subnet_table.reserve(cache_first_subnet.size());
+    for ( auto& kv : cache_first_subnet )
+        first_subnet_table.emplace_back(kv.first, kv.second);
+
+    cache.clear();
+    cache_first_ip.clear();
+    cache_first_subnet.clear();
+    finalized = true;
+}
+
+void HostPortCache::dump()
+{
+    auto dump_entry = [](const HostPortKey& hk, const HostPortVal& hv)
     {
         char inet_buffer[INET6_ADDRSTRLEN];
 
-        HostPortKey hk = kv.first;
-        HostPortVal hv = kv.second;
-
         inet_ntop(AF_INET6, &hk.ip, inet_buffer, sizeof(inet_buffer));
         APPID_LOG(nullptr, TRACE_INFO_LEVEL, "\tip=%s, \tport %d, \tip_proto %u, \ttype=%u, \tappId=%d\n",
             inet_buffer, hk.port, (unsigned)hk.proto, hv.type, hv.appId);
-    }
+    };
+
+    for ( auto& kv : cache )
+        dump_entry(kv.first, kv.second);
+
+    for ( auto& kv : host_port_table )
+        dump_entry(kv.first, kv.second);
 }
 
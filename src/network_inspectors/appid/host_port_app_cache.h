@@ -23,6 +23,9 @@
 #define HOST_PORT_APP_CACHE_H
 
 #include <cstring>
+#include <map>
+#include <utility>
+#include <vector>
 
 #include "application_ids.h"
 #include "protocols/protocol_ids.h"
@@ -112,6 +115,10 @@ public:
     const HostAppIdsVal* find_on_first_pkt(const snort::SfIp*, uint16_t port, IpProtocol, const OdpContext&);
     bool add_host(const snort::SnortConfig*, const snort::SfIp*, uint32_t* netmask, uint16_t port, IpProtocol,
         AppId, AppId, AppId, unsigned reinspect);
+
+    // Once all detectors are loaded, entries are moved from the build maps into
+    // sorted arrays that packet threads search without chasing tree nodes
+    void finalize();
     void dump();
 
     ~HostPortCache()
@@ -122,10 +129,18 @@ public:
     }
 
 private:
+    void add_host_port(const HostPortKey&, const HostPortVal&);
+    void add_first_ip(const HostPortKey&, const HostAppIdsVal&);
+    void add_first_subnet(const FirstPktkey&, const HostAppIdsVal&);
 
     std::map<HostPortKey, HostPortVal> cache;
     std::map<HostPortKey, HostAppIdsVal> cache_first_ip;
     std::multimap<FirstPktkey, HostAppIdsVal> cache_first_subnet;
+
+    std::vector<std::pair<HostPortKey, HostPortVal>> host_port_table;
+    std::vector<std::pair<HostPortKey, HostAppIdsVal>> first_ip_table;
+    std::vector<std::pair<FirstPktkey, HostAppIdsVal>> first_subnet_table;
+    bool finalized = false;
 };
 
 #endif
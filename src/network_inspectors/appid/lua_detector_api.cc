@@ -1769,6 +1769,9 @@ static int register_callback(lua_State* L, LuaObject& ud, AppInfoFlags flag)
                 return 1;
             }
             entry->flags |= flag;
+            // Remember the callback so that the control thread knows this detector
+            // must also be loaded in the packet threads
+            ud.set_cb_fn_name(callback);
         }
         else
         {
@@ -3749,9 +3752,9 @@ LuaServiceDetector::LuaServiceDetector(AppIdDiscovery* sdm, const std::string& d
 
 LuaServiceObject::LuaServiceObject(AppIdDiscovery* sdm, const std::string& detector_name,
     const std::string& log_name, bool is_custom, IpProtocol protocol, lua_State* L,
-    OdpContext& odp_ctxt) : LuaObject(odp_ctxt)
+    OdpContext& odp_ctxt, bool& has_validate) : LuaObject(odp_ctxt)
 {
-    init_lsd(&lsd, detector_name, L);
+    has_validate = init_lsd(&lsd, detector_name, L);
 
     if (init(L))
     {
@@ -3800,6 +3803,12 @@ int LuaServiceDetector::validate(AppIdDiscoveryArgs& args)
 
     std::string name = this->name + "_";
     lua_getglobal(my_lua_state, name.c_str());
+    if (lua_isnil(my_lua_state, -1))
+    {
+        // declarative detectors are not loaded in packet threads
+        lua_settop(my_lua_state, 0);
+        return APPID_NOMATCH;
+    }
     auto& ud = *UserData<LuaServiceObject>::check(my_lua_state, DETECTOR, 1);
     return ud->lsd.lua_validate(args);
 }
@@ -3876,6 +3885,12 @@ int LuaClientDetector::validate(AppIdDiscoveryArgs& args)
 
     std::string name = this->name + "_";
     lua_getglobal(my_lua_state, name.c_str());
+    if (lua_isnil(my_lua_state, -1))
+    {
+        // declarative detectors are not loaded in packet threads
+        lua_settop(my_lua_state, 0);
+        return APPID_NOMATCH;
+    }
     auto& ud = *UserData<LuaClientObject>::check(my_lua_state, DETECTOR, 1);
     return ud->lsd.lua_validate(args);
 }
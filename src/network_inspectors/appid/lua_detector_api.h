@@ -139,7 +139,7 @@ public:
     ServiceDetector* sd;
     LuaServiceObject(AppIdDiscovery* sdm, const std::string& detector_name,
         const std::string& log_name, bool is_custom, IpProtocol protocol, lua_State* L,
-        OdpContext& odp_ctxt);
+        OdpContext& odp_ctxt, bool& has_validate);
     ServiceDetector* get_detector() override
     { return sd; }
 };
@@ -28,6 +28,7 @@
 #include <glob.h>
 #include <libgen.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <fstream>
@@ -155,6 +156,11 @@ static lua_State* create_lua_state(const AppIdConfig& config, bool is_control)
     return L;
 }
 
+static inline size_t get_lua_memory(lua_State* L)
+{
+    return ((size_t)lua_gc(L, LUA_GCCOUNT, 0) * 1024) + lua_gc(L, LUA_GCCOUNTB, 0);
+}
+
 static void scan_and_print_odp_version(const char* app_detector_dir)
 {
     char odp_version_path[PATH_MAX];
@@ -400,9 +406,8 @@ LuaObject* LuaDetectorManager::create_lua_detector(const char* detector_name,
         lua_getfield(L, -1, "server");
         if ( lua_istable(L, -1) )
         {
-            has_validate = true;
             return new LuaServiceObject(&ctxt.get_odp_ctxt().get_service_disco_mgr(),
-                detector_name, log_name, is_custom, proto, L, ctxt.get_odp_ctxt());
+                detector_name, log_name, is_custom, proto, L, ctxt.get_odp_ctxt(), has_validate);
         }
         else if (init(L))
             APPID_LOG(nullptr, TRACE_ERROR_LEVEL, "Error - appid: can not read DetectorPackageInfo field"
@@ -581,7 +586,9 @@ void ControlLuaDetectorManager::process_detector_file(char* detector_file_path,
     // function such as payload_group_*, ssl_group_*, etc. That's because the patterns they
     // register are stored in global tables only in control thread. In packet threads, they
     // do nothing. Skipping loading of these detectors in packet threads saves on the memory
-    // used by LuaJIT.
+    // used by LuaJIT. Such declarative detectors are compiled away into the native pattern
+    // tables; the few of them that register a detector callback from init() are loaded in
+    // the packet threads after the control thread activation, see load_callback_detectors().
 
     // Because the code flow for loading Lua detectors is different for initialization vs
     // reload, the LuaJIT memory saving is achieved differently in these two cases.
@@ -596,13 +603,56 @@ void ControlLuaDetectorManager::process_detector_file(char* detector_file_path,
     // loading detectors that don't have validate for packet threads.
 
     string buf;
+    size_t num_objects = allocated_objects.size();
+    size_t mem_before = get_lua_memory(L);
     bool has_validate = load_detector(detector_file_path, is_custom, buf);
 
-    for (auto& lua_detector_mgr : lua_detector_mgr_list)
+    if (has_validate)
     {
-        if (has_validate)
+        for (auto& lua_detector_mgr : lua_detector_mgr_list)
             lua_detector_mgr->load_detector(detector_file_path, is_custom, buf);
     }
+    else if (allocated_objects.size() > num_objects)
+    {
+        size_t mem_after = get_lua_memory(L);
+        DeclarativeDetector& dd = declarative_detectors[allocated_objects.front()];
+        dd.file_path = detector_file_path;
+        dd.is_custom = is_custom;
+        dd.memory = (mem_after > mem_before) ? mem_after - mem_before : 0;
+        dd.buf = std::move(buf);
+    }
+    lua_settop(L, 0);
+}
+
+void ControlLuaDetectorManager::load_callback_detectors()
+{
+    num_declarative_detectors = 0;
+    declarative_memory = 0;
+
+    for (auto& dd : declarative_detectors)
+    {
+        // a detector object that failed activation has already been deleted
+        if (find(allocated_objects.begin(), allocated_objects.end(), dd.first) ==
+            allocated_objects.end())
+            continue;
+
+        if (dd.first->get_cb_fn_name().empty())
+        {
+            ++num_declarative_detectors;
+            declarative_memory += dd.second.memory;
+            continue;
+        }
+
+        for (auto& lua_detector_mgr : lua_detector_mgr_list)
+        {
+            lua_detector_mgr->load_detector(const_cast<char*>(dd.second.file_path.c_str()),
+                dd.second.is_custom, dd.second.buf);
+            if (!dd.second.is_custom)
+                lua_detector_mgr->inc_num_odp_detectors();
+        }
+    }
+
+    declarative_detectors.clear();
     lua_settop(L, 0);
 }
 
@@ -703,6 +753,10 @@ void ControlLuaDetectorManager::initialize(const SnortConfig* sc)
 
     initialize_lua_detectors();
     LuaDetectorManager::initialize(sc);
+    load_callback_detectors();
+
+    if (s_list_lua_detectors)
+        list_declarative_detectors();
 }
 
 void ControlLuaDetectorManager::list_lua_detectors()
@@ -719,6 +773,20 @@ void ControlLuaDetectorManager::list_lua_detectors()
         " total memory %d kb\n", num_odp_detectors, (allocated_objects.size() - num_odp_detectors), memory_used_by_lua);
 }
 
+void ControlLuaDetectorManager::list_declarative_detectors()
+{
+    #ifdef REG_TEST
+    // Lua memory usage is inconsistent, for ease of testing lets print 0 instead.
+    size_t memory_saved = 0;
+    #else
+    size_t memory_saved = declarative_memory / 1024;
+    #endif
+
+    APPID_LOG(nullptr, TRACE_INFO_LEVEL, "AppId Lua-Detector Stats: declarative detectors %zu compiled into"
+        " native pattern tables, memory saved per packet instance %zu kb\n", num_declarative_detectors,
+        memory_saved);
+}
+
 void ControlLuaDetectorManager::cleanup_after_swap()
 {
     free_old_chp_glossary();
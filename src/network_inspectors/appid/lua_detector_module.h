@@ -61,6 +61,8 @@ public:
     bool load_detector(char* detector_name, bool is_custom, std::string& buf);
     void set_num_odp_detectors()
     { num_odp_detectors = allocated_objects.size(); }
+    void inc_num_odp_detectors()
+    { ++num_odp_detectors; }
     bool insert_cb_detector(AppId app_id, LuaObject* ud);
     LuaObject* get_cb_detector(AppId app_id);
 
@@ -119,14 +121,29 @@ public:
     }
 
 private:
+    // Detector without validate function loaded only in the control thread; its
+    // compiled chunk is kept until activation tells if it registered a callback
+    struct DeclarativeDetector
+    {
+        std::string file_path;
+        bool is_custom = false;
+        size_t memory = 0;
+        std::string buf;
+    };
+
     static std::vector<std::shared_ptr<PacketLuaDetectorManager>> lua_detector_mgr_list;
 
     void initialize_lua_detectors();
     void load_lua_detectors(const char* path, bool is_custom);
     void process_detector_file(char* detector_file_path, bool is_custom);
+    void load_callback_detectors();
     void list_lua_detectors() override;
+    void list_declarative_detectors();
 
     bool ignore_chp_cleanup = false;
+    std::map<LuaObject*, DeclarativeDetector> declarative_detectors;
+    size_t num_declarative_detectors = 0;
+    size_t declarative_memory = 0;
 };
 
 #endif
@@ -235,6 +235,8 @@ AppId AppIdSession::pick_ss_payload_app_id(AppId) const { return get_payload_id(
 bool AppIdSession::need_to_delete_tp_conn(ThirdPartyAppIdContext*) const { return true; }
 void AppIdSession::process_shadow_traffic_appids() {}
 void AppIdSession::examine_ssl_metadata(AppidChangeBits&,bool) {}
+bool AppIdSession::is_discovery_final() const { return false; }
+bool AppIdSession::has_pending_discovery(const Packet&) const { return false; }
 
 AppIdSession* AppIdSession::allocate_session(const Packet*, IpProtocol,
     AppidSessionDirection, AppIdInspector&, OdpContext&)
@@ -478,6 +480,48 @@ TEST(appid_discovery_tests, event_published_when_processing_flow)
     delete flow;
 }
 
+TEST(appid_discovery_tests, finished_flow_bypasses_discovery)
+{
+    mock().expectNoCall("publish");
+    Packet p;
+    p.packet_flags = 0;
+    DAQ_PktHdr_t pkth;
+    pkth.pktlen = 100;
+    p.pkth = &pkth;
+    SfIp ip;
+    ip.set("1.2.3.4");
+    p.ptrs.ip_api.set(ip, ip);
+    p.ptrs.sp = 21;
+    AppIdModule app_module;
+    AppIdInspector ins(app_module);
+    AppIdContext& app_ctxt = ins.get_ctxt();
+    AppIdSession* asd = new AppIdSession(IpProtocol::TCP, &ip, 21, ins, app_ctxt.get_odp_ctxt(), 0
+#ifndef DISABLE_TENANT_ID
+    ,0
+#endif
+    );
+    asd->flags |= APPID_SESSION_SPECIAL_MONITORED | APPID_SESSION_DISCOVER_USER |
+        APPID_SESSION_DISCOVER_APP;
+    Flow* flow = new Flow;
+    flow->set_flow_data(asd);
+    p.flow = flow;
+    asd->initiator_port = 21;
+    asd->set_discovery_finished(true);
+    appid_stats.bypassed_packets = 0;
+
+    AppIdDiscovery::do_application_discovery(&p, ins, app_ctxt.get_odp_ctxt(), nullptr);
+
+    mock().checkExpectations();
+    CHECK_EQUAL(1, appid_stats.bypassed_packets);
+    CHECK_EQUAL(1, asd->session_packet_count);
+    CHECK_EQUAL(100, asd->stats.initiator_bytes);
+    CHECK_TRUE(asd->is_discovery_finished());
+
+    delete &asd->get_api();
+    delete asd;
+    delete flow;
+}
+
 TEST(appid_discovery_tests, change_bits_for_client_version)
 {
     // Testing set_version
@@ -0,0 +1,548 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// binary_formatter.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "binary_formatter.h"
+
+#include <cstring>
+
+//-------------------------------------------------------------------------
+// encoding
+//-------------------------------------------------------------------------
+
+static void put_u32(std::string& s, uint32_t v)
+{
+    for ( unsigned i = 0; i < 4; ++i )
+        s += (char)(v >> (8 * i));
+}
+
+static void put_varint(std::string& s, uint64_t v)
+{
+    while ( v >= 0x80 )
+    {
+        s += (char)(v | 0x80);
+        v >>= 7;
+    }
+    s += (char)v;
+}
+
+// counts can go down when they are reset so deltas are signed
+static void put_delta(std::string& s, uint64_t cur, uint64_t last)
+{
+    int64_t d = (int64_t)(cur - last);
+    put_varint(s, ((uint64_t)d << 1) ^ (uint64_t)(d >> 63));
+}
+
+static bool get_u32(const uint8_t*& p, const uint8_t* end, uint32_t& v)
+{
+    if ( end - p < 4 )
+        return false;
+
+    v = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    p += 4;
+    return true;
+}
+
+static bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t& v)
+{
+    v = 0;
+
+    for ( unsigned shift = 0; p < end and shift < 64; shift += 7 )
+    {
+        uint8_t b = *p++;
+        v |= (uint64_t)(b & 0x7f) << shift;
+
+        if ( !(b & 0x80) )
+            return true;
+    }
+    return false;
+}
+
+static bool get_delta(const uint8_t*& p, const uint8_t* end, uint64_t& cur)
+{
+    uint64_t z;
+
+    if ( !get_varint(p, end, z) )
+        return false;
+
+    cur += (z >> 1) ^ -(z & 1);
+    return true;
+}
+
+static bool get_cstr(const uint8_t*& p, const uint8_t* end, std::string& s)
+{
+    const uint8_t* nul = (const uint8_t*)memchr(p, 0, end - p);
+
+    if ( !nul )
+        return false;
+
+    s.assign((const char*)p, nul - p);
+    p = nul + 1;
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// formatter
+//-------------------------------------------------------------------------
+
+void BinaryFormatter::finalize_fields()
+{
+    std::string schema = get_tracker_name();
+    schema += '\0';
+
+    uint32_t num_fields = 0;
+
+    for ( const auto& v : values )
+        num_fields += v.size();
+
+    put_u32(schema, num_fields);
+
+    for ( unsigned i = 0; i < section_names.size(); i++ )
+    {
+        for ( unsigned j = 0; j < field_names[i].size(); j++ )
+        {
+            schema += (char)types[i][j];
+            schema += section_names[i];
+            schema += '\0';
+            schema += field_names[i][j];
+            schema += '\0';
+        }
+    }
+
+    header = PERF_BINARY_MAGIC;
+    put_u32(header, PERF_BINARY_VERSION);
+    put_u32(header, schema.size());
+    header += schema;
+
+    last_counts.assign(num_fields, 0);
+    last_strings.assign(num_fields, std::string());
+
+    section_names.clear();
+    field_names.clear();
+}
+
+void BinaryFormatter::init_output(FILE* fh)
+{
+    fwrite(header.data(), header.size(), 1, fh);
+    fflush(fh);
+
+    std::fill(last_counts.begin(), last_counts.end(), 0);
+
+    for ( auto& s : last_strings )
+        s.clear();
+
+    last_time = 0;
+}
+
+void BinaryFormatter::write(FILE* fh, time_t timestamp)
+{
+    record.clear();
+    put_delta(record, timestamp, last_time);
+    last_time = timestamp;
+
+    unsigned k = 0;
+
+    for ( unsigned i = 0; i < values.size(); i++ )
+    {
+        for ( unsigned j = 0; j < values[i].size(); j++, k++ )
+        {
+            switch ( types[i][j] )
+            {
+            case FT_PEG_COUNT:
+                put_delta(record, *values[i][j].pc, last_counts[k]);
+                last_counts[k] = *values[i][j].pc;
+                break;
+
+            case FT_STRING:
+            {
+                const char* s = values[i][j].s ? values[i][j].s : "";
+
+                if ( last_strings[k] == s )
+                    put_varint(record, 0);
+                else
+                {
+                    last_strings[k] = s;
+                    put_varint(record, last_strings[k].size() + 1);
+                    record += last_strings[k];
+                }
+                break;
+            }
+
+            case FT_IDX_PEG_COUNT:
+            {
+                const std::vector<PegCount>& vals = *values[i][j].ipc;
+                uint64_t nonzero = 0;
+
+                for ( auto v : vals )
+                    nonzero += (v != 0);
+
+                put_varint(record, vals.size());
+                put_varint(record, nonzero);
+
+                uint64_t last_idx = 0;
+
+                for ( uint64_t idx = 0; idx < vals.size(); idx++ )
+                {
+                    if ( !vals[idx] )
+                        continue;
+
+                    put_varint(record, idx - last_idx);
+                    put_varint(record, vals[idx]);
+                    last_idx = idx;
+                }
+                break;
+            }
+            }
+        }
+    }
+
+    std::string size;
+    put_u32(size, record.size());
+
+    fwrite(size.data(), size.size(), 1, fh);
+    fwrite(record.data(), record.size(), 1, fh);
+    fflush(fh);
+}
+
+//-------------------------------------------------------------------------
+// reader
+//-------------------------------------------------------------------------
+
+bool BinaryReader::open(FILE* f)
+{
+    uint8_t hdr[12];
+
+    if ( fread(hdr, sizeof(hdr), 1, f) != 1 or memcmp(hdr, PERF_BINARY_MAGIC, 4) )
+        return false;
+
+    const uint8_t* p = hdr + 4;
+    uint32_t version, schema_size;
+
+    get_u32(p, hdr + sizeof(hdr), version);
+    get_u32(p, hdr + sizeof(hdr), schema_size);
+
+    if ( version != PERF_BINARY_VERSION )
+        return false;
+
+    buf.resize(schema_size);
+
+    if ( schema_size and fread(buf.data(), schema_size, 1, f) != 1 )
+        return false;
+
+    p = buf.data();
+    const uint8_t* end = p + schema_size;
+    uint32_t num_fields;
+
+    if ( !get_cstr(p, end, tracker_name) or !get_u32(p, end, num_fields) )
+        return false;
+
+    std::vector<Field> schema;
+
+    for ( uint32_t i = 0; i < num_fields; ++i )
+    {
+        Field f;
+
+        if ( p == end or *p > FT_IDX_PEG_COUNT )
+            return false;
+
+        f.type = (FormatterType)*p++;
+
+        if ( !get_cstr(p, end, f.section) or !get_cstr(p, end, f.name) )
+            return false;
+
+        schema.emplace_back(f);
+    }
+
+    if ( registered )
+    {
+        // the formatter points into the existing storage so keep it
+        if ( schema != fields )
+            return false;
+
+        std::fill(counts.begin(), counts.end(), 0);
+
+        for ( auto& str : strings )
+            str[0] = '\0';
+
+        for ( auto& vec : vectors )
+            vec.clear();
+    }
+    else
+    {
+        fields.swap(schema);
+        counts.assign(num_fields, 0);
+        strings.assign(num_fields, std::vector<char>(max_string + 1, '\0'));
+        vectors.assign(num_fields, std::vector<PegCount>());
+    }
+
+    fh = f;
+    last_time = 0;
+    return true;
+}
+
+void BinaryReader::register_fields(PerfFormatter& fmt)
+{
+    for ( unsigned i = 0; i < fields.size(); ++i )
+    {
+        if ( !i or fields[i].section != fields[i - 1].section )
+            fmt.register_section(fields[i].section);
+
+        switch ( fields[i].type )
+        {
+        case FT_PEG_COUNT:
+            fmt.register_field(fields[i].name, &counts[i]);
+            break;
+
+        case FT_STRING:
+            fmt.register_field(fields[i].name, (const char*)strings[i].data());
+            break;
+
+        case FT_IDX_PEG_COUNT:
+            fmt.register_field(fields[i].name, &vectors[i]);
+            break;
+        }
+    }
+    fmt.finalize_fields();
+    registered = true;
+}
+
+bool BinaryReader::decode(const uint8_t* p, const uint8_t* end)
+{
+    uint64_t t = last_time;
+
+    if ( !get_delta(p, end, t) )
+        return false;
+
+    last_time = t;
+
+    for ( unsigned i = 0; i < fields.size(); ++i )
+    {
+        switch ( fields[i].type )
+        {
+        case FT_PEG_COUNT:
+            if ( !get_delta(p, end, counts[i]) )
+                return false;
+            break;
+
+        case FT_STRING:
+        {
+            uint64_t len;
+
+            if ( !get_varint(p, end, len) or (uint64_t)(end - p) + 1 < len )
+                return false;
+
+            if ( len-- )
+            {
+                uint64_t n = len < max_string ? len : max_string;
+                memcpy(strings[i].data(), p, n);
+                strings[i][n] = '\0';
+                p += len;
+            }
+            break;
+        }
+
+        case FT_IDX_PEG_COUNT:
+        {
+            uint64_t size, nonzero;
+
+            if ( !get_varint(p, end, size) or !get_varint(p, end, nonzero) or
+                nonzero > size or size > (uint64_t)(end - p) * 64 )
+                return false;
+
+            std::vector<PegCount>& vals = vectors[i];
+            vals.assign(size, 0);
+            uint64_t idx = 0;
+
+            for ( uint64_t n = 0; n < nonzero; ++n )
+            {
+                uint64_t step, v;
+
+                if ( !get_varint(p, end, step) or !get_varint(p, end, v) )
+                    return false;
+
+                idx += step;
+
+                if ( idx >= size )
+                    return false;
+
+                vals[idx] = v;
+            }
+            break;
+        }
+        }
+    }
+    return p == end;
+}
+
+bool BinaryReader::read(time_t& timestamp)
+{
+    uint8_t hdr[4];
+
+    if ( !fh or fread(hdr, sizeof(hdr), 1, fh) != 1 )
+        return false;
+
+    const uint8_t* p = hdr;
+    uint32_t size;
+    get_u32(p, hdr + sizeof(hdr), size);
+
+    buf.resize(size);
+
+    if ( size and fread(buf.data(), size, 1, fh) != 1 )
+        return false;
+
+    if ( !decode(buf.data(), buf.data() + size) )
+        return false;
+
+    timestamp = last_time;
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// tests
+//-------------------------------------------------------------------------
+
+#ifdef CATCH_TEST_BUILD
+
+#include "catch/catch.hpp"
+
+#include "csv_formatter.h"
+
+static std::string slurp(FILE* fh)
+{
+    auto size = ftell(fh);
+    std::string s(size, '\0');
+
+    rewind(fh);
+    fread(&s[0], size, 1, fh);
+    return s;
+}
+
+TEST_CASE("binary round trip", "[BinaryFormatter]")
+{
+    PegCount one = 5, two = 1000000, three = 0;
+    char five[32] = "hellothere";
+    std::vector<PegCount> kvp;
+
+    FILE* bin = tmpfile();
+    FILE* csv = tmpfile();
+
+    BinaryFormatter b("binary_formatter");
+    CSVFormatter c("binary_formatter");
+
+    for ( PerfFormatter* f : { (PerfFormatter*)&b, (PerfFormatter*)&c } )
+    {
+        f->register_section("name");
+        f->register_field("one", &one);
+        f->register_field("two", &two);
+        f->register_section("other");
+        f->register_field("three", &three);
+        f->register_field("five", five);
+        f->register_field("kvp", &kvp);
+        f->finalize_fields();
+    }
+    b.init_output(bin);
+    c.init_output(csv);
+
+    kvp = { 50, 0, 70 };
+    b.write(bin, (time_t)1234567890);
+    c.write(csv, (time_t)1234567890);
+    long first = ftell(bin);
+
+    // counts going down, empty string, empty vector
+    two = 7;
+    three = UINT64_MAX;
+    five[0] = '\0';
+    kvp.clear();
+    b.write(bin, (time_t)1234567891);
+    c.write(csv, (time_t)1234567891);
+    long second = ftell(bin) - first;
+
+    // nothing changed
+    b.write(bin, (time_t)1234567892);
+    c.write(csv, (time_t)1234567892);
+    long third = ftell(bin) - first - second;
+
+    CHECK(third < second);
+    CHECK(third == 4 + 1 + 3 + 1 + 2);
+
+    std::string expected = slurp(csv);
+
+    rewind(bin);
+    BinaryReader r;
+    REQUIRE(r.open(bin));
+    CHECK(r.get_tracker_name() == "binary_formatter");
+
+    FILE* out = tmpfile();
+    CSVFormatter o(r.get_tracker_name());
+    r.register_fields(o);
+    o.init_output(out);
+
+    time_t t;
+    unsigned records = 0;
+
+    while ( r.read(t) )
+    {
+        o.write(out, t);
+        ++records;
+    }
+
+    CHECK(records == 3);
+    CHECK(slurp(out) == expected);
+
+    fclose(out);
+    fclose(csv);
+    fclose(bin);
+}
+
+TEST_CASE("binary truncated record", "[BinaryFormatter]")
+{
+    PegCount one = 1;
+    FILE* bin = tmpfile();
+
+    BinaryFormatter b("trunc");
+    b.register_section("s");
+    b.register_field("one", &one);
+    b.finalize_fields();
+    b.init_output(bin);
+    b.write(bin, (time_t)1);
+
+    // a partial record as if snort died mid write
+    fwrite("\x09\x00\x00\x00\x02", 5, 1, bin);
+    rewind(bin);
+
+    BinaryReader r;
+    REQUIRE(r.open(bin));
+
+    CSVFormatter o("trunc");
+    r.register_fields(o);
+
+    time_t t;
+    CHECK(r.read(t));
+    CHECK(t == 1);
+    CHECK(!r.read(t));
+
+    fclose(bin);
+}
+
+#endif
+
@@ -0,0 +1,125 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// binary_formatter.h
+
+#ifndef BINARY_FORMATTER_H
+#define BINARY_FORMATTER_H
+
+// compact append only output.  a file is a header with the schema followed
+// by one record per write.  each record holds every field in schema order;
+// counts are deltas from the previous record so unchanged counts take one
+// byte, strings are only written when they change, and indexed counts only
+// list their nonzero entries.  fixed width integers are little endian and
+// varints are LEB128.
+//
+//   header:  "PMBF", u32 version, u32 schema size, schema
+//   schema:  tracker name\0, u32 fields, per field:
+//            u8 FormatterType, section\0, field\0
+//   record:  u32 size, varint zigzag timestamp delta, fields
+//   fields:  FT_PEG_COUNT      varint zigzag delta
+//            FT_STRING         varint 0 if unchanged else length + 1, bytes
+//            FT_IDX_PEG_COUNT  varint size, varint nonzero entries,
+//                              varint index delta and varint count for each
+//
+// deltas restart with each file so every file can be read on its own.
+// BinaryReader decodes a file into fields that can be registered with any
+// other formatter; tools/perf_convert uses it to produce csv and json.
+
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "perf_formatter.h"
+
+#define PERF_BINARY_MAGIC "PMBF"
+#define PERF_BINARY_VERSION 1
+
+class BinaryFormatter : public PerfFormatter
+{
+public:
+    BinaryFormatter(const std::string& tracker_name) : PerfFormatter(tracker_name) {}
+
+    const char* get_extension() override
+    { return ".pmbf"; }
+
+    // deltas can't span files
+    bool allow_append() override
+    { return false; }
+
+    void finalize_fields() override;
+    void init_output(FILE*) override;
+    void write(FILE*, time_t) override;
+
+private:
+    std::string header;
+    std::string record;
+
+    std::vector<PegCount> last_counts;
+    std::vector<std::string> last_strings;
+    time_t last_time = 0;
+};
+
+class BinaryReader
+{
+public:
+    // longer strings are truncated
+    static constexpr unsigned max_string = 1023;
+
+    // read the header; false if this isn't a binary perf file or, once
+    // fields are registered, if its schema differs from the last file
+    bool open(FILE*);
+
+    const std::string& get_tracker_name() const
+    { return tracker_name; }
+
+    // register the schema with the formatter, backed by this reader
+    void register_fields(PerfFormatter&);
+
+    // decode the next record; false at the end or if it is incomplete
+    bool read(time_t&);
+
+private:
+    struct Field
+    {
+        FormatterType type;
+        std::string section;
+        std::string name;
+
+        bool operator==(const Field& rhs) const
+        { return type == rhs.type and section == rhs.section and name == rhs.name; }
+    };
+
+    bool decode(const uint8_t*, const uint8_t*);
+
+    std::string tracker_name;
+    std::vector<Field> fields;
+
+    std::vector<PegCount> counts;
+    std::vector<std::vector<char>> strings;
+    std::vector<std::vector<PegCount>> vectors;
+    std::vector<uint8_t> buf;
+
+    FILE* fh = nullptr;
+    time_t last_time = 0;
+    bool registered = false;
+};
+
+#endif
+
@@ -0,0 +1,366 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// flow_ip_sketch.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "flow_ip_sketch.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#ifdef UNIT_TEST
+#include <map>
+#include "catch/snort_catch.h"
+#endif
+
+using namespace snort;
+
+static inline uint64_t mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static inline uint32_t pow2(unsigned n)
+{
+    uint32_t p = 1;
+
+    while ( p < n )
+        p <<= 1;
+
+    return p;
+}
+
+//-------------------------------------------------------------------------
+// space saving
+//-------------------------------------------------------------------------
+
+HostPairTopK::HostPairTopK(unsigned k, uint64_t s) : capacity(k), seed(s)
+{
+    assert(capacity);
+    heap.reserve(capacity);
+    table.assign(pow2(2 * capacity), EMPTY);
+    mask = table.size() - 1;
+}
+
+uint64_t HostPairTopK::hash(const FlowStateKey& key) const
+{
+    const uint64_t* a = key.ipA.get_ip64_ptr();
+    const uint64_t* b = key.ipB.get_ip64_ptr();
+
+    uint64_t h = mix(seed ^ a[0]);
+    h = mix(h ^ a[1]);
+    h = mix(h ^ b[0]);
+    h = mix(h ^ b[1] ^ ((uint64_t)key.ipA.get_family() << 16) ^ key.ipB.get_family());
+    return h;
+}
+
+uint32_t HostPairTopK::probe(const FlowStateKey& key) const
+{
+    uint32_t i = hash(key) & mask;
+
+    while ( table[i] != EMPTY and memcmp(&heap[table[i]].key, &key, sizeof(key)) )
+        i = (i + 1) & mask;
+
+    return i;
+}
+
+// backward shift deletion keeps probe sequences intact without tombstones
+void HostPairTopK::unlink(uint32_t hole)
+{
+    table[hole] = EMPTY;
+    uint32_t j = hole;
+
+    while ( true )
+    {
+        j = (j + 1) & mask;
+
+        if ( table[j] == EMPTY )
+            break;
+
+        uint32_t home = hash(heap[table[j]].key) & mask;
+
+        // leave j alone if its home is cyclically in (hole, j]
+        bool stay = (hole < j) ? (home > hole and home <= j) : (home > hole or home <= j);
+
+        if ( stay )
+            continue;
+
+        table[hole] = table[j];
+        heap[table[hole]].slot = hole;
+        table[j] = EMPTY;
+        hole = j;
+    }
+}
+
+void HostPairTopK::swap(unsigned i, unsigned j)
+{
+    std::swap(heap[i], heap[j]);
+    table[heap[i].slot] = i;
+    table[heap[j].slot] = j;
+}
+
+void HostPairTopK::sift_up(unsigned i)
+{
+    while ( i )
+    {
+        unsigned parent = (i - 1) / 2;
+
+        if ( heap[parent].count <= heap[i].count )
+            break;
+
+        swap(i, parent);
+        i = parent;
+    }
+}
+
+void HostPairTopK::sift_down(unsigned i)
+{
+    unsigned n = heap.size();
+
+    while ( true )
+    {
+        unsigned min = i;
+        unsigned left = 2 * i + 1;
+        unsigned right = left + 1;
+
+        if ( left < n and heap[left].count < heap[min].count )
+            min = left;
+
+        if ( right < n and heap[right].count < heap[min].count )
+            min = right;
+
+        if ( min == i )
+            break;
+
+        swap(i, min);
+        i = min;
+    }
+}
+
+HostPairTopK::Entry& HostPairTopK::update(const FlowStateKey& key, uint64_t bytes, bool& replaced)
+{
+    uint32_t s = probe(key);
+    replaced = false;
+
+    if ( table[s] != EMPTY )
+    {
+        heap[table[s]].count += bytes;
+        sift_down(table[s]);
+        return heap[table[s]];
+    }
+
+    if ( heap.size() < capacity )
+    {
+        heap.push_back({ key, FlowStateValue(), bytes, 0, s });
+        table[s] = heap.size() - 1;
+        sift_up(table[s]);
+        return heap[table[s]];
+    }
+
+    uint64_t min = heap[0].count;
+    unlink(heap[0].slot);
+
+    s = probe(key);
+    heap[0] = { key, FlowStateValue(), min + bytes, min, s };
+    table[s] = 0;
+    sift_down(0);
+
+    replaced = true;
+    return heap[table[s]];
+}
+
+HostPairTopK::Entry* HostPairTopK::find(const FlowStateKey& key)
+{
+    uint32_t s = probe(key);
+    return table[s] == EMPTY ? nullptr : &heap[table[s]];
+}
+
+void HostPairTopK::clear()
+{
+    heap.clear();
+    std::fill(table.begin(), table.end(), EMPTY);
+}
+
+//-------------------------------------------------------------------------
+// count-min
+//-------------------------------------------------------------------------
+
+HostCounts::HostCounts(unsigned width, unsigned d, uint64_t s) : depth(d), seed(s)
+{
+    assert(width and depth);
+    mask = pow2(width) - 1;
+    cells.assign((size_t)depth * (mask + 1), { 0, 0 });
+}
+
+// rows use h1 + row * h2 (Kirsch-Mitzenmacher) rather than depth hashes
+void HostCounts::hash(const SfIp& ip, uint64_t& h1, uint64_t& h2) const
+{
+    const uint64_t* a = ip.get_ip64_ptr();
+    h1 = mix(seed ^ a[0]);
+    h1 = mix(h1 ^ a[1] ^ (uint64_t)ip.get_family());
+    h2 = mix(h1 ^ 0x9e3779b97f4a7c15ULL) | 1;
+}
+
+void HostCounts::update(const SfIp& ip, uint64_t bytes)
+{
+    uint64_t h1, h2;
+    hash(ip, h1, h2);
+
+    for ( unsigned r = 0; r < depth; ++r )
+    {
+        Cell& c = cells[(size_t)r * (mask + 1) + ((h1 + r * h2) & mask)];
+        ++c.packets;
+        c.bytes += bytes;
+    }
+}
+
+void HostCounts::estimate(const SfIp& ip, uint64_t& packets, uint64_t& bytes) const
+{
+    uint64_t h1, h2;
+    hash(ip, h1, h2);
+
+    packets = bytes = UINT64_MAX;
+
+    for ( unsigned r = 0; r < depth; ++r )
+    {
+        const Cell& c = cells[(size_t)r * (mask + 1) + ((h1 + r * h2) & mask)];
+        packets = std::min(packets, c.packets);
+        bytes = std::min(bytes, c.bytes);
+    }
+}
+
+void HostCounts::clear()
+{ std::fill(cells.begin(), cells.end(), Cell{ 0, 0 }); }
+
+//-------------------------------------------------------------------------
+// unit tests
+//-------------------------------------------------------------------------
+
+#ifdef UNIT_TEST
+
+static FlowStateKey make_key(uint32_t a, uint32_t b)
+{
+    FlowStateKey key;
+    key.ipA.set(&a, AF_INET);
+    key.ipB.set(&b, AF_INET);
+    return key;
+}
+
+TEST_CASE("space saving keeps heavy hitters", "[perf_monitor]")
+{
+    const unsigned k = 16;
+    HostPairTopK top(k, 1234);
+    std::map<uint32_t, uint64_t> truth;
+    uint64_t total = 0;
+    bool replaced;
+
+    // 4 heavy pairs among a long tail of light ones
+    for ( uint32_t i = 0; i < 20000; ++i )
+    {
+        uint32_t id = (i % 5) ? 1 + (i % 4) : 100 + i;
+        uint64_t bytes = 100;
+
+        top.update(make_key(id, 0x0a000001), bytes, replaced);
+        truth[id] += bytes;
+        total += bytes;
+    }
+
+    CHECK(top.size() == k);
+
+    for ( uint32_t id = 1; id <= 4; ++id )
+    {
+        const HostPairTopK::Entry* e = top.find(make_key(id, 0x0a000001));
+        REQUIRE(e);
+        CHECK(e->count >= truth[id]);
+        CHECK(e->count - e->error <= truth[id]);
+        CHECK(e->error <= total / k);
+    }
+
+    for ( unsigned i = 0; i < top.size(); ++i )
+        CHECK(top.find(top[i].key) == &top[i]);
+
+    top.clear();
+    CHECK(top.size() == 0);
+    CHECK(!top.find(make_key(1, 0x0a000001)));
+}
+
+TEST_CASE("space saving table survives churn", "[perf_monitor]")
+{
+    HostPairTopK top(3, 99);
+    bool replaced;
+
+    for ( uint32_t i = 0; i < 1000; ++i )
+    {
+        top.update(make_key(i, i * 7), i + 1, replaced);
+        CHECK(replaced == (i >= 3));
+
+        for ( unsigned j = 0; j < top.size(); ++j )
+            CHECK(top.find(top[j].key) == &top[j]);
+    }
+}
+
+TEST_CASE("count-min never undercounts", "[perf_monitor]")
+{
+    HostCounts hosts(64, 4, 42);
+    std::map<uint32_t, uint64_t> truth;
+
+    for ( uint32_t i = 0; i < 5000; ++i )
+    {
+        uint32_t a = i % 300;
+        SfIp ip;
+        ip.set(&a, AF_INET);
+        hosts.update(ip, 10);
+        truth[a] += 10;
+    }
+
+    for ( const auto& t : truth )
+    {
+        SfIp ip;
+        uint32_t a = t.first;
+        ip.set(&a, AF_INET);
+
+        uint64_t packets, bytes;
+        hosts.estimate(ip, packets, bytes);
+
+        CHECK(bytes >= t.second);
+        CHECK(packets * 10 >= t.second);
+    }
+
+    hosts.clear();
+
+    SfIp ip;
+    uint32_t a = 1;
+    ip.set(&a, AF_INET);
+
+    uint64_t packets, bytes;
+    hosts.estimate(ip, packets, bytes);
+    CHECK(packets == 0);
+    CHECK(bytes == 0);
+}
+
+#endif
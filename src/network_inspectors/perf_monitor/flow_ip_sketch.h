@@ -0,0 +1,112 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// flow_ip_sketch.h
+
+#ifndef FLOW_IP_SKETCH_H
+#define FLOW_IP_SKETCH_H
+
+// fixed memory summaries used by flow_ip_mode = sketch in place of the flow
+// ip hash table, so the cost per packet and the memory used don't depend on
+// how many addresses are seen.
+//
+// HostPairTopK is a space saving summary of the host pairs with the most
+// bytes.  when full, a new pair replaces the smallest entry and inherits its
+// count as error.  with N total bytes and capacity K, any pair with more
+// than N / K bytes is present and each estimate exceeds the true count by
+// at most its error, which is at most N / K.
+//
+// HostCounts is a count-min sketch of packets and bytes per host.
+// estimates never undercount and exceed the true count by at most
+// e * N / width with probability 1 - e^-depth.
+
+#include <cstdint>
+#include <vector>
+
+#include "flow_ip_tracker.h"
+
+class HostPairTopK
+{
+public:
+    struct Entry
+    {
+        FlowStateKey key;
+        FlowStateValue value;
+        uint64_t count;     // estimated bytes
+        uint64_t error;     // most count can exceed the true bytes
+        uint32_t slot;      // in table
+    };
+
+    HostPairTopK(unsigned capacity, uint64_t seed);
+
+    // the entry for key after adding bytes; replaced is set if the entry
+    // took the place of the smallest one
+    Entry& update(const FlowStateKey&, uint64_t bytes, bool& replaced);
+
+    Entry* find(const FlowStateKey&);
+    void clear();
+
+    unsigned size() const
+    { return heap.size(); }
+
+    // in no particular order
+    const Entry& operator[](unsigned i) const
+    { return heap[i]; }
+
+private:
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    uint64_t hash(const FlowStateKey&) const;
+    uint32_t probe(const FlowStateKey&) const;
+    void unlink(uint32_t slot);
+    void swap(unsigned i, unsigned j);
+    void sift_up(unsigned i);
+    void sift_down(unsigned i);
+
+    std::vector<Entry> heap;        // min heap on count
+    std::vector<uint32_t> table;    // heap index per hash slot
+    unsigned capacity;
+    uint64_t seed;
+    uint32_t mask;
+};
+
+class HostCounts
+{
+public:
+    HostCounts(unsigned width, unsigned depth, uint64_t seed);
+
+    void update(const snort::SfIp&, uint64_t bytes);
+    void estimate(const snort::SfIp&, uint64_t& packets, uint64_t& bytes) const;
+    void clear();
+
+private:
+    struct Cell
+    {
+        uint64_t packets;
+        uint64_t bytes;
+    };
+
+    void hash(const snort::SfIp&, uint64_t& h1, uint64_t& h2) const;
+
+    std::vector<Cell> cells;
+    unsigned depth;
+    uint64_t seed;
+    uint32_t mask;
+};
+
+#endif
@@ -24,6 +24,10 @@
 
 #include "flow_ip_tracker.h"
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
 #include <appid/appid_api.h>
 #include "flow/stream_flow.h"
 #include "framework/pig_pen.h"
@@ -31,6 +35,7 @@
 #include "log/messages.h"
 #include "protocols/packet.h"
 
+#include "flow_ip_sketch.h"
 #include "perf_monitor.h"
 #include "perf_pegs.h"
 
@@ -38,17 +43,13 @@ using namespace snort;
 
 // The default number of rows used for the xhash ip_map
 #define DEFAULT_XHASH_NROWS 1021
+// rows of the per host count-min sketch
+#define SKETCH_DEPTH 4
 #define TRACKER_NAME PERF_NAME "_flow_ip"
 
-struct FlowStateKey
-{
-    SfIp ipA;
-    SfIp ipB;
-};
-
 FlowStateValue* FlowIPTracker::find_stats(const SfIp* src_addr, const SfIp* dst_addr,
     int* swapped, const char* appid_name, uint16_t src_port, uint16_t dst_port,
-    uint8_t ip_protocol, uint64_t flow_latency, uint64_t rule_latency)
+    uint8_t ip_protocol, uint64_t flow_latency, uint64_t rule_latency, uint64_t bytes)
 {
     FlowStateKey key;
     FlowStateValue* value = nullptr;
@@ -66,33 +67,52 @@ FlowStateValue* FlowIPTracker::find_stats(const SfIp* src_addr, const SfIp* dst_
         *swapped = 1;
     }
 
-    value = (FlowStateValue*)ip_map->get_user_data(&key);
-    if ( value )
+    if ( top_pairs )
     {
-        strncpy(value->appid_name, appid_name, sizeof(value->appid_name) - 1);
-        value->appid_name[sizeof(value->appid_name) - 1] = '\0';
-        if ( *swapped )
+        // state changes alone don't make a pair heavy
+        if ( bytes )
         {
-            value->port_a = dst_port;
-            value->port_b = src_port;
+            bool replaced;
+            value = &top_pairs->update(key, bytes, replaced).value;
+
+            if ( replaced )
+                pmstats.flow_tracker_sketch_replacements++;
         }
+        else if ( HostPairTopK::Entry* e = top_pairs->find(key) )
+            value = &e->value;
         else
+            return nullptr;
+    }
+    else
+    {
+        value = (FlowStateValue*)ip_map->get_user_data(&key);
+
+        if ( !value )
         {
-            value->port_a = src_port;
-            value->port_b = dst_port;
+            if ( ip_map->insert(&key, nullptr) != HASH_OK )
+                return nullptr;
+            value = (FlowStateValue*)ip_map->get_user_data();
+            static constexpr FlowStateValue fsv_empty_value;
+            *value = fsv_empty_value;
+            return value;
         }
-        value->protocol = ip_protocol;
-        value->total_flow_latency = flow_latency;
-        value->total_rule_latency = rule_latency;
+    }
+
+    strncpy(value->appid_name, appid_name, sizeof(value->appid_name) - 1);
+    value->appid_name[sizeof(value->appid_name) - 1] = '\0';
+    if ( *swapped )
+    {
+        value->port_a = dst_port;
+        value->port_b = src_port;
     }
     else
     {
-        if ( ip_map->insert(&key, nullptr) != HASH_OK )
-            return nullptr;
-        value = (FlowStateValue*)ip_map->get_user_data();
-        static constexpr FlowStateValue fsv_empty_value;
-        *value = fsv_empty_value;
+        value->port_a = src_port;
+        value->port_b = dst_port;
     }
+    value->protocol = ip_protocol;
+    value->total_flow_latency = flow_latency;
+    value->total_rule_latency = rule_latency;
 
     return value;
 }
@@ -101,6 +121,10 @@ bool FlowIPTracker::initialize(size_t new_memcap)
 {
     bool need_pruning = false;
 
+    // sketch memory is fixed
+    if ( top_pairs )
+        return false;
+
     if ( !ip_map )
     {
         ip_map = new XHash(DEFAULT_XHASH_NROWS, sizeof(FlowStateKey),
@@ -158,25 +182,58 @@ FlowIPTracker::FlowIPTracker(PerfConfig* perf) : PerfTracker(perf, TRACKER_NAME,
     formatter->register_field("protocol", protocol);
     formatter->register_field("flow_latency", flow_latency);
     formatter->register_field("rule_latency", rule_latency);
+
+    if ( perf->flow_ip_sketch )
+    {
+        formatter->register_field("bytes_error", &pair_error);
+        formatter->register_field("host_a_packets", &host_a_packets);
+        formatter->register_field("host_a_bytes", &host_a_bytes);
+        formatter->register_field("host_b_packets", &host_b_packets);
+        formatter->register_field("host_b_bytes", &host_b_bytes);
+    }
     formatter->finalize_fields();
     stats.total_packets = stats.total_bytes = 0;
 
     memcap = perf->flowip_memcap;
-    ip_map = new XHash(DEFAULT_XHASH_NROWS, sizeof(FlowStateKey), sizeof(FlowStateValue), memcap);
+
+    if ( perf->flow_ip_sketch )
+    {
+        // seeded per thread so crafted addresses can't target collisions
+        std::random_device rd;
+        uint64_t seed = ((uint64_t)rd() << 32) | rd();
+
+        top_pairs = new HostPairTopK(perf->flow_ip_top, seed);
+        host_counts = new HostCounts(perf->flow_ip_host_width, SKETCH_DEPTH, ~seed);
+    }
+    else
+        ip_map = new XHash(DEFAULT_XHASH_NROWS, sizeof(FlowStateKey), sizeof(FlowStateValue), memcap);
 }
 
 FlowIPTracker::~FlowIPTracker()
 {
-    const XHashStats& tmp_stats = ip_map->get_stats();
-    pmstats.flow_tracker_creates = tmp_stats.nodes_created;
-    pmstats.flow_tracker_total_deletes = tmp_stats.memcap_deletes;
-    pmstats.flow_tracker_prunes = tmp_stats.memcap_prunes;
+    if ( ip_map )
+    {
+        const XHashStats& tmp_stats = ip_map->get_stats();
+        pmstats.flow_tracker_creates = tmp_stats.nodes_created;
+        pmstats.flow_tracker_total_deletes = tmp_stats.memcap_deletes;
+        pmstats.flow_tracker_prunes = tmp_stats.memcap_prunes;
+    }
 
     delete ip_map;
+    delete top_pairs;
+    delete host_counts;
 }
 
 void FlowIPTracker::reset()
-{ ip_map->clear_hash(); }
+{
+    if ( top_pairs )
+    {
+        top_pairs->clear();
+        host_counts->clear();
+    }
+    else
+        ip_map->clear_hash();
+}
 
 void FlowIPTracker::update(Packet* p)
 {
@@ -225,8 +282,14 @@ void FlowIPTracker::update(Packet* p)
         else if (p->ptrs.udph)
             type = SFS_TYPE_UDP;
 
+        if ( host_counts )
+        {
+            host_counts->update(*src_addr, len);
+            host_counts->update(*dst_addr, len);
+        }
+
         FlowStateValue* value = find_stats(src_addr, dst_addr, &swapped, curr_appid_name,
-            src_port, dst_port, ip_protocol, curr_flow_latency, curr_rule_latency);
+            src_port, dst_port, ip_protocol, curr_flow_latency, curr_rule_latency, len);
         if ( !value )
             return;
 
@@ -247,31 +310,57 @@ void FlowIPTracker::update(Packet* p)
     }
 }
 
-void FlowIPTracker::process(bool)
+void FlowIPTracker::write_entry(const FlowStateKey& key, const FlowStateValue& cur_stats)
 {
-    for (auto node = ip_map->find_first_node(); node; node = ip_map->find_next_node())
-    {
-        FlowStateKey* key = (FlowStateKey*)node->key;
-        FlowStateValue* cur_stats = (FlowStateValue*)node->data;
+    key.ipA.ntop(ip_a, sizeof(ip_a));
+    key.ipB.ntop(ip_b, sizeof(ip_b));
 
-        key->ipA.ntop(ip_a, sizeof(ip_a));
-        key->ipB.ntop(ip_b, sizeof(ip_b));
+    if (cur_stats.appid_name[0] != '\0')
+        strncpy(appid_name, cur_stats.appid_name, sizeof(appid_name) - 1);
+    else
+        strncpy(appid_name, "APPID_NONE", sizeof(appid_name) - 1);
+    appid_name[sizeof(appid_name) - 1] = '\0';
 
-        if (cur_stats->appid_name[0] != '\0')
-            strncpy(appid_name, cur_stats->appid_name, sizeof(appid_name) - 1);
-        else
-            strncpy(appid_name, "APPID_NONE", sizeof(appid_name) - 1);
-        appid_name[sizeof(appid_name) - 1] = '\0';
+    std::snprintf(port_a, sizeof(port_a), "%d", cur_stats.port_a);
+    std::snprintf(port_b, sizeof(port_b), "%d", cur_stats.port_b);
+    std::snprintf(protocol, sizeof(protocol), "%d", cur_stats.protocol);
+    std::snprintf(flow_latency, sizeof(flow_latency), "%lu", cur_stats.total_flow_latency);
+    std::snprintf(rule_latency, sizeof(rule_latency), "%lu", cur_stats.total_rule_latency);
 
-        std::snprintf(port_a, sizeof(port_a), "%d", cur_stats->port_a);
-        std::snprintf(port_b, sizeof(port_b), "%d", cur_stats->port_b);
-        std::snprintf(protocol, sizeof(protocol), "%d", cur_stats->protocol);
-        std::snprintf(flow_latency, sizeof(flow_latency), "%lu", cur_stats->total_flow_latency);
-        std::snprintf(rule_latency, sizeof(rule_latency), "%lu", cur_stats->total_rule_latency);
+    memcpy(&stats, &cur_stats, sizeof(stats));
 
-        memcpy(&stats, cur_stats, sizeof(stats));
+    write();
+}
 
-        write();
+void FlowIPTracker::process_sketch()
+{
+    std::vector<const HostPairTopK::Entry*> entries;
+    entries.reserve(top_pairs->size());
+
+    for ( unsigned i = 0; i < top_pairs->size(); ++i )
+        entries.emplace_back(&(*top_pairs)[i]);
+
+    std::sort(entries.begin(), entries.end(),
+        [](const HostPairTopK::Entry* lhs, const HostPairTopK::Entry* rhs)
+        { return lhs->count > rhs->count; });
+
+    for ( const auto* e : entries )
+    {
+        pair_error = e->error;
+        host_counts->estimate(e->key.ipA, host_a_packets, host_a_bytes);
+        host_counts->estimate(e->key.ipB, host_b_packets, host_b_bytes);
+        write_entry(e->key, e->value);
+    }
+}
+
+void FlowIPTracker::process(bool)
+{
+    if ( top_pairs )
+        process_sketch();
+    else
+    {
+        for (auto node = ip_map->find_first_node(); node; node = ip_map->find_next_node())
+            write_entry(*(FlowStateKey*)node->key, *(FlowStateValue*)node->data);
     }
 
     if ( !(perf_flags & PERF_SUMMARY) )
@@ -285,7 +374,7 @@ int FlowIPTracker::update_state(const SfIp* src_addr, const SfIp* dst_addr,
     int swapped;
 
     FlowStateValue* value = find_stats(src_addr, dst_addr, &swapped, appid_name, src_port, dst_port,
-        ip_protocol, flow_latency, rule_latency);
+        ip_protocol, flow_latency, rule_latency, 0);
     if ( !value )
         return 1;
 
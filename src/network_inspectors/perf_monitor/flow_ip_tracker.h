@@ -24,6 +24,7 @@
 #include "hash/xhash.h"
 
 #include "network_inspectors/appid/application_ids.h"
+#include "sfip/sf_ip.h"
 #include "perf_tracker.h"
 
 enum FlowState
@@ -50,6 +51,12 @@ struct TrafficStats
     PegCount  bytes_b_to_a;
 };
 
+struct FlowStateKey
+{
+    snort::SfIp ipA;
+    snort::SfIp ipB;
+};
+
 struct FlowStateValue
 {
     char appid_name[40] = "APPID_NONE";
@@ -64,6 +71,9 @@ struct FlowStateValue
     PegCount state_changes[SFS_STATE_MAX] = {};
 };
 
+class HostCounts;
+class HostPairTopK;
+
 class FlowIPTracker : public PerfTracker
 {
 public:
@@ -82,7 +92,12 @@ public:
 
 private:
     FlowStateValue stats;
-    snort::XHash* ip_map;
+    snort::XHash* ip_map = nullptr;
+    HostPairTopK* top_pairs = nullptr;
+    HostCounts* host_counts = nullptr;
+    PegCount pair_error = 0;
+    PegCount host_a_packets = 0, host_a_bytes = 0;
+    PegCount host_b_packets = 0, host_b_bytes = 0;
     char ip_a[41], ip_b[41], port_a[8], port_b[8], protocol[8];
     char appid_name[40] = "APPID_NONE", flow_latency[20] = {}, rule_latency[20] = {};
     int perf_flags;
@@ -90,7 +105,9 @@ private:
     size_t memcap;
     FlowStateValue* find_stats(const snort::SfIp* src_addr, const snort::SfIp* dst_addr,
         int* swapped, const char* appid_name, uint16_t src_port, uint16_t dst_port,
-        uint8_t ip_protocol, uint64_t flow_latency, uint64_t rule_latency);
+        uint8_t ip_protocol, uint64_t flow_latency, uint64_t rule_latency, uint64_t bytes);
+    void process_sketch();
+    void write_entry(const FlowStateKey&, const FlowStateValue&);
     void write_stats();
     void display_stats();
 
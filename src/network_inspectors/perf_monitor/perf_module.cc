@@ -73,6 +73,15 @@ static const Parameter s_params[] =
     { "flow_ip_all", Parameter::PT_BOOL, nullptr, "false",
       "enable every stat of flow_ip profiling on host pairs" },
 
+    { "flow_ip_mode", Parameter::PT_ENUM, "table | sketch", "table",
+      "track every host pair up to flow_ip_memcap or only the heaviest in fixed memory" },
+
+    { "flow_ip_top", Parameter::PT_INT, "1:65535", "1024",
+      "host pairs kept by the flow_ip sketch" },
+
+    { "flow_ip_host_width", Parameter::PT_INT, "64:16777216", "16384",
+      "counters per row of the flow_ip per host sketch" },
+
     { "packets", Parameter::PT_INT, "0:max32", "10000",
       "minimum packets to report" },
 
@@ -94,12 +103,18 @@ static const Parameter s_params[] =
     { "modules", Parameter::PT_LIST, module_params, nullptr,
       "gather statistics from the specified modules" },
 
-    { "format", Parameter::PT_ENUM, "csv | text | json", "csv",
+    { "format", Parameter::PT_ENUM, "csv | text | json | binary", "csv",
       "output format for stats" },
 
     { "summary", Parameter::PT_BOOL, nullptr, "false",
       "output summary at shutdown" },
 
+    { "stats_segment", Parameter::PT_STRING, nullptr, nullptr,
+      "name of a shared memory segment to publish all peg counts to, eg /snort_stats" },
+
+    { "stats_segment_seconds", Parameter::PT_INT, "1:max32", "1",
+      "stats segment update interval" },
+
     { nullptr, Parameter::PT_MAX, nullptr, nullptr, nullptr }
 };
 
@@ -303,6 +318,18 @@ bool PerfMonModule::set(const char*, Value& v, SnortConfig*)
         if ( v.get_bool() )
             config->flow_ip_all = true;
     }
+    else if ( v.is("flow_ip_mode") )
+    {
+        config->flow_ip_sketch = v.get_uint8() == 1;
+    }
+    else if ( v.is("flow_ip_top") )
+    {
+        config->flow_ip_top = v.get_uint16();
+    }
+    else if ( v.is("flow_ip_host_width") )
+    {
+        config->flow_ip_host_width = v.get_uint32();
+    }
     else if ( v.is("flow_ip_memcap") )
     {
         config->flowip_memcap = v.get_size();
@@ -335,6 +362,14 @@ bool PerfMonModule::set(const char*, Value& v, SnortConfig*)
         if ( v.get_bool() )
             config->perf_flags |= PERF_SUMMARY;
     }
+    else if ( v.is("stats_segment") )
+    {
+        config->stats_segment = v.get_string();
+    }
+    else if ( v.is("stats_segment_seconds") )
+    {
+        config->stats_segment_seconds = v.get_uint32();
+    }
     else if ( v.is("modules") )
     {
         return true;
@@ -364,6 +399,13 @@ bool PerfMonModule::end(const char* fqn, int idx, SnortConfig* sc)
     if ( idx != 0 && strcmp(fqn, "perf_monitor.modules") == 0 )
         return config->modules.back().confirm_parse();
 
+    if ( strcmp(fqn, "perf_monitor") == 0 and config->format == PerfFormat::BINARY
+        and config->output == PerfOutput::TO_CONSOLE )
+    {
+        ParseError("perf_monitor binary format can't be output to the console");
+        return false;
+    }
+
     if ( config->flow_ip_all )
     {
         packet_latency::set_force_enable(true);
@@ -21,6 +21,7 @@
 #ifndef PERF_MODULE_H
 #define PERF_MODULE_H
 
+#include <string>
 #include <unordered_map>
 
 #include "framework/module.h"
@@ -47,6 +48,7 @@ enum class PerfFormat
     CSV,
     TEXT,
     JSON,
+    BINARY,
     MOCK
 };
 
@@ -94,10 +96,15 @@ struct PerfConfig
     int flow_max_port_to_track = 0;
     size_t flowip_memcap = 0;
     bool flow_ip_all = false;
+    bool flow_ip_sketch = false;
+    unsigned flow_ip_top = 1024;
+    unsigned flow_ip_host_width = 16384;
     PerfFormat format = PerfFormat::CSV;
     PerfOutput output = PerfOutput::TO_FILE;
     std::vector<ModuleConfig> modules;
     std::vector<snort::Module*> mods_to_prep;
+    std::string stats_segment;
+    unsigned stats_segment_seconds = 1;
     PerfConstraints* constraints;
 
     PerfConfig() { constraints = new PerfConstraints; }
@@ -41,6 +41,8 @@
 #include "log/messages.h"
 #include "main/analyzer_command.h"
 #include "main/snort_config.h"
+#include "main/thread_config.h"
+#include "managers/plugin_manager.h"
 #include "profiler/profiler.h"
 #include "protocols/packet.h"
 #include "pub_sub/intrinsic_event_ids.h"
@@ -158,6 +160,12 @@ private:
 PerfMonitor::PerfMonitor(PerfConfig* pcfg) : config(pcfg)
 { assert (config != nullptr); }
 
+PerfMonitor::~PerfMonitor()
+{
+    delete stats_segment;
+    delete config;
+}
+
 static const char* to_string(const PerfOutput& po)
 {
     switch (po)
@@ -181,6 +189,8 @@ static const char* to_string(const PerfFormat& pf)
             return "csv";
         case PerfFormat::JSON:
             return "json";
+        case PerfFormat::BINARY:
+            return "binary";
         case PerfFormat::MOCK:
             return "mock";
     }
@@ -199,7 +209,16 @@ void PerfMonitor::show(const SnortConfig*) const
 
     if ( ConfigLogger::log_flag("flow_ip", config->perf_flags & PERF_FLOWIP) )
     {
-        ConfigLogger::log_value("flow_ip_memcap", config->flowip_memcap);
+        ConfigLogger::log_value("flow_ip_mode", config->flow_ip_sketch ? "sketch" : "table");
+
+        if ( config->flow_ip_sketch )
+        {
+            ConfigLogger::log_value("flow_ip_top", config->flow_ip_top);
+            ConfigLogger::log_value("flow_ip_host_width", config->flow_ip_host_width);
+        }
+        else
+            ConfigLogger::log_value("flow_ip_memcap", config->flowip_memcap);
+
         ConfigLogger::log_value("flow_ip_all", config->flow_ip_all);
     }
 
@@ -209,6 +228,12 @@ void PerfMonitor::show(const SnortConfig*) const
 
     ConfigLogger::log_value("output", to_string(config->output));
     ConfigLogger::log_value("format", to_string(config->format));
+
+    if ( !config->stats_segment.empty() )
+    {
+        ConfigLogger::log_value("stats_segment", config->stats_segment.c_str());
+        ConfigLogger::log_value("stats_segment_seconds", config->stats_segment_seconds);
+    }
 }
 
 void PerfMonitor::disable_tracker(size_t i)
@@ -236,7 +261,20 @@ bool PerfMonitor::configure(SnortConfig* sc)
     new PerfRotateHandler(*this, *sc);
     new FlowIPDataHandler(*this, *sc);
 
-    return config->resolve();
+    if ( !config->resolve() )
+        return false;
+
+    if ( !config->stats_segment.empty() )
+    {
+        stats_segment = new StatsSegment(config->stats_segment, ThreadConfig::get_instance_max());
+
+        if ( !stats_segment->create(PluginManager::get_all_modules(sc)) )
+        {
+            delete stats_segment;
+            stats_segment = nullptr;
+        }
+    }
+    return true;
 }
 
 void PerfMonitor::tinit()
@@ -294,7 +332,7 @@ bool PerfMonReloadTuner::tinit()
 
 bool PerfMonReloadTuner::tune_resources(unsigned work_limit)
 {
-    if (t_constraints->flow_ip_enabled)
+    if (t_constraints->flow_ip_enabled and flow_ip_tracker->get_ip_map())
     {
         unsigned num_freed = 0;
         int result = flow_ip_tracker->get_ip_map()->tune_memory_resources(work_limit, num_freed);
@@ -307,6 +345,9 @@ bool PerfMonReloadTuner::tune_resources(unsigned work_limit)
 
 void PerfMonitor::tterm()
 {
+    if ( stats_segment )
+        stats_segment->publish();
+
     if (trackers)
     {
         while (!trackers->empty())
@@ -479,10 +520,31 @@ void PerfMonitor::eval(Packet* p)
         }
     }
 
+    if ( stats_segment )
+        publish_stats(p);
+
     if (p)
         ++pmstats.total_packets;
 }
 
+void PerfMonitor::publish_stats(Packet* p)
+{
+    static THREAD_LOCAL time_t last_publish = 0;
+
+    // idle threads always publish so their counts don't go stale; packet
+    // time only advances with packets
+    if ( p )
+    {
+        time_t now = p->pkth->ts.tv_sec;
+
+        if ( now - last_publish < (time_t)config->stats_segment_seconds )
+            return;
+
+        last_publish = now;
+    }
+    stats_segment->publish();
+}
+
 bool PerfMonitor::ready_to_process(Packet* p)
 {
     static THREAD_LOCAL time_t sample_time = 0;
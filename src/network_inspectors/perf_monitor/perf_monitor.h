@@ -28,6 +28,7 @@
 #include "flow_ip_tracker.h"
 #include "flow_tracker.h"
 #include "perf_module.h"
+#include "stats_segment.h"
 
 class FlowIPDataHandler;
 
@@ -35,7 +36,7 @@ class PerfMonitor : public snort::Inspector
 {
 public:
     PerfMonitor(PerfConfig*);
-    ~PerfMonitor() override { delete config; }
+    ~PerfMonitor() override;
 
     bool configure(snort::SnortConfig*) override;
     void show(const snort::SnortConfig*) const override;
@@ -65,7 +66,10 @@ public:
 
 private:
     PerfConfig* const config;
+    StatsSegment* stats_segment = nullptr;
+
     void disable_tracker(size_t);
+    void publish_stats(snort::Packet*);
 };
 
 #endif
@@ -32,6 +32,7 @@ static const PegInfo perf_module_pegs[] =
     { CountType::SUM, "flow_tracker_total_deletes", "flow trackers deleted to stay below memcap limit" },
     { CountType::SUM, "flow_tracker_reload_deletes", "flow trackers deleted due to memcap change on config reload" },
     { CountType::SUM, "flow_tracker_prunes", "flow trackers pruned for reuse by new flows" },
+    { CountType::SUM, "flow_tracker_sketch_replacements", "host pairs replaced by heavier ones in the flow ip sketch" },
     { CountType::END, nullptr, nullptr },
 };
 
@@ -42,6 +43,7 @@ struct PerfPegStats
     PegCount flow_tracker_total_deletes;
     PegCount flow_tracker_reload_deletes;
     PegCount flow_tracker_prunes;
+    PegCount flow_tracker_sketch_replacements;
 };
 
 #endif
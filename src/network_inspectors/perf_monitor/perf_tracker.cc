@@ -35,6 +35,7 @@
 #include "utils/util.h"
 #include "utils/util_cstring.h"
 
+#include "binary_formatter.h"
 #include "csv_formatter.h"
 #include "json_formatter.h"
 #include "text_formatter.h"
@@ -51,6 +52,7 @@ PerfTracker::PerfTracker(PerfConfig* config, const char* tracker_name, unsigned
         case PerfFormat::CSV: formatter = new CSVFormatter(tracker_name); break;
         case PerfFormat::TEXT: formatter = new TextFormatter(tracker_name); break;
         case PerfFormat::JSON: formatter = new JSONFormatter(tracker_name); break;
+        case PerfFormat::BINARY: formatter = new BinaryFormatter(tracker_name); break;
 #ifdef UNIT_TEST
         case PerfFormat::MOCK: formatter = new MockFormatter(tracker_name); break;
 #endif
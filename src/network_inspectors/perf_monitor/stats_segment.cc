@@ -0,0 +1,327 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// stats_segment.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "stats_segment.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <string>
+
+#include "framework/module.h"
+#include "log/messages.h"
+#include "main/thread.h"
+#include "utils/util.h"
+
+#ifdef UNIT_TEST
+#include "catch/snort_catch.h"
+#endif
+
+using namespace snort;
+
+static inline uint64_t align(uint64_t n, uint64_t a)
+{ return (n + a - 1) & ~(a - 1); }
+
+StatsSegment::StatsSegment(const std::string& s, unsigned n) : name(s), num_threads(n)
+{ }
+
+StatsSegment::~StatsSegment()
+{
+    if ( header )
+    {
+        header->state.store(SSS_RETIRED, std::memory_order_release);
+        munmap(base, size);
+    }
+
+    if ( fd < 0 )
+        return;
+
+    // after a reload the name may already belong to the new segment
+    struct stat ours, named;
+    int tmp = shm_open(name.c_str(), O_RDONLY, 0);
+
+    if ( tmp >= 0 )
+    {
+        if ( !fstat(fd, &ours) and !fstat(tmp, &named) and
+            ours.st_dev == named.st_dev and ours.st_ino == named.st_ino )
+            shm_unlink(name.c_str());
+
+        close(tmp);
+    }
+    close(fd);
+}
+
+bool StatsSegment::create(const std::list<Module*>& mods)
+{
+    std::vector<const PegInfo*> pegs;
+    uint64_t strings_size = 0;
+    unsigned num_pegs = 0;
+
+    for ( auto* mod : mods )
+    {
+        const PegInfo* pi = mod->get_pegs();
+
+        if ( !pi or !pi->name or mod->stats_are_aggregated() )
+            continue;
+
+        unsigned n = 0;
+        strings_size += strlen(mod->get_name()) + 1;
+
+        for ( ; pi[n].name; ++n )
+            strings_size += strlen(pi[n].name) + 1;
+
+        sources.push_back({ mod, num_pegs, n });
+        pegs.push_back(pi);
+        num_pegs += n;
+
+        if ( mod->counts_need_prep() )
+            mods_to_prep.push_back(mod);
+    }
+
+    uint64_t modules_off = align(sizeof(StatsSegmentHeader), 8);
+    uint64_t pegs_off = modules_off + sources.size() * sizeof(StatsSegmentModule);
+    uint64_t strings_off = pegs_off + num_pegs * sizeof(StatsSegmentPeg);
+    uint64_t threads_off = align(strings_off + strings_size, 64);
+    uint64_t thread_size = align(sizeof(StatsSegmentThread) + num_pegs * sizeof(uint64_t), 64);
+
+    size = threads_off + num_threads * thread_size;
+
+    // a stale segment from an earlier run is simply replaced; readers of
+    // a segment still live from before a reload keep their mapping until
+    // it is retired
+    shm_unlink(name.c_str());
+    fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+
+    if ( fd < 0 )
+    {
+        ErrorMessage("perf_monitor: can't create stats segment %s: %s\n",
+            name.c_str(), get_error(errno));
+        return false;
+    }
+
+    if ( ftruncate(fd, size) )
+    {
+        ErrorMessage("perf_monitor: can't size stats segment %s: %s\n",
+            name.c_str(), get_error(errno));
+        return false;
+    }
+
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if ( p == MAP_FAILED )
+    {
+        ErrorMessage("perf_monitor: can't map stats segment %s: %s\n",
+            name.c_str(), get_error(errno));
+        return false;
+    }
+
+    base = (uint8_t*)p;
+    header = new (base) StatsSegmentHeader();
+
+    auto* mod_tab = (StatsSegmentModule*)(base + modules_off);
+    auto* peg_tab = (StatsSegmentPeg*)(base + pegs_off);
+    char* strings = (char*)(base + strings_off);
+    uint32_t str = 0;
+
+    auto add_string = [&](const char* s)
+    {
+        uint32_t off = str;
+        size_t len = strlen(s) + 1;
+        memcpy(strings + str, s, len);
+        str += len;
+        return off;
+    };
+
+    for ( unsigned i = 0; i < sources.size(); ++i )
+    {
+        const Source& src = sources[i];
+        mod_tab[i].name = add_string(src.mod->get_name());
+        mod_tab[i].first_peg = src.first_peg;
+        mod_tab[i].num_pegs = src.num_pegs;
+
+        for ( unsigned j = 0; j < src.num_pegs; ++j )
+        {
+            peg_tab[src.first_peg + j].name = add_string(pegs[i][j].name);
+            peg_tab[src.first_peg + j].type = (uint8_t)pegs[i][j].type;
+        }
+    }
+    assert(str == strings_size);
+
+    for ( unsigned i = 0; i < num_threads; ++i )
+        new (base + threads_off + i * thread_size) StatsSegmentThread();
+
+    memcpy(header->magic, STATS_SEGMENT_MAGIC, sizeof(header->magic));
+    header->version = STATS_SEGMENT_VERSION;
+    header->size = size;
+    header->pid = getpid();
+    header->created = time(nullptr);
+    header->num_threads = num_threads;
+    header->num_modules = sources.size();
+    header->num_pegs = num_pegs;
+    header->thread_size = thread_size;
+    header->modules = modules_off;
+    header->pegs = pegs_off;
+    header->strings = strings_off;
+    header->threads = threads_off;
+
+    header->state.store(SSS_LIVE, std::memory_order_release);
+    return true;
+}
+
+StatsSegmentThread* StatsSegment::get_thread(unsigned id) const
+{ return (StatsSegmentThread*)(base + header->threads + id * header->thread_size); }
+
+void StatsSegment::publish()
+{
+    unsigned id = get_instance_id();
+
+    if ( !header or id >= num_threads )
+        return;
+
+    for ( auto* mod : mods_to_prep )
+        mod->prep_counts(false);
+
+    StatsSegmentThread* t = get_thread(id);
+    uint64_t* out = (uint64_t*)(t + 1);
+    uint64_t seq = t->seq.load(std::memory_order_relaxed);
+
+    t->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for ( const auto& src : sources )
+    {
+        // global counts are shared so only the first thread reports them
+        if ( src.mod->global_stats() and id )
+            continue;
+
+        const PegCount* pc = src.mod->get_counts();
+
+        if ( pc )
+            memcpy(out + src.first_peg, pc, src.num_pegs * sizeof(*out));
+    }
+
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+
+    ++t->updates;
+    t->sec = now.tv_sec;
+    t->usec = now.tv_usec;
+
+    t->seq.store(seq + 2, std::memory_order_release);
+}
+
+//-------------------------------------------------------------------------
+// unit tests
+//-------------------------------------------------------------------------
+
+#ifdef UNIT_TEST
+
+static const PegInfo seg_pegs[] =
+{
+    { CountType::SUM, "alpha", "first" },
+    { CountType::MAX, "beta", "second" },
+    { CountType::END, nullptr, nullptr }
+};
+
+class SegModule : public Module
+{
+public:
+    SegModule() : Module("seg_mod", "stats segment test module") { }
+
+    const PegInfo* get_pegs() const override
+    { return seg_pegs; }
+
+    PegCount* get_counts() const override
+    { return (PegCount*)counts; }
+
+    Usage get_usage() const override
+    { return INSPECT; }
+
+    PegCount counts[2] = { };
+};
+
+TEST_CASE("stats segment layout and publish", "[perf_monitor]")
+{
+    std::string name = "/snort_stats_test_" + std::to_string(getpid());
+    StatsSegment* seg = new StatsSegment(name, 1);
+
+    SegModule mod;
+    std::list<Module*> mods { &mod };
+
+    REQUIRE(seg->create(mods));
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    REQUIRE(fd >= 0);
+
+    struct stat st;
+    REQUIRE(!fstat(fd, &st));
+
+    auto* p = (uint8_t*)mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    REQUIRE(p != MAP_FAILED);
+    close(fd);
+
+    auto* h = (const StatsSegmentHeader*)p;
+    CHECK(!memcmp(h->magic, STATS_SEGMENT_MAGIC, sizeof(h->magic)));
+    CHECK(h->state.load() == SSS_LIVE);
+    CHECK(h->num_modules == 1);
+    CHECK(h->num_pegs == 2);
+    CHECK(h->thread_size % 64 == 0);
+
+    auto* mt = (const StatsSegmentModule*)(p + h->modules);
+    auto* pt = (const StatsSegmentPeg*)(p + h->pegs);
+    auto* strings = (const char*)(p + h->strings);
+
+    CHECK(!strcmp(strings + mt[0].name, "seg_mod"));
+    CHECK(!strcmp(strings + pt[1].name, "beta"));
+    CHECK(pt[1].type == CountType::MAX);
+
+    mod.counts[0] = 7;
+    mod.counts[1] = 11;
+    seg->publish();
+
+    auto* t = (const StatsSegmentThread*)(p + h->threads);
+    auto* c = (const uint64_t*)(t + 1);
+
+    CHECK(t->seq.load() == 2);
+    CHECK(t->updates == 1);
+    CHECK(c[0] == 7);
+    CHECK(c[1] == 11);
+
+    delete seg;
+    CHECK(h->state.load() == SSS_RETIRED);
+    CHECK(shm_open(name.c_str(), O_RDONLY, 0) < 0);
+
+    munmap(p, st.st_size);
+}
+
+#endif
+
@@ -0,0 +1,78 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// stats_segment.h
+
+#ifndef STATS_SEGMENT_H
+#define STATS_SEGMENT_H
+
+// publishes the peg counts of every module to a named shared memory segment
+// laid out per stats_segment_defs.h.  the segment is built by the main
+// thread when perf_monitor is configured; each packet thread then copies its
+// own counts into its block, which is one memcpy per module and no
+// formatting.
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "stats_segment_defs.h"
+
+namespace snort
+{
+class Module;
+}
+
+class StatsSegment
+{
+public:
+    StatsSegment(const std::string& name, unsigned num_threads);
+    ~StatsSegment();
+
+    // build the layout for these modules; false if the segment can't be made
+    bool create(const std::list<snort::Module*>&);
+
+    // copy the calling packet thread's counts into its block
+    void publish();
+
+    const std::string& get_name() const
+    { return name; }
+
+private:
+    struct Source
+    {
+        snort::Module* mod;
+        unsigned first_peg;
+        unsigned num_pegs;
+    };
+
+    StatsSegmentThread* get_thread(unsigned id) const;
+
+    std::string name;
+    std::vector<Source> sources;
+    std::vector<snort::Module*> mods_to_prep;
+
+    uint8_t* base = nullptr;
+    StatsSegmentHeader* header = nullptr;
+    size_t size = 0;
+    int fd = -1;
+    unsigned num_threads;
+};
+
+#endif
+
@@ -0,0 +1,108 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// stats_segment_defs.h
+
+#ifndef STATS_SEGMENT_DEFS_H
+#define STATS_SEGMENT_DEFS_H
+
+// binary layout of the shared memory segment written by
+// perf_monitor.stats_segment.  this is shared with tools/snort_stats so it
+// must not depend on anything else in snort.  all offsets are in bytes from
+// the start of the segment and all integers are in host byte order.
+//
+//   StatsSegmentHeader
+//   StatsSegmentModule[num_modules]
+//   StatsSegmentPeg[num_pegs]       grouped by module, in peg info order
+//   strings                         nul terminated names
+//   thread blocks[num_threads]      thread_size bytes each
+//
+// a thread block is a StatsSegmentThread followed by num_pegs counts in peg
+// table order.  everything but the thread blocks is fixed before state goes
+// live.  each thread block is a seqlock: the packet thread makes seq odd,
+// copies its counts, and makes seq even again.  readers copy a block and
+// retry if seq was odd or changed meanwhile.  counts of modules with global
+// stats are shared by all threads so they are only in the first block.
+// when the segment is replaced on reload or snort exits state goes to
+// retired and readers should reopen the segment by name.
+
+#include <atomic>
+#include <cstdint>
+
+#define STATS_SEGMENT_MAGIC "SNORTPEG"
+#define STATS_SEGMENT_VERSION 1
+
+enum StatsSegmentState : uint32_t
+{
+    SSS_INIT,
+    SSS_LIVE,
+    SSS_RETIRED
+};
+
+struct StatsSegmentHeader
+{
+    char magic[8];
+    uint32_t version;
+    std::atomic<uint32_t> state;
+
+    uint64_t size;              // of the whole segment
+    uint64_t pid;
+    uint64_t created;           // unix time
+
+    uint32_t num_threads;
+    uint32_t num_modules;
+    uint32_t num_pegs;
+    uint32_t thread_size;       // a multiple of 64
+
+    uint64_t modules;
+    uint64_t pegs;
+    uint64_t strings;
+    uint64_t threads;
+};
+
+struct StatsSegmentModule
+{
+    uint32_t name;              // offset into strings
+    uint32_t first_peg;
+    uint32_t num_pegs;
+    uint32_t reserved;
+};
+
+struct StatsSegmentPeg
+{
+    uint32_t name;              // offset into strings
+    uint8_t type;               // CountType: 1 = sum, 2 = now, 3 = max
+    uint8_t reserved[3];
+};
+
+struct StatsSegmentThread
+{
+    std::atomic<uint64_t> seq;
+    uint64_t updates;
+    uint64_t sec;               // wall clock time of the last update
+    uint64_t usec;
+    uint64_t reserved[4];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+    "stats segment requires lock free 64 bit atomics");
+
+static_assert(sizeof(StatsSegmentThread) == 64, "thread block header is one cache line");
+
+#endif
+
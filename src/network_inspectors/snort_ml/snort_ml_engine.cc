@@ -95,6 +95,9 @@ static const Parameter snort_ml_engine_params[] =
     { "cache_memcap", Parameter::PT_INT, "0:maxSZ", "0",
       "maximum memory for verdict cache in bytes, 0 = disabled" },
 
+    { "batch_size", Parameter::PT_INT, "0:256", "0",
+      "maximum number of inputs from a packet classified together, 0 = disabled" },
+
     { nullptr, Parameter::PT_MAX, nullptr, nullptr, nullptr }
 };
 
@@ -105,6 +108,9 @@ static const PegInfo peg_names[] =
     { CountType::SUM, "filter_matches", "total filter matches" },
     { CountType::SUM, "filter_allows", "total filter allows" },
     { CountType::SUM, "libml_calls", "total libml calls" },
+    { CountType::SUM, "batches", "total batched classifications" },
+    { CountType::SUM, "batched_inputs", "total inputs classified in batches" },
+    { CountType::MAX, "batch_max", "maximum number of inputs in a batch" },
     { CountType::END, nullptr, nullptr }
 };
 
@@ -136,6 +142,9 @@ bool SnortMLEngineModule::set(const char*, Value& v, SnortConfig*)
     else if (v.is("cache_memcap"))
         conf.cache_memcap = v.get_size();
 
+    else if (v.is("batch_size"))
+        conf.batch_size = v.get_uint32();
+
     return true;
 }
 
@@ -209,6 +218,7 @@ void SnortMLEngine::show(const SnortConfig*) const
 {
     ConfigLogger::log_value("http_param_model", conf.http_param_model_path.c_str());
     ConfigLogger::log_value("cache_memcap", conf.cache_memcap);
+    ConfigLogger::log_value("batch_size", conf.batch_size);
 }
 
 bool SnortMLEngine::read_models()
@@ -304,33 +314,41 @@ static int filter_match_callback(void* f, void*, int, void* s, void*)
     return 1;
 }
 
-bool SnortMLEngine::scan(const char* buf, const size_t len, float& out) const
+bool SnortMLEngine::filter(const char* buf, const size_t len) const
 {
-    if (!snort_ml_ctx)
-        return false;
+    if (!mpse)
+        return true;
 
-    if (mpse)
-    {
-        snort_ml_engine_stats.filter_searches++;
+    snort_ml_engine_stats.filter_searches++;
 
-        SnortMLSearch search;
-        search.has_allow = conf.has_allow;
+    SnortMLSearch search;
+    search.has_allow = conf.has_allow;
 
-        mpse->find_all(buf, len, filter_match_callback,
-            false, (void*)&search);
+    mpse->find_all(buf, len, filter_match_callback,
+        false, (void*)&search);
 
-        if (!search.match)
-            return false;
+    if (!search.match)
+        return false;
 
-        snort_ml_engine_stats.filter_matches++;
+    snort_ml_engine_stats.filter_matches++;
 
-        if (search.allow)
-        {
-            snort_ml_engine_stats.filter_allows++;
-            return false;
-        }
+    if (search.allow)
+    {
+        snort_ml_engine_stats.filter_allows++;
+        return false;
     }
 
+    return true;
+}
+
+bool SnortMLEngine::scan(const char* buf, const size_t len, float& out) const
+{
+    if (!snort_ml_ctx)
+        return false;
+
+    if (!filter(buf, len))
+        return false;
+
     float res = 0;
     bool is_new = true;
 
@@ -349,6 +367,93 @@ bool SnortMLEngine::scan(const char* buf, const size_t len, float& out) const
     return true;
 }
 
+void SnortMLEngine::scan(const char* buf, const size_t len, const SnortMLClient& client,
+    const Packet* p) const
+{
+    if (!snort_ml_ctx)
+        return;
+
+    SnortMLContext& ctx = *snort_ml_ctx;
+
+    // the pending batch may still belong to an offloaded packet
+    if (conf.batch_size < 2 || (!ctx.batch.empty() && ctx.batch_packet != p))
+    {
+        float out = 0;
+
+        if (scan(buf, len, out))
+            client.process(buf, len, out);
+
+        return;
+    }
+
+    if (!filter(buf, len))
+        return;
+
+    const uint64_t key = fnv1a(buf, len);
+
+    if (ctx.cache && ctx.cache->count(key))
+    {
+        client.process(buf, len, ctx.cache->find_else_create(key));
+        return;
+    }
+
+    ctx.batch.push_back({ string(buf, len), key, &client });
+    ctx.batch_packet = p;
+
+    if (ctx.batch.size() >= conf.batch_size)
+        flush(p);
+}
+
+void SnortMLEngine::flush(const Packet* p) const
+{
+    if (!snort_ml_ctx || snort_ml_ctx->batch.empty() || snort_ml_ctx->batch_packet != p)
+        return;
+
+    SnortMLContext& ctx = *snort_ml_ctx;
+    const size_t num = ctx.batch.size();
+
+    snort_ml_engine_stats.batches++;
+    snort_ml_engine_stats.batched_inputs += num;
+
+    if (snort_ml_engine_stats.batch_max < num)
+        snort_ml_engine_stats.batch_max = num;
+
+    for (size_t i = 0; i < num; ++i)
+    {
+        SnortMLInput& in = ctx.batch[i];
+        const SnortMLInput* same = nullptr;
+
+        // repeated inputs within the batch are classified once
+        for (size_t j = 0; j < i && !same; ++j)
+        {
+            if (ctx.batch[j].key == in.key && ctx.batch[j].data == in.data)
+                same = &ctx.batch[j];
+        }
+
+        if (same)
+        {
+            in.result = same->result;
+            in.classified = same->classified;
+            continue;
+        }
+
+        snort_ml_engine_stats.libml_calls++;
+        in.classified = ctx.classifiers.run(in.data.c_str(), in.data.size(), in.result);
+
+        if (in.classified && ctx.cache)
+            ctx.cache->add(in.key, in.result);
+    }
+
+    for (const auto& in : ctx.batch)
+    {
+        if (in.classified)
+            in.client->process(in.data.c_str(), in.data.size(), in.result);
+    }
+
+    ctx.batch.clear();
+    ctx.batch_packet = nullptr;
+}
+
 //--------------------------------------------------------------------------
 // api stuff
 //--------------------------------------------------------------------------
@@ -424,4 +529,68 @@ TEST_CASE("SnortML tuner name", "[snort_ml_module]")
     REQUIRE(strcmp(tuner.name(), "SnortMLReloadTuner") == 0);
 }
 
+class SnortMLTestClient : public SnortMLClient
+{
+public:
+    void process(const char* buf, size_t len, float out) const override
+    { results.emplace_back(string(buf, len), out); }
+
+    mutable vector<pair<string, float>> results;
+};
+
+TEST_CASE("SnortML batch", "[snort_ml_module]")
+{
+    SnortMLEngineConfig conf;
+    conf.http_param_models = { "attack" };
+    conf.cache_memcap = 1024;
+    conf.batch_size = 3;
+
+    SnortMLEngine engine(conf);
+    engine.tinit();
+    memset(&snort_ml_engine_stats, 0, sizeof(snort_ml_engine_stats));
+
+    SnortMLTestClient client;
+    int pkts[2];
+    const Packet* p1 = reinterpret_cast<const Packet*>(&pkts[0]);
+    const Packet* p2 = reinterpret_cast<const Packet*>(&pkts[1]);
+
+    engine.scan("q=attack", 8, client, p1);
+    engine.scan("q=benign", 8, client, p1);
+    REQUIRE(client.results.empty());
+
+    SECTION("batch full")
+    {
+        engine.scan("q=attack", 8, client, p1);
+
+        REQUIRE(client.results.size() == 3);
+        CHECK(client.results[0].second == 1.0f);
+        CHECK(client.results[1].second == 0.0f);
+        CHECK(client.results[2].second == 1.0f);
+        CHECK(snort_ml_engine_stats.libml_calls == 2);
+        CHECK(snort_ml_engine_stats.batches == 1);
+        CHECK(snort_ml_engine_stats.batch_max == 3);
+    }
+
+    SECTION("end of packet")
+    {
+        engine.flush(p2);
+        REQUIRE(client.results.empty());
+
+        engine.scan("q=other", 7, client, p2);
+        REQUIRE(client.results.size() == 1);
+
+        engine.flush(p1);
+        REQUIRE(client.results.size() == 3);
+        CHECK(snort_ml_engine_stats.batched_inputs == 2);
+
+        engine.scan("q=attack", 8, client, p2);
+        REQUIRE(client.results.size() == 4);
+        CHECK(client.results[3].second == 1.0f);
+        CHECK(snort_ml_engine_stats.cache_hits == 1);
+        CHECK(snort_ml_engine_stats.libml_calls == 3);
+    }
+
+    engine.tterm();
+}
+
 #endif
@@ -26,8 +26,10 @@
 #endif
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "framework/inspector.h"
 #include "framework/module.h"
@@ -74,15 +76,45 @@ struct SnortMLEngineStats : public LruCacheLocalStats
     PegCount filter_matches;
     PegCount filter_allows;
     PegCount libml_calls;
+    PegCount batches;
+    PegCount batched_inputs;
+    PegCount batch_max;
 };
 
 typedef LruCacheLocal<uint64_t, float, std::hash<uint64_t>> SnortMLCache;
 typedef std::unordered_map<std::string, bool> SnortMLFilterMap;
 
+namespace snort
+{
+struct Packet;
+}
+
+// receives the classifier output for an input passed to SnortMLEngine::scan,
+// either right away or when the batch holding the input is flushed
+class SnortMLClient
+{
+public:
+    virtual ~SnortMLClient() = default;
+    virtual void process(const char*, size_t, float) const = 0;
+};
+
+struct SnortMLInput
+{
+    std::string data;
+    uint64_t key;
+    const SnortMLClient* client;
+    float result = 0;
+    bool classified = false;
+};
+
 struct SnortMLContext
 {
     libml::BinaryClassifierSet classifiers;
     std::unique_ptr<SnortMLCache> cache;
+
+    // inputs of the current packet waiting for batched classification
+    std::vector<SnortMLInput> batch;
+    const snort::Packet* batch_packet = nullptr;
 };
 
 struct SnortMLEngineConfig
@@ -92,6 +124,7 @@ struct SnortMLEngineConfig
     SnortMLFilterMap http_param_filters;
     bool has_allow = false;
     size_t cache_memcap = 0;
+    unsigned batch_size = 0;
 };
 
 struct SnortMLSearch
@@ -143,9 +176,18 @@ public:
 
     bool scan(const char*, const size_t, float&) const;
 
+    // with batching enabled the result may be delivered later, but never
+    // after the packet is done: the inspector flushes it after detection
+    void scan(const char*, const size_t, const SnortMLClient&, const snort::Packet*) const;
+    void flush(const snort::Packet*) const;
+
+    bool is_batching() const
+    { return conf.batch_size > 1; }
+
 private:
     bool read_models();
     bool read_model(const std::string&);
+    bool filter(const char*, const size_t) const;
 
     SnortMLEngineConfig conf;
     snort::SearchTool* mpse = nullptr;
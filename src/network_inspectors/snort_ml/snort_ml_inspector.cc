@@ -28,6 +28,7 @@
 #include "detection/detection_engine.h"
 #include "log/messages.h"
 #include "managers/inspector_manager.h"
+#include "pub_sub/detection_events.h"
 #include "pub_sub/http_events.h"
 #include "pub_sub/http_form_data_event.h"
 #include "pub_sub/http_request_body_event.h"
@@ -45,13 +46,14 @@ THREAD_LOCAL ProfileStats snort_ml_prof;
 // HTTP uri event handler
 //--------------------------------------------------------------------------
 
-class HttpUriHandler : public DataHandler
+class HttpUriHandler : public DataHandler, public SnortMLClient
 {
 public:
     HttpUriHandler(const SnortMLEngine& eng, const SnortML& ins)
         : DataHandler(SNORT_ML_NAME), engine(eng), inspector(ins) {}
 
     void handle(DataEvent&, Flow*) override;
+    void process(const char*, size_t, float) const override;
 
 private:
     const SnortMLEngine& engine;
@@ -75,9 +77,15 @@ void HttpUriHandler::handle(DataEvent& de, Flow*)
 
     const size_t len = std::min((size_t)conf.uri_depth, (size_t)query_len);
 
-    float output = 0;
-    if (!engine.scan(query, len, output))
-        return;
+    engine.scan(query, len, *this, DetectionEngine::get_current_packet());
+}
+
+void HttpUriHandler::process(const char* query, size_t len, float output) const
+{
+#ifndef DEBUG_MSGS
+    UNUSED(query);
+#endif
+    const SnortMLConfig& conf = inspector.get_config();
 
     snort_ml_stats.uri_bytes += len;
 
@@ -99,13 +107,14 @@ void HttpUriHandler::handle(DataEvent& de, Flow*)
 // HTTP body event handler
 //--------------------------------------------------------------------------
 
-class HttpBodyHandler : public DataHandler
+class HttpBodyHandler : public DataHandler, public SnortMLClient
 {
 public:
     HttpBodyHandler(const SnortMLEngine& eng, const SnortML& ins)
         : DataHandler(SNORT_ML_NAME), engine(eng), inspector(ins) {}
 
     void handle(DataEvent&, Flow*) override;
+    void process(const char*, size_t, float) const override;
 
 private:
     const SnortMLEngine& engine;
@@ -132,9 +141,15 @@ void HttpBodyHandler::handle(DataEvent& de, Flow*)
 
     const size_t len = std::min((size_t)conf.client_body_depth, (size_t)body_len);
 
-    float output = 0;
-    if (!engine.scan(body, len, output))
-        return;
+    engine.scan(body, len, *this, DetectionEngine::get_current_packet());
+}
+
+void HttpBodyHandler::process(const char* body, size_t len, float output) const
+{
+#ifndef DEBUG_MSGS
+    UNUSED(body);
+#endif
+    const SnortMLConfig& conf = inspector.get_config();
 
     snort_ml_stats.client_body_bytes += len;
 
@@ -156,13 +171,14 @@ void HttpBodyHandler::handle(DataEvent& de, Flow*)
 // HTTP form event handler
 //--------------------------------------------------------------------------
 
-class HttpFormHandler : public DataHandler
+class HttpFormHandler : public DataHandler, public SnortMLClient
 {
 public:
     HttpFormHandler(const SnortMLEngine& eng, const SnortML& ins)
         : DataHandler(SNORT_ML_NAME), engine(eng), inspector(ins) {}
 
     void handle(DataEvent&, Flow*) override;
+    void process(const char*, size_t, float) const override;
 
 private:
     const SnortMLEngine& engine;
@@ -185,14 +201,20 @@ void HttpFormHandler::handle(DataEvent& de, Flow*)
 
     const size_t len = std::min((size_t)conf.client_body_depth, data.length());
 
-    float output = 0;
-    if (!engine.scan(data.c_str(), len, output))
-        return;
+    engine.scan(data.c_str(), len, *this, DetectionEngine::get_current_packet());
+}
+
+void HttpFormHandler::process(const char* data, size_t len, float output) const
+{
+#ifndef DEBUG_MSGS
+    UNUSED(data);
+#endif
+    const SnortMLConfig& conf = inspector.get_config();
 
     snort_ml_stats.client_body_bytes += len;
 
     debug_logf(snort_ml_trace, TRACE_CLASSIFIER, nullptr,
-        "input (form): %.*s\n", (int)len, data.c_str());
+        "input (form): %.*s\n", (int)len, data);
 
     debug_logf(snort_ml_trace, TRACE_CLASSIFIER, nullptr,
         "output: %f\n", static_cast<double>(output));
@@ -205,6 +227,31 @@ void HttpFormHandler::handle(DataEvent& de, Flow*)
     }
 }
 
+//--------------------------------------------------------------------------
+// post detection handler
+//--------------------------------------------------------------------------
+
+class PostDetectionHandler : public DataHandler
+{
+public:
+    PostDetectionHandler(const SnortMLEngine& eng)
+        : DataHandler(SNORT_ML_NAME), engine(eng) {}
+
+    void handle(DataEvent&, Flow*) override;
+
+private:
+    const SnortMLEngine& engine;
+};
+
+void PostDetectionHandler::handle(DataEvent& de, Flow*)
+{
+    // cppcheck-suppress unreadVariable
+    Profile profile(snort_ml_prof);
+
+    // classify inputs batched while inspecting this packet
+    engine.flush(de.get_packet());
+}
+
 //--------------------------------------------------------------------------
 // inspector
 //--------------------------------------------------------------------------
@@ -244,6 +291,12 @@ bool SnortML::configure(SnortConfig*)
             new HttpFormHandler(*engine, *this));
     }
 
+    if (engine->is_batching())
+    {
+        DataBus::subscribe(de_pub_key, DetectionEventIds::POST_DETECTION,
+            new PostDetectionHandler(*engine));
+    }
+
     return true;
 }
 
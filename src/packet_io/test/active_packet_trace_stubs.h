@@ -213,6 +213,7 @@ void ModuleManager::accumulate_module(const char*) { }
 void Stream::handle_timeouts(bool) { }
 void Stream::purge_flows() { }
 bool Stream::set_packet_action_to_hold(Packet*) { return false; }
+bool Stream::defer_finalize(Packet*, DAQ_Verdict) { return false; }
 void Stream::init_active_response(const Packet*, Flow*) { }
 void Stream::drop_flow(const Packet* ) { }
 void Stream::block_flow(const Packet*) { }
@@ -61,6 +61,12 @@ static void print_single_entry(ControlConn* ctrlcon, const rule_stats::View& v,
     json.put("avgMatch", clock_usecs(TO_USECS(v.avg_match())));
     json.put("avgNonMatch", clock_usecs(TO_USECS(v.avg_no_match())));
 
+    json.put("p50Us", v.percentile(0.50), PRECISION);
+    json.put("p90Us", v.percentile(0.90), PRECISION);
+    json.put("p99Us", v.percentile(0.99), PRECISION);
+    json.put("p999Us", v.percentile(0.999), PRECISION);
+    json.put("maxUs", v.max_check(), PRECISION);
+
     json.put("timeouts", v.timeouts());
     json.put("suspends", v.suspends());
     json.put("ruleTimePercentage", v.rule_time_per(total_time_usec), PRECISION);
@@ -0,0 +1,146 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// latency_histogram.h
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+// fixed size log-linear histogram of latencies in clock ticks.  each power
+// of 2 is split into 8 linear buckets so any bucket is within 12.5% of the
+// values it holds (the HDR histogram tradeoff).  values beyond the last
+// power land in the last bucket but max is always exact.
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "time/clock_defs.h"
+
+struct LatencyHistogram
+{
+    static constexpr unsigned SUB_BITS = 3;
+    static constexpr unsigned SUB_BUCKETS = 1 << SUB_BITS;
+    static constexpr unsigned MAX_BITS = 36;
+    static constexpr unsigned BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+
+    uint64_t counts[BUCKETS] = { };
+    uint64_t max = 0;
+
+    static unsigned index(uint64_t v)
+    {
+        if ( v < SUB_BUCKETS )
+            return (unsigned)v;
+
+        unsigned msb = 63 - __builtin_clzll(v);
+
+        if ( msb >= MAX_BITS )
+            return BUCKETS - 1;
+
+        unsigned shift = msb - SUB_BITS;
+        return (shift + 1) * SUB_BUCKETS + ((v >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    // highest value counted by bucket i
+    static uint64_t upper(unsigned i)
+    {
+        if ( i < SUB_BUCKETS )
+            return i;
+
+        unsigned shift = i / SUB_BUCKETS - 1;
+        uint64_t low = uint64_t(SUB_BUCKETS + i % SUB_BUCKETS) << shift;
+        return low + (uint64_t(1) << shift) - 1;
+    }
+
+    // ticks to fractional microseconds
+    static double usecs(uint64_t ticks)
+    {
+#ifdef USE_TSC_CLOCK
+        return double(ticks) / double(clock_scale());
+#else
+        return std::chrono::duration<double, std::micro>(hr_duration(ticks)).count();
+#endif
+    }
+
+    void update(uint64_t v)
+    {
+        ++counts[index(v)];
+
+        if ( v > max )
+            max = v;
+    }
+
+    void reset()
+    { memset(this, 0, sizeof(*this)); }
+
+    uint64_t total() const
+    {
+        uint64_t n = 0;
+
+        for ( auto c : counts )
+            n += c;
+
+        return n;
+    }
+
+    // smallest value that at least q (0 < q <= 1) of the samples don't exceed
+    uint64_t percentile(double q) const
+    {
+        uint64_t n = total();
+
+        if ( !n )
+            return 0;
+
+        uint64_t rank = (uint64_t)std::ceil(q * double(n));
+
+        if ( !rank )
+            rank = 1;
+
+        uint64_t sum = 0;
+
+        for ( unsigned i = 0; i < BUCKETS; ++i )
+        {
+            sum += counts[i];
+
+            if ( sum >= rank )
+                return upper(i) < max ? upper(i) : max;
+        }
+        return max;
+    }
+
+    double percentile_usecs(double q) const
+    { return usecs(percentile(q)); }
+
+    double max_usecs() const
+    { return usecs(max); }
+
+    LatencyHistogram& operator+=(const LatencyHistogram& rhs)
+    {
+        for ( unsigned i = 0; i < BUCKETS; ++i )
+            counts[i] += rhs.counts[i];
+
+        if ( rhs.max > max )
+            max = rhs.max;
+
+        return *this;
+    }
+};
+
+#endif
+
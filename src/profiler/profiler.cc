@@ -133,11 +133,13 @@ void Profiler::consolidate_stats(snort::ProfilerType type)
     if ( !consolidated_once and type == snort::PROFILER_TYPE_TIME )
     {
         map.accumulate_nodes(snort::PROFILER_TYPE_TIME);
+        TimeProfilerStats::consolidate();
         consolidated_once = true;
     }
     else if ( !consolidated_once and type == snort::PROFILER_TYPE_BOTH )
     {
         map.accumulate_nodes();
+        TimeProfilerStats::consolidate();
     }
 
     if ( consolidated_once and type == snort::PROFILER_TYPE_BOTH )
@@ -155,6 +157,7 @@ void Profiler::reset_stats(snort::ProfilerType type)
     {
         totalPerfStats.reset_time();
         otherPerfStats.reset_time();
+        TimeProfilerStats::reset_sampling();
     }
     else
     {
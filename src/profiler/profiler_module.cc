@@ -258,18 +258,26 @@ static const Parameter profiler_dump_params[] =
     { nullptr, Parameter::PT_MAX, nullptr, nullptr, nullptr }
 };
 
-static void time_profiling_start_cmd()
+static const Parameter profiler_module_dump_params[] =
+{
+    { "output", Parameter::PT_ENUM, "table | json",
+      "table", "output format for module statistics" },
+
+    { nullptr, Parameter::PT_MAX, nullptr, nullptr, nullptr }
+};
+
+static void time_profiling_start_cmd(unsigned sample)
 {
     // Because profiler is always started in Analyzer::operator()
     Profiler::stop(0);
-    TimeProfilerStats::set_enabled(true);
+    TimeProfilerStats::set_running(true, sample);
     Profiler::reset_stats(snort::PROFILER_TYPE_TIME);
     Profiler::start();
 }
 
 static void time_profiling_stop_cmd()
 {
-    TimeProfilerStats::set_enabled(false);
+    TimeProfilerStats::set_running(false);
     Profiler::stop(pc.analyzed_pkts);
     Profiler::consolidate_stats(snort::PROFILER_TYPE_TIME);
 }
@@ -277,11 +285,11 @@ static void time_profiling_stop_cmd()
 class ProfilerTimeCmd : public AnalyzerCommand
 {
 public:
-    ProfilerTimeCmd(bool en) : enable(en) { }
+    ProfilerTimeCmd(bool en, unsigned sample = 0) : enable(en), sample(sample) { }
     bool execute(Analyzer&, void**) override
     {
         if ( enable )
-            time_profiling_start_cmd();
+            time_profiling_start_cmd(sample);
         else
             time_profiling_stop_cmd();
 
@@ -290,6 +298,7 @@ public:
     const char* stringify() override { return "TIME_PROFILING"; }
 private:
     bool enable;
+    unsigned sample;
 };
 
 static int time_profiling_start(lua_State* L)
@@ -300,10 +309,23 @@ static int time_profiling_start(lua_State* L)
         LogRespond(ctrlcon, "Time profiling is already started.\n");
         return 0;
     }
+
+    int sample = L ? luaL_optint(L, 1, 0) : 0;
+
+    if ( sample < 0 )
+    {
+        LogRespond(ctrlcon, "Invalid usage of module_start(sample), sample can't be negative\n");
+        return 0;
+    }
+
     Profiler::reset_stats(snort::PROFILER_TYPE_TIME);
     TimeProfilerStats::set_enabled(true);
-    main_broadcast_command(new ProfilerTimeCmd(true), ctrlcon);
-    LogRespond(ctrlcon, "Time profiling is started.\n");
+    main_broadcast_command(new ProfilerTimeCmd(true, sample), ctrlcon);
+
+    if ( sample > 1 )
+        LogRespond(ctrlcon, "Time profiling is started, timing 1 in %u packets.\n", sample);
+    else
+        LogRespond(ctrlcon, "Time profiling is started.\n");
     return 0;
 }
 
@@ -331,12 +353,34 @@ static int time_profiling_dump(lua_State* L)
         return 0;
     }
 
+    OutType out_type = OutType::OUTPUT_TABLE;
+
+    if ( L and lua_gettop(L) > 0 )
+    {
+        if ( lua_gettop(L) > 1 )
+        {
+            LogRespond(ctrlcon, "Too many arguments for module_dump(output) command\n");
+            return 0;
+        }
+
+        const char* arg = lua_tostring(L, 1);
+
+        if ( arg and !strcmp(arg, "json") )
+            out_type = OutType::OUTPUT_JSON;
+
+        else if ( !arg or strcmp(arg, "table") )
+        {
+            LogRespond(ctrlcon, "Invalid usage of module_dump(output), argument can be 'table' or 'json'\n");
+            return 0;
+        }
+    }
+
     Profiler::prepare_stats();
 
     const auto* config = SnortConfig::get_conf()->get_profiler();
     assert(config);
 
-    print_time_profiler_stats(Profiler::get_profiler_nodes(), config->time, ctrlcon);
+    print_time_profiler_stats(Profiler::get_profiler_nodes(), config->time, ctrlcon, out_type);
 
     return 0;
 }
@@ -353,6 +397,14 @@ static int time_profiling_status(lua_State* L)
     return 0;
 }
 
+static const Parameter profiler_start_params[] =
+{
+    { "sample", Parameter::PT_INT, "0:max32", "0",
+      "time 1 in sample packets on average and scale up the results (0 = all packets)" },
+
+    { nullptr, Parameter::PT_MAX, nullptr, nullptr, nullptr }
+};
+
 static const Command profiler_cmds[] =
 {
     { "rule_start", rule_profiling_start,
@@ -368,13 +420,13 @@ static const Command profiler_cmds[] =
       profiler_dump_params, "print rule statistics in table or json format (json format prints dates as Unix epoch)" },
 
     { "module_start", time_profiling_start,
-      nullptr, "enable module time profiling" },
+      profiler_start_params, "enable module time profiling" },
 
     { "module_stop", time_profiling_stop,
       nullptr, "disable module time profiling" },
 
     { "module_dump", time_profiling_dump,
-      nullptr, "print module time profiling statistics" },
+      profiler_module_dump_params, "print module time profiling statistics in table or json format" },
 
     { "module_status", time_profiling_status,
       nullptr, "show module time profiler status" },
@@ -400,6 +452,9 @@ static const Parameter profiler_time_params[] =
     { "max_depth", Parameter::PT_INT, "-1:255", "-1",
       "limit depth to max_depth (-1 = no limit)" },
 
+    { "sample", Parameter::PT_INT, "0:max32", "0",
+      "time 1 in sample packets on average and scale up the results (0 = all packets)" },
+
     { nullptr, Parameter::PT_MAX, nullptr, nullptr, nullptr }
 };
 
@@ -457,8 +512,8 @@ static const Parameter profiler_params[] =
 class ProfilerReloadTuner : public snort::ReloadResourceTuner
 {
 public:
-    explicit ProfilerReloadTuner(bool enable_rule, bool enable_time)
-        : enable_rule(enable_rule), enable_time(enable_time)
+    explicit ProfilerReloadTuner(bool enable_rule, bool enable_time, unsigned sample = 0)
+        : enable_rule(enable_rule), enable_time(enable_time), sample(sample)
     {}
     ~ProfilerReloadTuner() override = default;
 
@@ -469,10 +524,10 @@ public:
     {
         RuleContext::set_enabled(enable_rule);
 
-        if ( enable_time && !TimeProfilerStats::is_enabled() )
-            time_profiling_start_cmd();
+        if ( enable_time && !TimeProfilerStats::is_running() )
+            time_profiling_start_cmd(sample);
 
-        else if ( !enable_time && TimeProfilerStats::is_enabled() )
+        else if ( !enable_time && TimeProfilerStats::is_running() )
             time_profiling_stop_cmd();
 
         return false;
@@ -487,6 +542,7 @@ public:
 private:
     bool enable_rule = false;
     bool enable_time = false;
+    unsigned sample = 0;
 };
 
 template<typename T>
@@ -496,6 +552,14 @@ static bool s_profiler_module_set_max_depth(T& config, Value& v)
 static bool s_profiler_module_set_max_depth(RuleProfilerConfig&, Value&)
 { return false; }
 
+template<typename T>
+static bool s_profiler_module_set_sample(T&, Value&)
+{ return false; }
+
+// cppcheck-suppress constParameter
+static bool s_profiler_module_set_sample(TimeProfilerConfig& config, Value& v)
+{ config.sample = v.get_uint32(); return true; }
+
 template<typename T>
 static bool s_profiler_module_set_dump_file_size(T&, Value&)
 { return false; }
@@ -522,6 +586,9 @@ static bool s_profiler_module_set(T& config, Value& v)
     else if ( v.is("dump_file_size") )
         return s_profiler_module_set_dump_file_size(config, v);
 
+    else if ( v.is("sample") )
+        return s_profiler_module_set_sample(config, v);
+
     else
         return false;
 
@@ -559,7 +626,7 @@ bool ProfilerModule::end(const char* fqn, int, SnortConfig* sc)
 
     if ( Snort::is_reloading() && strcmp(fqn, "profiler") == 0 )
         sc->register_reload_handler(new ProfilerReloadTuner(sc->profiler->rule.show,
-            sc->profiler->time.show));
+            sc->profiler->time.show, sc->profiler->time.sample));
 
     return true;
 }
@@ -154,12 +154,19 @@ void ProfilerNode::accumulate(snort::ProfilerType type)
 
         get_stats();
 
+        // the root is the run time of the thread and is never sampled
+        TimeProfilerStats time = (name == ROOT_NODE) ?
+            local_stats->time : TimeProfilerStats::scaled(local_stats->time);
+
         if ( type == snort::PROFILER_TYPE_TIME )
-            stats += local_stats->time;
+            stats += time;
         else if ( type == snort::PROFILER_TYPE_MEMORY )
             stats += local_stats->memory;
         else
-            stats += *local_stats;
+        {
+            stats += time;
+            stats += local_stats->memory;
+        }
     }
 }
 
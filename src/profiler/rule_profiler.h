@@ -28,6 +28,7 @@
 #include "main/snort_config.h"
 #include "main/thread_config.h"
 
+#include "latency_histogram.h"
 #include "rule_profiler_defs.h"
 
 struct RuleProfilerConfig;
@@ -96,6 +97,12 @@ struct View
     hr_duration avg_check() const
     { return time_per(elapsed(), checks()); }
 
+    double percentile(double q) const
+    { return state.latency ? state.latency->percentile_usecs(q) : 0.0; }
+
+    double max_check() const
+    { return state.latency ? state.latency->max_usecs() : 0.0; }
+
     double rule_time_per(double total_time_usec) const
     {
         if (total_time_usec < 1.)
@@ -21,6 +21,7 @@
 #ifndef RULE_PROFILER_DEFS_H
 #define RULE_PROFILER_DEFS_H
 
+#include "main/snort_types.h"
 #include "time/clock_defs.h"
 #include "time/stopwatch.h"
 
@@ -51,6 +51,11 @@ const StatsTable::Field fields[] =
     { "avg/check", 10, '\0', 1, std::ios_base::fmtflags() },
     { "avg/match", 10, '\0', 1, std::ios_base::fmtflags() },
     { "avg/non-match", 14, '\0', 1, std::ios_base::fmtflags() },
+    { "p50(us)", 10, '\0', 2, std::ios_base::fmtflags() },
+    { "p90(us)", 10, '\0', 2, std::ios_base::fmtflags() },
+    { "p99(us)", 10, '\0', 2, std::ios_base::fmtflags() },
+    { "p99.9(us)", 10, '\0', 2, std::ios_base::fmtflags() },
+    { "max(us)", 10, '\0', 2, std::ios_base::fmtflags() },
     { "timeouts", 9, '\0', 0, std::ios_base::fmtflags() },
     { "suspends", 9, '\0', 0, std::ios_base::fmtflags() },
     { "rule_time (%)", 14, '\0', 5, std::ios_base::fmtflags() },
@@ -86,6 +91,12 @@ static void print_single_entry(ControlConn* ctrlcon, const rule_stats::View& v,
         table << clock_usecs(TO_USECS(v.avg_match()));
         table << clock_usecs(TO_USECS(v.avg_no_match()));
 
+        table << v.percentile(0.50);
+        table << v.percentile(0.90);
+        table << v.percentile(0.99);
+        table << v.percentile(0.999);
+        table << v.max_check();
+
         table << v.timeouts();
         table << v.suspends();
         table << v.rule_time_per(total_time_usec);
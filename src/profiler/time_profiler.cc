@@ -22,7 +22,10 @@
 #include "config.h"
 #endif
 
+#include <atomic>
+#include <cinttypes>
 #include <cmath>
+#include <sstream>
 
 #include "time_profiler.h"
 
@@ -32,6 +35,7 @@
 #include "profiler_stats_table.h"
 #include "time_profiler_defs.h"
 #include "control/control.h"
+#include "helpers/json_stream.h"
 
 #ifdef UNIT_TEST
 #include "catch/snort_catch.h"
@@ -56,6 +60,146 @@ bool TimeProfilerStats::is_enabled()
 { return enabled; }
 #endif
 
+//-------------------------------------------------------------------------
+// sampling
+//-------------------------------------------------------------------------
+
+// with a sample of N the gaps between timed packets are drawn uniformly
+// from 1 .. 2N-1 so the average is 1 in N without locking onto periodic
+// traffic; results are scaled by packets / sampled per thread.
+struct Sampler
+{
+    bool running = false;
+    unsigned sample = 0;
+    unsigned countdown = 0;
+    uint32_t seed = 0;
+
+    uint64_t packets = 0;
+    uint64_t sampled = 0;
+
+    unsigned next_gap()
+    {
+        // xorshift32
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return 1 + seed % (2 * sample - 1);
+    }
+};
+
+static THREAD_LOCAL Sampler sampler;
+
+static std::atomic<uint64_t> total_packets { 0 };
+static std::atomic<uint64_t> total_sampled { 0 };
+static std::atomic<uint64_t> total_scopes { 0 };
+static std::atomic<unsigned> last_sample { 0 };
+
+void TimeProfilerStats::set_running(bool b, unsigned sample)
+{
+    sampler.running = b;
+    sampler.sample = b and sample > 1 ? sample : 0;
+    sampler.packets = sampler.sampled = 0;
+
+    if ( sampler.sample )
+    {
+        sampler.seed = (uint32_t)(uintptr_t)&sampler | 1;
+        sampler.countdown = sampler.next_gap();
+        last_sample = sampler.sample;
+    }
+    else if ( b )
+        last_sample = 0;
+
+    set_enabled(b and !sampler.sample);
+}
+
+bool TimeProfilerStats::is_running()
+{ return sampler.running; }
+
+void TimeProfilerStats::next_packet()
+{
+    if ( !sampler.running )
+        return;
+
+    ++sampler.packets;
+
+    if ( !sampler.sample )
+    {
+        ++sampler.sampled;
+        return;
+    }
+
+    bool timed = !--sampler.countdown;
+
+    if ( timed )
+    {
+        ++sampler.sampled;
+        sampler.countdown = sampler.next_gap();
+    }
+    set_enabled(timed);
+}
+
+TimeProfilerStats TimeProfilerStats::scaled(const TimeProfilerStats& ps)
+{
+    total_scopes += ps.checks;
+
+    if ( !sampler.sample or !sampler.sampled or sampler.sampled == sampler.packets )
+        return ps;
+
+    // the latency distribution of the sampled scopes stands as is
+    double f = double(sampler.packets) / double(sampler.sampled);
+    TimeProfilerStats stats(ps);
+
+    stats.elapsed = hr_duration((uint64_t)(double(TO_TICKS(ps.elapsed)) * f + 0.5));
+    stats.checks = (uint64_t)(double(ps.checks) * f + 0.5);
+
+    return stats;
+}
+
+void TimeProfilerStats::consolidate()
+{
+    total_packets += sampler.packets;
+    total_sampled += sampler.sampled;
+}
+
+void TimeProfilerStats::reset_sampling()
+{
+    sampler.packets = sampler.sampled = 0;
+    total_packets = total_sampled = total_scopes = 0;
+}
+
+// cost of one nested timed scope: the parent pause / resume plus the
+// child's enter / exit and clock reads
+static hr_duration get_scope_cost()
+{
+    static hr_duration cost = 0_ticks;
+
+    if ( cost > 0_ticks )
+        return cost;
+
+    const unsigned n = 4096;
+    TimeProfilerStats stats;
+    Stopwatch<SnortClock> parent, sw;
+    bool was = TimeProfilerStats::is_enabled();
+
+    TimeProfilerStats::set_enabled(true);
+    parent.start();
+    sw.start();
+
+    for ( unsigned i = 0; i < n; ++i )
+    {
+        parent.stop();
+        {
+            TimeContext ctx(stats);
+        }
+        parent.start();
+    }
+    sw.stop();
+    TimeProfilerStats::set_enabled(was);
+
+    cost = hr_duration(TO_TICKS(sw.get()) / n);
+    return cost;
+}
+
 namespace time_stats
 {
 
@@ -67,6 +211,11 @@ static const StatsTable::Field fields[] =
     { "checks", 21, ' ', 0, std::ios_base::fmtflags() },
     { "time(us)", 21, ' ', 0, std::ios_base::fmtflags() },
     { "avg/check", 21, ' ', 1, std::ios_base::fmtflags() },
+    { "p50(us)", 11, ' ', 2, std::ios_base::fmtflags() },
+    { "p90(us)", 11, ' ', 2, std::ios_base::fmtflags() },
+    { "p99(us)", 11, ' ', 2, std::ios_base::fmtflags() },
+    { "p99.9(us)", 11, ' ', 2, std::ios_base::fmtflags() },
+    { "max(us)", 11, ' ', 2, std::ios_base::fmtflags() },
     { "%/caller", 10, ' ', 2, std::ios_base::fmtflags() },
     { "%/total", 9, ' ', 2, std::ios_base::fmtflags() },
     { nullptr, 0, '\0', 0, std::ios_base::fmtflags() }
@@ -87,6 +236,12 @@ struct View
     hr_duration avg_check() const
     { return checks() ? hr_duration(TO_TICKS(elapsed()) / checks()) : 0_ticks; }
 
+    double percentile(double q) const
+    { return stats.latency.percentile_usecs(q); }
+
+    double max_check() const
+    { return stats.latency.max_usecs(); }
+
     double pct_of(const TimeProfilerStats& o) const
     {
         if ( o.elapsed <= 0_ticks )
@@ -151,8 +306,102 @@ static void print_fn(StatsTable& t, const View& v)
 
     // avg/check
     t << clock_usecs(TO_USECS(v.avg_check()));
+
+    // latency distribution
+    t << v.percentile(0.50) << v.percentile(0.90) << v.percentile(0.99);
+    t << v.percentile(0.999) << v.max_check();
 }
 
+#define PRECISION 5
+
+static void put_json_stats(JsonStream& json, const View& v)
+{
+    json.put("checks", v.checks());
+    json.put("timeUs", clock_usecs(TO_USECS(v.elapsed())));
+    json.put("avgCheck", clock_usecs(TO_USECS(v.avg_check())));
+
+    json.put("p50Us", v.percentile(0.50), PRECISION);
+    json.put("p90Us", v.percentile(0.90), PRECISION);
+    json.put("p99Us", v.percentile(0.99), PRECISION);
+    json.put("p999Us", v.percentile(0.999), PRECISION);
+    json.put("maxUs", v.max_check(), PRECISION);
+}
+
+// same selection as ProfilerPrinter but nested as json; flushed per module
+// since responses are limited in size
+class JsonPrinter
+{
+public:
+    using Entry = ProfilerBuilder<View>::Entry;
+
+    JsonPrinter(ControlConn* ctrlcon, const ProfilerSorter<View>& sort, unsigned count,
+        int max_depth) : ctrlcon(ctrlcon), json(ss), sort(sort), count(count), max_depth(max_depth)
+    { }
+
+    void open(Entry& root)
+    {
+        json.open();
+        json.open("total");
+        put_json_stats(json, root.view);
+        json.close();
+
+        print_children(root, root, 1);
+    }
+
+    void close()
+    {
+        json.close();
+        flush();
+    }
+
+    JsonStream& get_json()
+    { return json; }
+
+private:
+    void print_children(const Entry& root, Entry& cur, int layer)
+    {
+        if ( ( max_depth >= 0 and max_depth < layer ) or cur.children.empty() )
+            return;
+
+        auto& entries = cur.children;
+        unsigned num_entries = ( !count or count > entries.size() ) ? entries.size() : count;
+
+        if ( sort )
+            std::partial_sort(entries.begin(), entries.begin() + num_entries, entries.end(), sort);
+
+        json.open_array("modules");
+
+        for ( unsigned i = 0; i < num_entries; ++i )
+        {
+            auto& entry = entries[i];
+
+            json.open();
+            json.put("module", entry.view.name);
+            put_json_stats(json, entry.view);
+            json.put("callerPercentage", entry.view.pct_caller(), PRECISION);
+            json.put("totalPercentage", entry.view.pct_of(root.view.get_stats()), PRECISION);
+            flush();
+
+            print_children(root, entry, layer + 1);
+            json.close();
+        }
+        json.close_array();
+    }
+
+    void flush()
+    {
+        LogRespond(ctrlcon, "%s", ss.str().c_str());
+        ss.str("");
+    }
+
+    ControlConn* ctrlcon;
+    std::ostringstream ss;
+    JsonStream json;
+    const ProfilerSorter<View>& sort;
+    unsigned count;
+    int max_depth;
+};
+
 struct s_print_table
 {
     ControlConn* ctrlcon;
@@ -173,7 +422,30 @@ void show_time_profiler_stats(ProfilerNodeMap& nodes, const TimeProfilerConfig&
     print_time_profiler_stats(nodes, config, nullptr);
 }
 
-void print_time_profiler_stats(ProfilerNodeMap& nodes, const TimeProfilerConfig& config, ControlConn* ctrlcon)
+static void print_json_stats(ProfilerBuilder<time_stats::View>::Entry& root,
+    const TimeProfilerConfig& config, ControlConn* ctrlcon)
+{
+    const auto& sorter = time_stats::sorters[config.sort];
+    time_stats::JsonPrinter printer(ctrlcon, sorter, config.count, config.max_depth);
+
+    printer.open(root);
+
+    uint64_t packets = total_packets;
+    uint64_t sampled = total_sampled;
+    unsigned sample = last_sample;
+
+    if ( sample and packets )
+    {
+        JsonStream& json = printer.get_json();
+        json.put("sample", sample);
+        json.put("sampledPackets", sampled);
+        json.put("packets", packets);
+    }
+    printer.close();
+}
+
+void print_time_profiler_stats(ProfilerNodeMap& nodes, const TimeProfilerConfig& config,
+    ControlConn* ctrlcon, OutType out_type)
 {
     ProfilerBuilder<time_stats::View> builder(time_stats::include_fn);
     auto root = builder.build(nodes.get_root());
@@ -181,6 +453,12 @@ void print_time_profiler_stats(ProfilerNodeMap& nodes, const TimeProfilerConfig&
     if ( root.children.empty() && !root.view.stats.is_active() )
         return;
 
+    if ( out_type == OutType::OUTPUT_JSON )
+    {
+        print_json_stats(root, config, ctrlcon);
+        return;
+    }
+
     const auto& sorter = time_stats::sorters[config.sort];
     const auto& printer_t = time_stats::s_print_table(ctrlcon);
 
@@ -189,6 +467,29 @@ void print_time_profiler_stats(ProfilerNodeMap& nodes, const TimeProfilerConfig&
 
     if (std::roundf(printer.get_total()) > 100.0f)
         LogRespond(ctrlcon, "Note: Total time for a module includes time spent in submodules. Total percentage may exceed 100\n");
+
+    uint64_t packets = total_packets;
+    uint64_t sampled = total_sampled;
+    unsigned sample = last_sample;
+
+    if ( sample and packets )
+    {
+        LogRespond(ctrlcon, "Sampled %" PRIu64 " of %" PRIu64 " packets (1 in %u), results are scaled up\n",
+            sampled, packets, sample);
+    }
+
+#ifndef REG_TEST
+    if ( uint64_t scopes = total_scopes )
+    {
+        hr_duration overhead(TO_TICKS(get_scope_cost()) * scopes);
+        hr_duration total = root.view.stats.elapsed;
+        double pct = total > 0_ticks ?
+            double(TO_TICKS(overhead)) / double(TO_TICKS(total)) * 100.0 : 0.0;
+
+        LogRespond(ctrlcon, "Estimated profiler overhead: %ld usecs (%.2f%% of total) for %"
+            PRIu64 " timed scopes\n", clock_usecs(TO_USECS(overhead)), pct, scopes);
+    }
+#endif
 }
 
 #ifdef UNIT_TEST
@@ -635,4 +936,133 @@ TEST_CASE( "time context exclude", "[profiler][time_profiler]" )
     CHECK( stats.elapsed < hr_duration::max() );
 }
 
+TEST_CASE( "time profiler sampling", "[profiler][time_profiler]" )
+{
+    SECTION( "toggled between packets" )
+    {
+        TimeProfilerStats stats;
+        TimeProfilerStats::set_enabled(true);
+        {
+            TimeContext ctx(stats);
+            TimeProfilerStats::set_enabled(false);
+        }
+        CHECK( stats.ref_count == 0 );
+        CHECK( stats.checks == 1 );
+
+        {
+            TimeContext ctx(stats);
+            TimeProfilerStats::set_enabled(true);
+        }
+        CHECK( stats.ref_count == 0 );
+        CHECK( stats.checks == 1 );
+    }
+
+    SECTION( "1 in N" )
+    {
+        const unsigned packets = 100000;
+        unsigned timed = 0;
+
+        TimeProfilerStats::set_running(true, 10);
+        CHECK( TimeProfilerStats::is_running() );
+
+        for ( unsigned i = 0; i < packets; ++i )
+        {
+            TimeProfilerStats::next_packet();
+
+            if ( TimeProfilerStats::is_enabled() )
+                ++timed;
+        }
+        CHECK( timed > packets / 12 );
+        CHECK( timed < packets / 8 );
+
+        TimeProfilerStats raw = { hr_duration(timed * 100), timed };
+        TimeProfilerStats all = TimeProfilerStats::scaled(raw);
+
+        CHECK( all.checks == packets );
+        CHECK( TO_TICKS(all.elapsed) == packets * 100 );
+
+        TimeProfilerStats::set_running(false);
+        CHECK( !TimeProfilerStats::is_running() );
+        CHECK( !TimeProfilerStats::is_enabled() );
+    }
+
+    SECTION( "all packets" )
+    {
+        TimeProfilerStats::set_running(true);
+        TimeProfilerStats::next_packet();
+        CHECK( TimeProfilerStats::is_enabled() );
+
+        TimeProfilerStats raw = { 100_ticks, 1 };
+        CHECK( TimeProfilerStats::scaled(raw) == raw );
+
+        TimeProfilerStats::set_running(false);
+    }
+    TimeProfilerStats::reset_sampling();
+}
+
+TEST_CASE( "latency histogram", "[profiler][time_profiler]" )
+{
+    LatencyHistogram h;
+
+    SECTION( "buckets" )
+    {
+        for ( uint64_t v : { 0, 7, 8, 15, 16, 17, 1000, 123456789 } )
+        {
+            unsigned i = LatencyHistogram::index(v);
+            INFO( "value: " << v << " bucket: " << i );
+            CHECK( LatencyHistogram::upper(i) >= v );
+            CHECK( (i == 0 or LatencyHistogram::upper(i - 1) < v) );
+            CHECK( LatencyHistogram::upper(i) - v <= v / LatencyHistogram::SUB_BUCKETS );
+        }
+        CHECK( LatencyHistogram::index(uint64_t(1) << 40) == LatencyHistogram::BUCKETS - 1 );
+    }
+
+    SECTION( "percentiles" )
+    {
+        CHECK( h.percentile(0.5) == 0 );
+
+        for ( uint64_t v = 1; v <= 1000; ++v )
+            h.update(v);
+
+        CHECK( h.total() == 1000 );
+        CHECK( h.max == 1000 );
+
+        uint64_t p50 = h.percentile(0.50);
+        uint64_t p99 = h.percentile(0.99);
+
+        CHECK( p50 >= 500 );
+        CHECK( p50 <= 500 + 500 / LatencyHistogram::SUB_BUCKETS );
+        CHECK( p99 >= 990 );
+        CHECK( h.percentile(0.999) <= 1000 );
+        CHECK( h.percentile(1.0) == 1000 );
+    }
+
+    SECTION( "outlier" )
+    {
+        for ( unsigned i = 0; i < 999; ++i )
+            h.update(100);
+
+        h.update(5000000);
+
+        CHECK( h.percentile(0.99) <= 100 + 100 / LatencyHistogram::SUB_BUCKETS );
+        CHECK( h.percentile(0.999) <= 100 + 100 / LatencyHistogram::SUB_BUCKETS );
+        CHECK( h.percentile(1.0) == 5000000 );
+    }
+
+    SECTION( "stats" )
+    {
+        TimeProfilerStats a, b;
+        a.update(10_ticks);
+        b.update(1000_ticks);
+        a += b;
+
+        CHECK( a.latency.total() == 2 );
+        CHECK( a.latency.max == 1000 );
+
+        a.reset();
+        CHECK( a.latency.total() == 0 );
+        CHECK( a.latency.max == 0 );
+    }
+}
+
 #endif
@@ -21,11 +21,14 @@
 #ifndef TIME_PROFILER_H
 #define TIME_PROFILER_H
 
+#include "rule_profiler_defs.h"
+
 class ProfilerNodeMap;
 struct TimeProfilerConfig;
 class ControlConn;
 
 void show_time_profiler_stats(ProfilerNodeMap&, const TimeProfilerConfig&);
-void print_time_profiler_stats(ProfilerNodeMap&, const TimeProfilerConfig&, ControlConn*);
+void print_time_profiler_stats(ProfilerNodeMap&, const TimeProfilerConfig&, ControlConn*,
+    OutType = OutType::OUTPUT_TABLE);
 
 #endif
@@ -25,6 +25,8 @@
 #include "time/clock_defs.h"
 #include "time/stopwatch.h"
 
+#include "latency_histogram.h"
+
 struct TimeProfilerConfig
 {
     enum Sort
@@ -38,6 +40,7 @@ struct TimeProfilerConfig
     bool show = false;
     unsigned count = 0;
     int max_depth = -1;
+    unsigned sample = 0;  // time 1 in sample packets; 0 or 1 times all
 };
 
 namespace snort
@@ -47,7 +50,10 @@ struct SO_PUBLIC TimeProfilerStats
     hr_duration elapsed;
     uint64_t checks;
     mutable unsigned int ref_count;
+    LatencyHistogram latency;
 
+    // enabled means the current packet is timed; with sampling, packet
+    // threads set it per packet and running tells if profiling is on
 #ifndef _WIN64
     static THREAD_LOCAL bool enabled;
 
@@ -61,11 +67,32 @@ struct SO_PUBLIC TimeProfilerStats
     static bool is_enabled();
 #endif
 
+    static void set_running(bool, unsigned sample = 0);
+    static bool is_running();
+
+    // pick the packets to time; called before any profiled scope is entered
+    static void next_packet();
+
+    // scale this thread's sampled results up to all packets
+    static TimeProfilerStats scaled(const TimeProfilerStats&);
+
+    // fold this thread's sampling counts into the totals reported
+    static void consolidate();
+    static void reset_sampling();
+
     void update(hr_duration delta)
-    { elapsed += delta; ++checks; }
+    {
+        elapsed += delta;
+        ++checks;
+        latency.update(TO_TICKS(delta));
+    }
 
     void reset()
-    { elapsed = 0_ticks; checks = 0; }
+    {
+        elapsed = 0_ticks;
+        checks = 0;
+        latency.reset();
+    }
 
     bool is_active() const
     { return ( elapsed > CLOCK_ZERO ) || checks; }
@@ -94,6 +121,7 @@ inline TimeProfilerStats& operator+=(TimeProfilerStats& lhs, const TimeProfilerS
 {
     lhs.elapsed += rhs.elapsed;
     lhs.checks += rhs.checks;
+    lhs.latency += rhs.latency;
     return lhs;
 }
 
@@ -103,20 +131,27 @@ public:
     TimeContext(TimeProfilerStats& stats) :
         stats(stats)
     {
-        if ( stats.is_enabled() and stats.enter() )
-            sw.start();
+        // remember entry so enter / exit stay paired if enabled changes
+        // between packets while this context is open
+        if ( stats.is_enabled() )
+        {
+            entered = true;
+
+            if ( stats.enter() )
+                sw.start();
+        }
     }
 
     ~TimeContext()
     {
-        if ( stats.is_enabled() )
+        if ( entered )
             stop();
     }
 
     // Use this for finer grained control of the TimeContext "lifetime"
     void stop()
     {
-        if ( !stats.is_enabled() or stopped_once )
+        if ( !entered or stopped_once )
             return; // stop() should only be executed once per context
 
         stopped_once = true;
@@ -135,9 +170,13 @@ public:
     bool active() const
     { return !stopped_once; }
 
+    bool was_entered() const
+    { return entered; }
+
 private:
     TimeProfilerStats& stats;
     Stopwatch<SnortClock> sw;
+    bool entered = false;
     bool stopped_once = false;
 };
 
@@ -152,7 +191,7 @@ public:
 
     ~TimeExclude()
     {
-        if ( !TimeProfilerStats::is_enabled() )
+        if ( !ctx.was_entered() )
             return;
         ctx.stop();
         stats.elapsed -= tmp.elapsed;
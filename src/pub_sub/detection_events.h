@@ -34,6 +34,7 @@ struct DetectionEventIds
         IPS_LOGGING,     // before IPS loggers invoked
         CONTEXT_LOGGING, // in an IPS logger
         BUILTIN,         // built-in event added in the event queue
+        POST_DETECTION,  // packet inspected and detected, before logging
         MAX
     };
 };
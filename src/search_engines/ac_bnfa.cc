@@ -165,7 +165,6 @@ static void bnfa_dtor(Mpse* p)
 
 static void bnfa_init()
 {
-    bnfa_init_xlatcase();
     bnfaInitSummary();
 }
 
@@ -188,7 +187,7 @@ static const MpseApi bnfa_api =
         mod_ctor,
         mod_dtor
     },
-    MPSE_BASE,
+    MPSE_BASE | MPSE_MTBLD,
     nullptr,
     nullptr,
     nullptr,
@@ -157,7 +157,6 @@ static void acf_dtor(Mpse* p)
 
 static void acf_init()
 {
-    acsmx2_init_xlatcase();
     acsm_init_summary();
 }
 
@@ -180,7 +179,7 @@ static const MpseApi acf_api =
         mod_ctor,
         mod_dtor
     },
-    MPSE_BASE,
+    MPSE_BASE | MPSE_MTBLD,
     nullptr,
     nullptr,
     nullptr,
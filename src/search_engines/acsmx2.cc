@@ -123,6 +123,8 @@
 
 #include "acsmx2.h"
 
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <list>
 #include <mutex>
@@ -135,15 +137,16 @@ using namespace snort;
 
 #define printf LogMessage
 
-static int acsm2_total_memory = 0;
-static int acsm2_pattern_memory = 0;
-static int acsm2_matchlist_memory = 0;
-static int acsm2_transtable_memory = 0;
-static int acsm2_dfa_memory = 0;
-static int acsm2_dfa1_memory = 0;
-static int acsm2_dfa2_memory = 0;
-static int acsm2_dfa4_memory = 0;
-static int acsm2_failstate_memory = 0;
+// instances may be compiled in parallel
+static std::atomic<int> acsm2_total_memory { 0 };
+static std::atomic<int> acsm2_pattern_memory { 0 };
+static std::atomic<int> acsm2_matchlist_memory { 0 };
+static std::atomic<int> acsm2_transtable_memory { 0 };
+static std::atomic<int> acsm2_dfa_memory { 0 };
+static std::atomic<int> acsm2_dfa1_memory { 0 };
+static std::atomic<int> acsm2_dfa2_memory { 0 };
+static std::atomic<int> acsm2_dfa4_memory { 0 };
+static std::atomic<int> acsm2_failstate_memory { 0 };
 
 struct acsm_summary_t
 {
@@ -160,6 +163,7 @@ struct acsm_summary_t
 };
 
 static acsm_summary_t summary;
+static std::mutex summary_mutex;
 
 void acsm_init_summary()
 {
@@ -181,25 +185,19 @@ void acsm_init_summary()
     acsm2_failstate_memory = 0;
 }
 
-static uint8_t xlatcase[256];
-static bool xlatinit = true;
-
-void acsmx2_init_xlatcase()
+// built at compile time so instances can be compiled in parallel
+static constexpr std::array<uint8_t, 256> acsm_xlatcase()
 {
-    static std::mutex _m;
-    std::lock_guard<std::mutex> lock(_m);
-    if ( !xlatinit )
-       return;
+    std::array<uint8_t, 256> t = { };
 
-    int i;
-    for (i = 0; i < 256; i++)
-    {
-        xlatcase[i] = (uint8_t)toupper(i);
-    }
+    for (int i = 0; i < 256; i++)
+        t[i] = (uint8_t)((i >= 'a' and i <= 'z') ? i - 'a' + 'A' : i);
 
-    xlatinit = false;
+    return t;
 }
 
+static constexpr std::array<uint8_t, 256> xlatcase = acsm_xlatcase();
+
 static inline void ConvertCaseEx(uint8_t* d, const uint8_t* s, int m)
 {
     for (int i=0; i < m; i++)
@@ -810,7 +808,7 @@ int acsmAddPattern2(
 
 // Copy a boolean match flag int NextState table, for caching purposes.
 
-static void acsmUpdateMatchStates(ACSM_STRUCT2* acsm)
+static void acsmUpdateMatchStates(ACSM_STRUCT2* acsm, acsm_summary_t& sum)
 {
     acstate_t state;
     acstate_t** NextState = acsm->acsmNextState;
@@ -835,7 +833,7 @@ static void acsmUpdateMatchStates(ACSM_STRUCT2* acsm)
                 break;
             }
 
-            summary.num_match_states++;
+            sum.num_match_states++;
         }
     }
 }
@@ -876,6 +874,7 @@ static void acsmBuildMatchStateTrees2(SnortConfig* sc, ACSM_STRUCT2* acsm)
 static inline int _acsmCompile2(ACSM_STRUCT2* acsm)
 {
     ACSM_PATTERN2* plist;
+    acsm_summary_t sum = { };
 
     /* Count number of possible states */
     for (plist = acsm->acsmPatterns; plist != nullptr; plist = plist->next)
@@ -899,8 +898,8 @@ static inline int _acsmCompile2(ACSM_STRUCT2* acsm)
     /* Add each Pattern to the State Table - This forms a keywords state table  */
     for (plist = acsm->acsmPatterns; plist != nullptr; plist = plist->next)
     {
-        summary.num_patterns++;
-        summary.num_characters += plist->n;
+        sum.num_patterns++;
+        sum.num_characters += plist->n;
         AddPatternStates(acsm, plist);
     }
 
@@ -910,17 +909,17 @@ static inline int _acsmCompile2(ACSM_STRUCT2* acsm)
     if (acsm->acsmNumStates < UINT8_MAX)
     {
         acsm->sizeofstate = 1;
-        summary.num_1byte_instances++;
+        sum.num_1byte_instances++;
     }
     else if (acsm->acsmNumStates < UINT16_MAX)
     {
         acsm->sizeofstate = 2;
-        summary.num_2byte_instances++;
+        sum.num_2byte_instances++;
     }
     else
     {
         acsm->sizeofstate = 4;
-        summary.num_4byte_instances++;
+        sum.num_4byte_instances++;
     }
 
     /* Alloc a failure table - this has a failure state, and a match list for each state */
@@ -944,15 +943,23 @@ static inline int _acsmCompile2(ACSM_STRUCT2* acsm)
         return -1;
 
     /* load boolean match flags into state table */
-    acsmUpdateMatchStates(acsm);
+    acsmUpdateMatchStates(acsm, sum);
 
     /* Free up the Table Of Transition Lists */
     List_FreeTransTable(acsm);
 
     /* Accrue Summary State Stats */
+    std::lock_guard<std::mutex> lock(summary_mutex);
+
     summary.num_states += acsm->acsmNumStates;
     summary.num_transitions += acsm->acsmNumTrans;
     summary.num_instances++;
+    summary.num_patterns += sum.num_patterns;
+    summary.num_characters += sum.num_characters;
+    summary.num_match_states += sum.num_match_states;
+    summary.num_1byte_instances += sum.num_1byte_instances;
+    summary.num_2byte_instances += sum.num_2byte_instances;
+    summary.num_4byte_instances += sum.num_4byte_instances;
 
     memcpy(&summary.acsm, acsm, sizeof(ACSM_STRUCT2));
 
@@ -114,8 +114,6 @@ struct ACSM_STRUCT2
 /*
 *   Prototypes
 */
-void acsmx2_init_xlatcase();
-
 ACSM_STRUCT2* acsmNew2(const MpseAgent*);
 
 int acsmAddPattern2(
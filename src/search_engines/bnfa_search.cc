@@ -146,7 +146,9 @@
 
 #include "bnfa_search.h"
 
+#include <array>
 #include <list>
+#include <mutex>
 
 #include "log/log_stats.h"
 #include "log/messages.h"
@@ -164,23 +166,21 @@ using namespace snort;
 
 /*
 * Case Translation Table - this guarantees we use
-* indexed lookups for case conversion
+* indexed lookups for case conversion; built at compile time
+* so instances can be compiled in parallel
 */
-static unsigned xlatinit = 1;
-static uint8_t xlatcase[BNFA_MAX_ALPHABET_SIZE];
-
-void bnfa_init_xlatcase()
+static constexpr std::array<uint8_t, BNFA_MAX_ALPHABET_SIZE> bnfa_xlatcase()
 {
-    if ( !xlatinit )
-        return;
+    std::array<uint8_t, BNFA_MAX_ALPHABET_SIZE> t = { };
 
     for (int i=0; i<BNFA_MAX_ALPHABET_SIZE; i++)
-    {
-        xlatcase[i] = (uint8_t)toupper(i);
-    }
-    xlatinit = 0;
+        t[i] = (uint8_t)((i >= 'a' and i <= 'z') ? i - 'a' + 'A' : i);
+
+    return t;
 }
 
+static constexpr std::array<uint8_t, BNFA_MAX_ALPHABET_SIZE> xlatcase = bnfa_xlatcase();
+
 /*
 * Custom memory allocator
 */
@@ -1628,6 +1628,7 @@ int bnfaPatternCount(bnfa_struct_t* p)
 
 static bnfa_struct_t summary;
 static int summary_cnt = 0;
+static std::mutex summary_mutex;
 
 static void bnfaPrintInfoEx(bnfa_struct_t* p)
 {
@@ -1682,6 +1683,7 @@ void bnfaInitSummary()
 
 void bnfaAccumInfo(bnfa_struct_t* p)
 {
+    std::lock_guard<std::mutex> lock(summary_mutex);
     bnfa_struct_t* px = &summary;
 
     summary_cnt++;
@@ -156,8 +156,6 @@ struct bnfa_struct_t
 /*
 *   Prototypes
 */
-void bnfa_init_xlatcase();
-
 bnfa_struct_t* bnfaNew(const MpseAgent*);
 
 void bnfaFree(bnfa_struct_t* pstruct);
@@ -26,6 +26,7 @@
 #include <cassert>
 #include <cstring>
 #include <fstream>
+#include <memory>
 #include <mutex>
 #include <sstream>
 
@@ -231,9 +232,6 @@ public:
 
     ~HyperscanMpse() override
     {
-        if ( hs_db )
-            hs_free_database(hs_db);
-
         if ( agent )
             user_dtor();
     }
@@ -265,6 +263,7 @@ public:
     bool deserialize(const uint8_t*, size_t) override;
 
     void get_hash(std::string&) override;
+    bool adopt(const Mpse&) override;
 
 private:
     void user_ctor(SnortConfig*);
@@ -274,6 +273,7 @@ private:
     PatternVector pvector;
 
     hs_database_t* hs_db = nullptr;
+    std::shared_ptr<hs_database_t> db_ref;  // owns hs_db, shared across reloads
     bool compiled = false;
 
 public:
@@ -299,6 +299,7 @@ bool HyperscanMpse::deserialize(const uint8_t* buf, size_t sz)
         ParseWarning(WARN_RULES, "can't deserialize hyperscan database (%d)", err);
         return false;
     }
+    db_ref.reset(hs_db, hs_free_database);
 
     if ( hs_error_t err = hs_alloc_scratch(hs_db, &s_scratch) )
     {
@@ -399,6 +400,7 @@ int HyperscanMpse::prep_patterns(SnortConfig* sc)
     }
 
     compiled = true;
+    db_ref.reset(hs_db, hs_free_database);
 
     if ( agent )
         user_ctor(sc);
@@ -431,6 +433,29 @@ void HyperscanMpse::get_hash(std::string& hash)
     hash.assign((const char*)buf, sizeof(buf));
 }
 
+// the pattern ids are indices into the sorted pvector so an identical
+// hash means the database can be used as is; only the user data is new
+bool HyperscanMpse::adopt(const Mpse& m)
+{
+    const HyperscanMpse& that = static_cast<const HyperscanMpse&>(m);
+
+    if ( hs_db or !that.hs_db or pvector.size() != that.pvector.size() )
+        return false;
+
+    hs_db = that.hs_db;
+    db_ref = that.db_ref;
+    compiled = that.compiled;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    if ( hs_error_t err = hs_alloc_scratch(hs_db, &s_scratch) )
+    {
+        ParseError("can't allocate search scratch space (%d)", err);
+        return false;
+    }
+    return true;
+}
+
 void HyperscanMpse::reuse_search()
 {
     if ( pvector.empty() )
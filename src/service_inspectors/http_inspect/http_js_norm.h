@@ -75,6 +75,10 @@ protected:
     bool pre_proc() override;
     bool post_proc(int) override;
 
+    // scripts are found in the page and raise infractions of their own
+    bool cacheable() const override
+    { return false; }
+
 private:
     snort::SearchTool* mpse_otag;
     snort::SearchTool* mpse_attr;
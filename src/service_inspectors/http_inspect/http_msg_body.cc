@@ -72,7 +72,10 @@ HttpMsgBody::HttpMsgBody(const uint8_t* buffer, const uint16_t buf_size,
     const HttpParaList* params_) :
     HttpMsgSection(buffer, buf_size, session_data_, source_id_, buf_owner, flow_, params_),
     body_octets(session_data->body_octets[source_id]),
-    first_body(session_data->body_octets[source_id] == 0)
+    first_body(session_data->body_octets[source_id] == 0),
+    // Using the trick that cutter is deleted when regular or chunked body is complete
+    whole_body(first_body and session_data->cutter[source_id] == nullptr and !tcp_close and
+        !session_data->partial_flush[source_id])
 {
     transaction->set_body(this);
     get_related_sections();
@@ -1063,7 +1066,7 @@ const Field& HttpMsgBody::get_norm_js_data()
     bool back = !session_data->partial_flush[source_id];
 
     jsn->link(src, session_data->events[source_id], infractions);
-    jsn->ctx().normalize(src, src_len, dst, dst_len);
+    jsn->ctx().normalize(src, src_len, dst, dst_len, whole_body);
 
     debug_logf(4, js_trace, TRACE_PROC, DetectionEngine::get_current_packet(),
         "input data was %s\n", back ? "last one in PDU" : "a part of PDU");
@@ -62,6 +62,7 @@ protected:
 
     int64_t body_octets;
     bool first_body;
+    const bool whole_body;  // the entire body is in this section
 
 #ifdef REG_TEST
     void print_body_section(FILE* output, const char* body_type_str);
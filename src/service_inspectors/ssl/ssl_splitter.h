@@ -57,6 +57,11 @@ public:
         return true;
     }
 
+    bool zero_copy() const override
+    {
+        return true;
+    }
+
 private:
     SslPafStates paf_state;
     uint16_t remain_len;
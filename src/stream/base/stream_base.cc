@@ -26,6 +26,7 @@
 #include "detection/ips_context.h"
 #include "flow/expect_cache.h"
 #include "flow/flow_control.h"
+#include "flow/flow_cost.h"
 #include "flow/prune_stats.h"
 #include "framework/data_bus.h"
 #include "log/messages.h"
@@ -271,6 +272,7 @@ void StreamBase::tinit()
 
     // this is temp added to suppress the compiler error only
     flow_con = new FlowControl(config.flow_cache_cfg);
+    FlowCost::tinit();
 
     {
         std::lock_guard<std::mutex> flow_control_lock(crash_dump_flow_control_mutex);
@@ -323,6 +325,7 @@ void StreamBase::tterm()
     base_prep();
     delete flow_con;
     flow_con = nullptr;
+    FlowCost::tterm();
 }
 
 void StreamBase::show(const SnortConfig* sc) const
@@ -29,6 +29,7 @@
 #include "flow/dump_flows_descriptor.h"
 #include "flow/dump_flows.h"
 #include "flow/flow_cache.h"
+#include "flow/flow_cost.h"
 #include "log/messages.h"
 #include "lua/lua.h"
 #include "main/analyzer_command.h"
@@ -389,11 +390,120 @@ static int dump_flows_summary(lua_State* L)
     return 0;
 }
 
+class TopFlows : public AnalyzerCommand
+{
+public:
+    TopFlows(ControlConn* conn, unsigned count) : AnalyzerCommand(conn), count(count)
+    {
+        tops.resize(ThreadConfig::get_instance_max());
+        times.resize(tops.size());
+    }
+
+    ~TopFlows() override;
+
+    bool execute(Analyzer&, void**) override
+    {
+        // packet time is per thread, so keep it for the ages of closed flows
+        FlowCost::get_top(tops[get_instance_id()]);
+        times[get_instance_id()] = packet_time();
+        return true;
+    }
+
+    const char* stringify() override
+    { return "TopFlows"; }
+
+private:
+    unsigned count;
+    std::vector<std::vector<FlowCostEntry>> tops;
+    std::vector<time_t> times;
+};
+
+TopFlows::~TopFlows()
+{
+    std::vector<std::pair<const FlowCostEntry*, unsigned>> all;
+
+    for ( unsigned t = 0; t < tops.size(); ++t )
+        for ( const auto& e : tops[t] )
+            all.emplace_back(&e, t);
+
+    unsigned n = std::min((unsigned)all.size(), count);
+
+    std::partial_sort(all.begin(), all.begin() + n, all.end(),
+        [](const std::pair<const FlowCostEntry*, unsigned>& lhs,
+            const std::pair<const FlowCostEntry*, unsigned>& rhs)
+        { return lhs.first->usecs > rhs.first->usecs; });
+
+    for ( unsigned i = 0; i < n; ++i )
+    {
+        const FlowCostEntry& e = *all[i].first;
+        const FlowKey& key = e.key;
+
+        SfIp client, server;
+        uint16_t client_port, server_port;
+
+        if ( e.key_is_reversed )
+        {
+            server.set(key.ip_h);
+            server_port = key.port_h;
+            client.set(key.ip_l);
+            client_port = key.port_l;
+        }
+        else
+        {
+            server.set(key.ip_l);
+            server_port = key.port_l;
+            client.set(key.ip_h);
+            client_port = key.port_h;
+        }
+
+        SfIpString cs, ss;
+        std::string state = e.closed ?
+            "closed " + std::to_string(times[all[i].second] - e.closed) + "s ago" : "live";
+
+        LogRespond(ctrlcon, "%2u: %s/%hu -> %s/%hu proto %u vlan %hu asid %u thread %u\n",
+            i + 1, client.ntop(cs), client_port, server.ntop(ss), server_port,
+            key.ip_protocol, key.vlan_tag, key.addressSpaceId, all[i].second);
+
+        LogRespond(ctrlcon, "    usecs %" PRIu64 " bytes %" PRIu64 " packets %" PRIu64
+            " nsecs/byte %.1f service %s app %s %s\n", e.usecs, e.bytes, e.packets,
+            e.nsecs_per_byte(), e.service.empty() ? "none" : e.service.c_str(),
+            e.app.empty() ? "none" : e.app.c_str(), state.c_str());
+    }
+    LogRespond(ctrlcon, "== %u flows\n", n);
+}
+
+static int top_flows(lua_State* L)
+{
+    ControlConn* ctrlcon = ControlConn::query_from_lua(L);
+    int count = L ? luaL_optint(L, 1, 10) : 10;
+
+    if ( count < 1 or count > (int)(FlowCost::max_flows * ThreadConfig::get_instance_max()) )
+    {
+        LogRespond(ctrlcon, "Invalid count value: %d.  Count value must be between 1 - %u\n",
+            count, FlowCost::max_flows * ThreadConfig::get_instance_max());
+        return -1;
+    }
+
+    LogRespond(ctrlcon, "== top flows by inspection time\n");
+    main_broadcast_command(new TopFlows(ctrlcon, count), ctrlcon);
+    return 0;
+}
+
+static const Parameter top_flows_params[] =
+{
+    { "count", Parameter::PT_INT, "1:max32", "10",
+      "number of flows to print" },
+
+    { nullptr, Parameter::PT_MAX, nullptr, nullptr, nullptr }
+};
+
 static const Command stream_cmds[] =
 {
     { "dump_flows", dump_flows, nullptr, "dump the flow table in text format" },
     { "dump_flows_binary", dump_flows_binary, nullptr, "dump the flow table in binary format" },
     { "dump_flows_summary", dump_flows_summary, nullptr, "dump flow table summary" },
+    { "top_flows", top_flows, top_flows_params,
+      "print the live and recently closed flows that took the most time to inspect" },
     { nullptr, nullptr, nullptr, nullptr }
 };
 
@@ -83,6 +83,7 @@
 #include "utils/safec.h"
 #include "utils/util.h"
 
+#include "ip_frag_list.h"
 #include "ip_session.h"
 #include "stream_ip.h"
 
@@ -116,54 +117,6 @@ using namespace snort;
 /*  D A T A   S T R U C T U R E S  **********************************/
 
 
-struct Fragment
-{
-    Fragment(uint16_t flen, const uint8_t* fptr, int ord)
-    { init(flen, fptr, ord); }
-
-    Fragment(Fragment* other, int ord)
-    {
-        init(other->flen, other->fptr, ord);
-        data = fptr + (other->data - other->fptr);
-        size = other->size;
-        offset = other->offset;
-        last = other->last;
-    }
-
-    ~Fragment()
-    {
-        delete[] fptr;
-        ip_stats.nodes_released++;
-    }
-
-    uint8_t* data = nullptr;    /* ptr to adjusted start position */
-    uint16_t size = 0;          /* adjusted frag size */
-    uint16_t offset = 0;        /* adjusted offset position */
-
-    uint8_t* fptr = nullptr;    /* free pointer */
-    uint16_t flen = 0;          /* free len, unneeded? */
-
-    Fragment* prev = nullptr;
-    Fragment* next = nullptr;
-
-    int ord = 0;
-    char last = 0;
-
-private:
-    inline void init(uint16_t flen, const uint8_t* fptr, int ord)
-    {
-        assert(flen > 0);
-
-        this->flen = flen;
-        this->fptr = new uint8_t[flen];
-        this->ord = ord;
-
-        memcpy(this->fptr, fptr, flen);
-
-        ip_stats.nodes_created++;
-    }
-};
-
 /*  G L O B A L S  **************************************************/
 
 /* enum for policy names */
@@ -754,6 +707,9 @@ static inline void add_node(FragTracker* ft, Fragment* prev, Fragment* node)
     }
 
     ft->fraglist_count++;
+
+    if ( ft->index )
+        ft->index->add(node);
 }
 
 static inline void delete_node(FragTracker* ft, Fragment* node)
@@ -761,6 +717,9 @@ static inline void delete_node(FragTracker* ft, Fragment* node)
     debug_logf(stream_ip_trace, nullptr, "Deleting list node %p (p %p n %p)\n",
         (void*) node, (void*) node->prev, (void*) node->next);
 
+    if ( ft->index )
+        ft->index->remove(node);
+
     if (node->prev)
     {
         node->prev->next = node->next;
@@ -803,6 +762,12 @@ static void delete_tracker(FragTracker* ft)
         delete dump_me;
     }
     ft->fraglist = nullptr;
+    ft->fraglist_tail = nullptr;
+    ft->fraglist_count = 0;
+
+    delete ft->index;
+    ft->index = nullptr;
+
     if (ft->ip_options_data)
     {
         snort_free(ft->ip_options_data);
@@ -1196,21 +1161,35 @@ int Defrag::insert(Packet* p, FragTracker* ft, FragEngine* fe)
      * Need to figure out where in the frag list this frag should go
      * and who its neighbors are
      */
-    for (idx = ft->fraglist; idx; idx = idx->next)
-    {
-        i++;
-        right = idx;
+    if ( !ft->index and ft->fraglist_count >= FragIndex::min_frags )
+        ft->index = new FragIndex(ft->fraglist);
 
-        debug_logf(stream_ip_trace, p, "%d right o %d s %d ptr %p prv %p nxt %p\n",
-            i, right->offset, right->size, (void*) right,
-            (void*) right->prev, (void*) right->next);
+    if ( ft->index and ft->index->usable() )
+    {
+        right = idx = ft->index->find(frag_offset);
+        left = right ? right->prev : ft->fraglist_tail;
 
-        if (right->offset >= frag_offset)
+        debug_logf(stream_ip_trace, p, "indexed right %p left %p\n",
+            (void*) right, (void*) left);
+    }
+    else
+    {
+        for (idx = ft->fraglist; idx; idx = idx->next)
         {
-            break;
-        }
+            i++;
+            right = idx;
 
-        left = right;
+            debug_logf(stream_ip_trace, p, "%d right o %d s %d ptr %p prv %p nxt %p\n",
+                i, right->offset, right->size, (void*) right,
+                (void*) right->prev, (void*) right->next);
+
+            if (right->offset >= frag_offset)
+            {
+                break;
+            }
+
+            left = right;
+        }
     }
 
     /*
@@ -1338,6 +1317,8 @@ int Defrag::insert(Packet* p, FragTracker* ft, FragEngine* fe)
                     ft->frag_bytes -= (int16_t)overlap;
 
                     right->offset = frag_offset + len;
+                    if ( ft->index )
+                        ft->index->update(right);
                     right->size -= (frag_offset + len - left->offset);
                     right->data += (frag_offset + len - left->offset);
                     ft->frag_bytes -= (frag_offset + len - left->offset);
@@ -1456,6 +1437,8 @@ left_overlap_last:
                 else
                 {
                     right->offset += (int16_t)overlap;
+                    if ( ft->index )
+                        ft->index->update(right);
                     right->data += (int16_t)overlap;
                     right->size -= (int16_t)overlap;
                     ft->frag_bytes -= (int16_t)overlap;
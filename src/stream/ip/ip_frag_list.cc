@@ -0,0 +1,209 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// ip_frag_list.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "ip_frag_list.h"
+
+#include <iterator>
+
+//-------------------------------------------------------------------------
+// slab
+//-------------------------------------------------------------------------
+
+static THREAD_LOCAL FragSlab* slab = nullptr;
+
+void FragSlab::tinit()
+{
+    assert(!slab);
+    slab = new FragSlab;
+}
+
+void FragSlab::tterm()
+{
+    if ( !slab )
+        return;
+
+    for ( auto b : slab->free_list )
+    {
+        while ( b )
+        {
+            Block* next = b->next;
+            delete[] (uint8_t*)b;
+            b = next;
+        }
+    }
+    delete slab;
+    slab = nullptr;
+}
+
+// classes are 64 and then 4 per power of 2: 80, 96, 112, 128, 160, ...
+unsigned FragSlab::get_class(uint16_t len)
+{
+    if ( len <= min_block )
+        return 0;
+
+    unsigned n = len - 1;
+    unsigned msb = 31 - __builtin_clz(n);
+    unsigned shift = msb - 2;
+
+    return 1 + (msb - 6) * 4 + (n >> shift) - 4;
+}
+
+unsigned FragSlab::class_size(unsigned c)
+{
+    if ( !c )
+        return min_block;
+
+    unsigned msb = 6 + (c - 1) / 4;
+    unsigned q = 4 + (c - 1) % 4;
+
+    return (q + 1) << (msb - 2);
+}
+
+// blocks are always allocated at full class size so a block allocated
+// before tinit or after tterm can still be cached by put
+uint8_t* FragSlab::get(uint16_t len)
+{
+    unsigned c = get_class(len);
+
+    if ( slab and slab->free_list[c] )
+    {
+        Block* b = slab->free_list[c];
+        slab->free_list[c] = b->next;
+        slab->cached -= class_size(c);
+        return (uint8_t*)b;
+    }
+    return new uint8_t[class_size(c)];
+}
+
+void FragSlab::put(uint8_t* p, uint16_t len)
+{
+    unsigned c = get_class(len);
+    unsigned size = class_size(c);
+
+    if ( !slab or slab->cached + size > max_cached )
+    {
+        delete[] p;
+        return;
+    }
+    Block* b = (Block*)p;
+    b->next = slab->free_list[c];
+    slab->free_list[c] = b;
+    slab->cached += size;
+}
+
+//-------------------------------------------------------------------------
+// index
+//-------------------------------------------------------------------------
+
+FragIndex::FragIndex(Fragment* head)
+{ rebuild(head); }
+
+// the number of out of order neighbors if off were between prev and next
+unsigned FragIndex::descents(const Fragment* prev, uint16_t off, const Fragment* next)
+{
+    return (prev and prev->offset > off) + (next and off > next->offset);
+}
+
+void FragIndex::rebuild(Fragment* head)
+{
+    map.clear();
+    out_of_order = 0;
+
+    for ( Fragment* f = head; f; f = f->next )
+    {
+        if ( f->prev and f->prev->offset > f->offset )
+            ++out_of_order;
+
+        f->pos = map.emplace_hint(map.end(), f->offset, f);
+    }
+    sorted = !out_of_order;
+}
+
+// the map is in list order so the entry of the next fragment is the
+// exact position; emplace_hint puts equal keys just before the hint.
+// otherwise the map just tracks the fragments until the next rebuild.
+void FragIndex::insert(Fragment* f)
+{
+    if ( !out_of_order and sorted )
+        f->pos = map.emplace_hint(f->next ? f->next->pos : map.end(), f->offset, f);
+
+    else
+    {
+        f->pos = map.emplace(f->offset, f);
+        sorted = false;
+    }
+}
+
+void FragIndex::add(Fragment* f)
+{
+    if ( f->prev and f->next and f->prev->offset > f->next->offset )
+        --out_of_order;
+
+    out_of_order += descents(f->prev, f->offset, f->next);
+    insert(f);
+}
+
+void FragIndex::remove(Fragment* f)
+{
+    out_of_order -= descents(f->prev, f->offset, f->next);
+
+    if ( f->prev and f->next and f->prev->offset > f->next->offset )
+        ++out_of_order;
+
+    map.erase(f->pos);
+}
+
+// the old offset is still the key
+void FragIndex::update(Fragment* f)
+{
+    out_of_order -= descents(f->prev, f->pos->first, f->next);
+    out_of_order += descents(f->prev, f->offset, f->next);
+
+    map.erase(f->pos);
+    insert(f);
+}
+
+bool FragIndex::usable()
+{
+    if ( out_of_order )
+        return false;
+
+    if ( !sorted )
+    {
+        Fragment* head = map.empty() ? nullptr : map.begin()->second;
+
+        while ( head and head->prev )
+            head = head->prev;
+
+        rebuild(head);
+    }
+    return true;
+}
+
+Fragment* FragIndex::find(uint16_t off) const
+{
+    assert(sorted and !out_of_order);
+    auto it = map.lower_bound(off);
+    return it == map.end() ? nullptr : it->second;
+}
@@ -0,0 +1,164 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// ip_frag_list.h
+
+#ifndef IP_FRAG_LIST_H
+#define IP_FRAG_LIST_H
+
+// storage for the fragments held by a FragTracker.
+//
+// the fraglist is kept in offset order and Defrag::insert used to walk it
+// to find the neighbors of each new fragment, so a flood of tiny overlapping
+// fragments cost O(n^2).  FragIndex orders the same fragments by offset with
+// ties in list order so the neighbors are found in O(log n).  a few overlap
+// policy corner cases can leave the list out of order; while it is, the
+// tracker goes back to walking the list, so the neighbors are always exactly
+// those the walk would find.  the index counts the out of order neighbors
+// and re-sorts itself on the next lookup once there are none.
+//
+// fragment payloads come from FragSlab, a per thread cache of blocks in
+// quarter power of 2 size classes, instead of a new[] / delete[] per
+// fragment.  blocks waste at most 20% of their size.
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <map>
+
+#include "ip_session.h"
+
+struct Fragment;
+typedef std::multimap<uint16_t, Fragment*> FragMap;
+
+class FragSlab
+{
+public:
+    // blocks are at least len bytes
+    static uint8_t* get(uint16_t len);
+    static void put(uint8_t*, uint16_t len);
+
+    static void tinit();
+    static void tterm();
+
+    static constexpr unsigned min_block = 64;
+    static constexpr unsigned num_classes = 41;     // 64, 80, 96, 112, 128 .. 64K
+    static constexpr unsigned max_cached = 1 << 20; // bytes per thread
+
+    // the size of the blocks used for len bytes
+    static unsigned get_size(uint16_t len)
+    { return class_size(get_class(len)); }
+
+private:
+    static unsigned get_class(uint16_t len);
+    static unsigned class_size(unsigned c);
+
+    struct Block
+    { Block* next; };
+
+    Block* free_list[num_classes] = { };
+    unsigned cached = 0;
+};
+
+struct Fragment
+{
+    Fragment(uint16_t flen, const uint8_t* fptr, int ord)
+    { init(flen, fptr, ord); }
+
+    Fragment(Fragment* other, int ord)
+    {
+        init(other->flen, other->fptr, ord);
+        data = fptr + (other->data - other->fptr);
+        size = other->size;
+        offset = other->offset;
+        last = other->last;
+    }
+
+    ~Fragment()
+    {
+        FragSlab::put(fptr, flen);
+        ip_stats.nodes_released++;
+    }
+
+    uint8_t* data = nullptr;    /* ptr to adjusted start position */
+    uint16_t size = 0;          /* adjusted frag size */
+    uint16_t offset = 0;        /* adjusted offset position */
+
+    uint8_t* fptr = nullptr;    /* free pointer */
+    uint16_t flen = 0;          /* free len, unneeded? */
+
+    Fragment* prev = nullptr;
+    Fragment* next = nullptr;
+
+    FragMap::iterator pos;      /* in FragIndex */
+
+    int ord = 0;
+    char last = 0;
+
+private:
+    inline void init(uint16_t flen, const uint8_t* fptr, int ord)
+    {
+        assert(flen > 0);
+
+        this->flen = flen;
+        this->fptr = FragSlab::get(flen);
+        this->ord = ord;
+
+        memcpy(this->fptr, fptr, flen);
+
+        ip_stats.nodes_created++;
+    }
+};
+
+class FragIndex
+{
+public:
+    // trackers with fewer fragments just walk the list
+    static constexpr int min_frags = 8;
+
+    // index the list from head
+    FragIndex(Fragment* head);
+
+    // false while the list is out of order
+    // re-sorts the index once the list is back in order
+    bool usable();
+
+    // node was just linked into the list
+    void add(Fragment*);
+
+    // node is about to be unlinked from the list
+    void remove(Fragment*);
+
+    // node's offset was changed in place
+    void update(Fragment*);
+
+    // the first fragment in list order with offset >= off, if any
+    Fragment* find(uint16_t off) const;
+
+private:
+    static unsigned descents(const Fragment* prev, uint16_t off, const Fragment* next);
+    void insert(Fragment*);
+    void rebuild(Fragment* head);
+
+    FragMap map;
+    unsigned out_of_order = 0;   // neighbors with prev->offset > next->offset
+    bool sorted = true;          // map ties are in list order
+};
+
+#endif
+
@@ -24,6 +24,7 @@
 
 struct Fragment;
 struct FragEngine;
+class FragIndex;
 
 extern THREAD_LOCAL IpStats ip_stats;
 
@@ -54,6 +55,7 @@ struct FragTracker
     Fragment* fraglist;      /* list of fragments */
     Fragment* fraglist_tail; /* tail ptr for easy appending */
     int fraglist_count;       /* handy dandy counter */
+    FragIndex* index;         /* fraglist by offset, once it gets long */
 
     uint32_t alert_gid[MAX_FRAG_ALERTS]; /* flag alerts seen in a frag list  */
     uint32_t alert_sid[MAX_FRAG_ALERTS]; /* flag alerts seen in a frag list  */
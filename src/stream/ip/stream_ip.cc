@@ -26,6 +26,7 @@
 #include "log/messages.h"
 
 #include "ip_defrag.h"
+#include "ip_frag_list.h"
 #include "ip_ha.h"
 #include "ip_module.h"
 #include "ip_session.h"
@@ -137,11 +138,13 @@ static void mod_dtor(Module* m)
 static void ip_tinit()
 {
     IpHAManager::tinit();
+    FragSlab::tinit();
 }
 
 static void ip_tterm()
 {
     IpHAManager::tterm();
+    FragSlab::tterm();
 }
 
 static Inspector* ip_ctor(Module* m)
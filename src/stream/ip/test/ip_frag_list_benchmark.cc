@@ -0,0 +1,167 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+// ip_frag_list_benchmark.cc
+
+#ifdef BENCHMARK_TEST
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "catch/catch.hpp"
+
+#include "stream/ip/ip_frag_list.h"
+
+THREAD_LOCAL IpStats ip_stats;
+
+// a flood of 8 byte fragments arriving in order is the worst case for the
+// walk since each one lands at the end of the list
+static const unsigned flood = 8000;
+static const uint8_t payload[8] = { };
+
+static void add_node(Fragment*& head, Fragment*& tail, Fragment* node)
+{
+    node->prev = tail;
+
+    if ( tail )
+        tail->next = node;
+    else
+        head = node;
+
+    tail = node;
+}
+
+static void free_list(Fragment* f)
+{
+    while ( f )
+    {
+        Fragment* next = f->next;
+        delete f;
+        f = next;
+    }
+}
+
+static Fragment* walk(Fragment* head, uint16_t off, Fragment*& left)
+{
+    left = nullptr;
+
+    for ( Fragment* f = head; f; f = f->next )
+    {
+        if ( f->offset >= off )
+            return f;
+
+        left = f;
+    }
+    return nullptr;
+}
+
+TEST_CASE("fragment flood", "[defrag]")
+{
+    BENCHMARK("walk")
+    {
+        Fragment* head = nullptr;
+        Fragment* tail = nullptr;
+        Fragment* left;
+
+        for ( unsigned i = 0; i < flood; ++i )
+        {
+            uint16_t off = i * 8;
+            walk(head, off, left);
+
+            Fragment* f = new Fragment(sizeof(payload), payload, i);
+            f->offset = off;
+            add_node(head, tail, f);
+        }
+        free_list(head);
+        return left;
+    };
+
+    BENCHMARK("index")
+    {
+        Fragment* head = nullptr;
+        Fragment* tail = nullptr;
+        Fragment* left = nullptr;
+        FragIndex* index = nullptr;
+
+        for ( unsigned i = 0; i < flood; ++i )
+        {
+            uint16_t off = i * 8;
+
+            if ( !index and i >= FragIndex::min_frags )
+                index = new FragIndex(head);
+
+            if ( index )
+            {
+                Fragment* right = index->find(off);
+                left = right ? right->prev : tail;
+            }
+            else
+                walk(head, off, left);
+
+            Fragment* f = new Fragment(sizeof(payload), payload, i);
+            f->offset = off;
+            add_node(head, tail, f);
+
+            if ( index )
+                index->add(f);
+        }
+        free_list(head);
+        delete index;
+        return left;
+    };
+}
+
+TEST_CASE("fragment payloads", "[defrag]")
+{
+    static const unsigned frags = 1000;
+    static uint8_t data[1480] = { };
+    uint8_t* blocks[frags];
+
+    BENCHMARK("new")
+    {
+        for ( auto& b : blocks )
+        {
+            b = new uint8_t[sizeof(data)];
+            memcpy(b, data, sizeof(data));
+        }
+        for ( auto b : blocks )
+            delete[] b;
+
+        return blocks[0];
+    };
+
+    FragSlab::tinit();
+
+    BENCHMARK("slab")
+    {
+        for ( auto& b : blocks )
+        {
+            b = FragSlab::get(sizeof(data));
+            memcpy(b, data, sizeof(data));
+        }
+        for ( auto b : blocks )
+            FragSlab::put(b, sizeof(data));
+
+        return blocks[0];
+    };
+
+    FragSlab::tterm();
+}
+
+#endif
+
@@ -0,0 +1,319 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+// ip_frag_list_test.cc
+
+#ifdef CATCH_TEST_BUILD
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "catch/catch.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+#include "stream/ip/ip_frag_list.h"
+
+THREAD_LOCAL IpStats ip_stats;
+
+static const uint8_t payload[64] = { };
+
+// a fraglist with just the parts of Defrag used by the index
+struct FragList
+{
+    ~FragList()
+    {
+        while ( head )
+            remove(head);
+        delete index;
+    }
+
+    Fragment* add(Fragment* prev, uint16_t offset)
+    {
+        Fragment* f = new Fragment(sizeof(payload), payload, 0);
+        f->offset = offset;
+
+        f->prev = prev;
+        f->next = prev ? prev->next : head;
+
+        if ( f->next )
+            f->next->prev = f;
+        else
+            tail = f;
+
+        if ( prev )
+            prev->next = f;
+        else
+            head = f;
+
+        ++count;
+
+        if ( index )
+            index->add(f);
+
+        return f;
+    }
+
+    void remove(Fragment* f)
+    {
+        if ( index )
+            index->remove(f);
+
+        (f->prev ? f->prev->next : head) = f->next;
+        (f->next ? f->next->prev : tail) = f->prev;
+
+        --count;
+        delete f;
+    }
+
+    void move(Fragment* f, uint16_t offset)
+    {
+        f->offset = offset;
+
+        if ( index )
+            index->update(f);
+    }
+
+    // what Defrag::insert does without the index
+    Fragment* walk(uint16_t off) const
+    {
+        for ( Fragment* f = head; f; f = f->next )
+            if ( f->offset >= off )
+                return f;
+
+        return nullptr;
+    }
+
+    Fragment* at(int n) const
+    {
+        Fragment* f = head;
+
+        while ( n-- and f )
+            f = f->next;
+
+        return f;
+    }
+
+    Fragment* head = nullptr;
+    Fragment* tail = nullptr;
+    FragIndex* index = nullptr;
+    int count = 0;
+};
+
+TEST_CASE("index matches walk", "[defrag]")
+{
+    FragList list;
+    Fragment* prev = nullptr;
+
+    for ( uint16_t off = 0; off < 80; off += 8 )
+        prev = list.add(prev, off);
+
+    // duplicate offsets are found in list order
+    list.add(list.at(3), 24);
+    list.add(list.at(3), 24);
+
+    list.index = new FragIndex(list.head);
+    REQUIRE(list.index->usable());
+
+    for ( uint16_t off = 0; off < 100; ++off )
+        CHECK(list.index->find(off) == list.walk(off));
+
+    // insert, trim, and dump like the overlap policies do
+    srand(1);
+
+    for ( int i = 0; i < 2000 and list.index->usable(); ++i )
+    {
+        int n = rand() % (list.count + 1);
+        Fragment* f = list.at(n);
+
+        switch ( rand() % 3 )
+        {
+        case 0:
+        {
+            Fragment* left = f ? f->prev : list.tail;
+            uint16_t lo = left ? left->offset : 0;
+            uint16_t hi = f ? f->offset : lo + 64;
+            list.add(left, lo + rand() % (hi - lo + 1));
+            break;
+        }
+        case 1:
+            if ( f )
+            {
+                uint16_t hi = f->next ? f->next->offset : f->offset + 64;
+                list.move(f, f->offset + rand() % (hi - f->offset + 1));
+            }
+            break;
+        case 2:
+            if ( f )
+                list.remove(f);
+            break;
+        }
+
+        uint16_t off = rand() % 0x4000;
+        CHECK(list.index->find(off) == list.walk(off));
+    }
+    CHECK(list.index->usable());
+}
+
+TEST_CASE("index unusable while out of order", "[defrag]")
+{
+    SECTION("add")
+    {
+        FragList list;
+        Fragment* f = list.add(nullptr, 0);
+        list.index = new FragIndex(list.head);
+
+        list.add(f, 16);
+        CHECK(list.index->usable());
+
+        Fragment* g = list.add(f, 32);
+        CHECK(!list.index->usable());
+
+        list.remove(g);
+        CHECK(list.index->usable());
+        CHECK(list.index->find(1) == list.walk(1));
+    }
+    SECTION("update")
+    {
+        FragList list;
+        Fragment* f = list.add(nullptr, 0);
+        list.add(f, 16);
+        list.index = new FragIndex(list.head);
+
+        list.move(f, 8);
+        CHECK(list.index->usable());
+        CHECK(list.index->find(1) == f);
+
+        list.move(f, 24);
+        CHECK(!list.index->usable());
+
+        list.move(f, 16);
+        CHECK(list.index->usable());
+        CHECK(list.index->find(16) == f);
+    }
+    SECTION("build")
+    {
+        FragList list;
+        Fragment* f = list.add(nullptr, 16);
+        list.add(f, 8);
+
+        list.index = new FragIndex(list.head);
+        CHECK(!list.index->usable());
+
+        list.remove(f);
+        CHECK(list.index->usable());
+        CHECK(list.index->find(0) == list.head);
+    }
+}
+
+TEST_CASE("index re-sorted after out of order", "[defrag]")
+{
+    FragList list;
+    Fragment* prev = nullptr;
+
+    for ( uint16_t off = 0; off < 64; off += 8 )
+        prev = list.add(prev, off);
+
+    list.index = new FragIndex(list.head);
+
+    // ties added while out of order must still be found in list order
+    Fragment* f = list.at(2);
+    list.move(f, 40);
+    list.add(list.at(4), 32);
+    list.add(list.at(3), 24);
+    CHECK(!list.index->usable());
+
+    list.move(f, 16);
+    REQUIRE(list.index->usable());
+
+    for ( uint16_t off = 0; off < 80; ++off )
+        CHECK(list.index->find(off) == list.walk(off));
+
+    // out of order flood; each insert goes where the index says
+    srand(2);
+
+    for ( int i = 0; i < 20000; ++i )
+    {
+        uint16_t off = rand() % 0x2000;
+        REQUIRE(list.index->usable());
+
+        Fragment* right = list.index->find(off);
+
+        if ( !(i % 100) )
+            REQUIRE(right == list.walk(off));
+
+        list.add(right ? right->prev : list.tail, off);
+    }
+    CHECK(list.count == 20010);
+    CHECK(list.index->usable());
+
+    for ( Fragment* g = list.head; g->next; g = g->next )
+        CHECK(g->offset <= g->next->offset);
+}
+
+TEST_CASE("slab reuses blocks", "[defrag]")
+{
+    // without tinit blocks are just freed
+    uint8_t* p = FragSlab::get(100);
+    FragSlab::put(p, 100);
+
+    FragSlab::tinit();
+
+    p = FragSlab::get(100);
+    FragSlab::put(p, 100);
+
+    CHECK(FragSlab::get(112) == p);
+    FragSlab::put(p, 112);
+
+    uint8_t* q = FragSlab::get(113);
+    CHECK(q != p);
+
+    q[127] = 1;
+    FragSlab::put(q, 113);
+
+    q = FragSlab::get(65535);
+    q[65535] = 1;
+    FragSlab::put(q, 65535);
+
+    FragSlab::tterm();
+}
+
+TEST_CASE("slab size classes", "[defrag]")
+{
+    CHECK(FragSlab::get_size(1) == 64);
+    CHECK(FragSlab::get_size(64) == 64);
+    CHECK(FragSlab::get_size(65) == 80);
+    CHECK(FragSlab::get_size(128) == 128);
+    CHECK(FragSlab::get_size(129) == 160);
+    CHECK(FragSlab::get_size(1480) == 1536);
+    CHECK(FragSlab::get_size(1500) == 1536);
+    CHECK(FragSlab::get_size(65535) == 65536);
+
+    for ( unsigned len = 1; len <= 65535; ++len )
+    {
+        unsigned size = FragSlab::get_size(len);
+        CHECK(size >= len);
+
+        if ( len > FragSlab::min_block )
+            CHECK(size - len < size / 5);
+    }
+}
+
+#endif
+
@@ -49,6 +49,7 @@
 
 #include "tcp/held_packet_queue.h"
 #include "tcp/tcp_module.h"
+#include "tcp/tcp_segment_node.h"
 #include "tcp/tcp_session.h"
 #include "tcp/tcp_stream_tracker.h"
 
@@ -392,6 +393,7 @@ void Stream::handle_timeouts(bool idle)
 
     int max_remove = idle ? -1 : 1;       // -1 = all eligible
     TcpStreamTracker::release_held_packets(cur_time, max_remove);
+    TcpSegmentNode::release_expired(cur_time, idle);
 }
 
 bool Stream::prune_flows()
@@ -835,6 +837,9 @@ bool Stream::set_packet_action_to_hold(Packet* p)
     return p->flow->session->set_packet_action_to_hold(p);
 }
 
+bool Stream::defer_finalize(Packet* p, DAQ_Verdict verdict)
+{ return TcpSegmentNode::defer_finalize(p->daq_msg, verdict); }
+
 bool Stream::can_set_no_ack_mode(Flow* flow)
 {
     assert(flow and flow->session and flow->pkt_type == PktType::TCP);
@@ -261,6 +261,10 @@ public:
     static uint8_t get_tcp_options_len(Flow*, bool to_server);
 
     static bool set_packet_action_to_hold(Packet*);
+
+    // true if the packet's DAQ message is still referenced by a queued
+    // segment; stream finalizes it with the verdict when released
+    static bool defer_finalize(Packet*, DAQ_Verdict);
     static bool can_set_no_ack_mode(Flow*);
     static bool set_no_ack_mode(Flow*, bool);
     static void partial_flush(Flow*, bool to_server);
@@ -72,6 +72,19 @@ const StreamBuffer StreamSplitter::reassemble(
     return { nullptr, 0 };
 }
 
+const StreamBuffer StreamSplitter::get_pdu_data(
+    Flow* flow, unsigned total, unsigned offset, const uint8_t* p,
+    unsigned n, uint32_t flags, unsigned& copied, bool in_place)
+{
+    if ( in_place and zero_copy() and !offset and n == total and n <= Packet::max_dsize
+        and (flags & PKT_PDU_TAIL) )
+    {
+        copied = n;
+        return { p, n };
+    }
+    return reassemble(flow, total, offset, p, n, flags, copied);
+}
+
 //--------------------------------------------------------------------------
 // atom splitter
 //--------------------------------------------------------------------------
@@ -80,8 +80,20 @@ public:
         unsigned& copied       // actual data copied (1 <= copied <= len)
         );
 
+    // called by stream instead of reassemble(); a pdu that is all in data
+    // is presented in place if zero_copy() and in_place allow it, otherwise
+    // reassemble() copies it.  the returned data is data when in place.
+    const StreamBuffer get_pdu_data(Flow*, unsigned total, unsigned offset,
+        const uint8_t* data, unsigned len, uint32_t flags, unsigned& copied, bool in_place);
+
     virtual bool restart() { return false; }
     virtual bool sync_on_start() const { return false; }
+
+    // splitters that use the default reassemble() and whose inspectors
+    // don't change the pdu data may return true to have a pdu contained in
+    // a single segment presented in place instead of copied; the segment
+    // is not released until detection of the pdu is complete
+    virtual bool zero_copy() const { return false; }
     virtual bool is_paf() { return false; }
     virtual unsigned max(Flow* = nullptr);
     virtual void go_away() { delete this; }
@@ -109,6 +121,7 @@ public:
     Status scan(Packet*, const uint8_t*, uint32_t, uint32_t, uint32_t*) override;
 
     bool restart() override;
+    bool zero_copy() const override { return true; }
 
 private:
     void reset();
@@ -128,6 +141,7 @@ public:
     LogSplitter(bool);
 
     Status scan(Packet*, const uint8_t*, uint32_t, uint32_t, uint32_t*) override;
+    bool zero_copy() const override { return true; }
 };
 
 //-------------------------------------------------------------------------
@@ -139,6 +153,7 @@ public:
     StopAndWaitSplitter(bool b) : StreamSplitter(b) { }
 
     Status scan(Packet*, const uint8_t*, uint32_t, uint32_t, uint32_t*) override;
+    bool zero_copy() const override { return true; }
 
 private:
     bool saw_data()
@@ -134,6 +134,12 @@ const PegInfo tcp_pegs[] =
     { CountType::SUM, "asymmetric_flows", "number of completed flows having one-way traffic only" },
     { CountType::SUM, "max_bytes_exceeded_hole", "number of times max bytes were exceeded due to a hole" },
     { CountType::SUM, "max_segs_exceeded_hole", "number of times max segs were exceeded due to a hole" },
+    { CountType::SUM, "zero_copy_flushes", "PDUs presented in place from a single segment" },
+    { CountType::SUM, "copied_flushes", "PDUs copied from segments by the splitter" },
+    { CountType::SUM, "retained_bytes", "segment bytes queued in place in DAQ messages" },
+    { CountType::SUM, "copied_bytes", "segment bytes copied when queued" },
+    { CountType::SUM, "retained_copies",
+        "segments copied out of DAQ messages due to DAQ pool pressure or age" },
     { CountType::END, nullptr, nullptr }
 };
 
@@ -239,6 +245,12 @@ static const Parameter s_params[] =
     { "queue_limit", Parameter::PT_TABLE, stream_queue_limit_params, nullptr,
       "limit amount of segment data queued" },
 
+    { "retain_daq_buffers", Parameter::PT_BOOL, nullptr, "false",
+      "queue segments in place in their DAQ messages instead of copying them when not inline" },
+
+    { "retain_age", Parameter::PT_INT, "1:60000", "100",
+      "copy out segments held in DAQ messages longer than given milliseconds" },
+
     { "small_segments", Parameter::PT_TABLE, stream_tcp_small_params, nullptr,
       "limit number of small segments queued" },
 
@@ -359,6 +371,12 @@ bool StreamTcpModule::set(const char*, Value& v, SnortConfig*)
     else if ( v.is("no_ack") )
         config->no_ack = v.get_bool();
 
+    else if ( v.is("retain_daq_buffers") )
+        config->retain_daq_buffers = v.get_bool();
+
+    else if ( v.is("retain_age") )
+        config->retain_age = v.get_uint32();
+
     else if ( v.is("policy") )
         config->policy = static_cast< Normalizer::Policy >( v.get_uint8() );
 
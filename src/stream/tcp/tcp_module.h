@@ -132,6 +132,11 @@ struct TcpStats
     PegCount asymmetric_flows;
     PegCount max_bytes_exceeded_hole;
     PegCount max_segs_exceeded_hole;
+    PegCount zero_copy_flushes;
+    PegCount copied_flushes;
+    PegCount retained_bytes;
+    PegCount copied_bytes;
+    PegCount retained_copies;
 };
 
 extern THREAD_LOCAL struct TcpStats tcpStats;
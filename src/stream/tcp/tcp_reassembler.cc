@@ -131,9 +131,18 @@ void TcpReassemblerBase::show_rebuilt_packet(Packet* pkt)
     }
 }
 
+// a pdu that fits in the current segment can be presented in place when the
+// splitter allows it.  the segment isn't purged until it is acked, which is
+// after detection completes unless detection is offloaded.
+bool TcpReassemblerBase::can_zero_copy() const
+{
+    return splitter->zero_copy() and !DetectionEngine::is_offload_enabled();
+}
+
 int TcpReassemblerBase::flush_data_segments(uint32_t flush_len, Packet* pdu)
 {
     uint32_t flags = PKT_PDU_HEAD;
+    bool in_place = can_zero_copy();
 
     uint32_t to_seq = seglist.cur_rseg->scan_seq() + flush_len;
     uint32_t remaining_bytes = flush_len;
@@ -151,8 +160,14 @@ int TcpReassemblerBase::flush_data_segments(uint32_t flush_len, Packet* pdu)
             assert( bytes_to_copy >= tsn->unscanned() );
 
         unsigned bytes_copied = 0;
-        const StreamBuffer sb = splitter->reassemble(seglist.session->flow, flush_len, total_flushed,
-            tsn->paf_data(), bytes_to_copy, flags, bytes_copied);
+        const StreamBuffer sb = splitter->get_pdu_data(seglist.session->flow, flush_len,
+            total_flushed, tsn->paf_data(), bytes_to_copy, flags, bytes_copied, in_place);
+
+        if ( sb.data == tsn->paf_data() )
+            tcpStats.zero_copy_flushes++;
+
+        else if ( sb.data )
+            tcpStats.copied_flushes++;
 
         if ( sb.data )
         {
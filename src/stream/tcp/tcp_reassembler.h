@@ -202,6 +202,7 @@ public:
 
 protected:
     void show_rebuilt_packet(snort::Packet*);
+    bool can_zero_copy() const;
     int flush_data_segments(uint32_t flush_len, snort::Packet* pdu);
     void prep_pdu(snort::Flow*, snort::Packet*, uint32_t pkt_flags, snort::Packet*);
     snort::Packet* initialize_pdu(snort::Packet*, uint32_t pkt_flags, struct timeval);
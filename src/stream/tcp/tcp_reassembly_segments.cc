@@ -261,7 +261,7 @@ void TcpReassemblySegments::add_reassembly_segment(TcpSegmentDescriptor& tsd, ui
     }
 
     // FIXIT-L don't allocate overlapped part
-    TcpSegmentNode* tsn = TcpSegmentNode::init(tsd);
+    TcpSegmentNode* tsn = TcpSegmentNode::init(tsd, *session->tcp_config);
 
     tsn->seq = seq;
     tsn->offset = slide;
@@ -25,13 +25,74 @@
 
 #include "tcp_segment_node.h"
 
+#include <algorithm>
+#include <vector>
+
+#include "main/snort_config.h"
+#include "packet_io/sfdaq_instance.h"
 #include "utils/util.h"
 
 #include "tcp_module.h"
 #include "tcp_segment_descriptor.h"
+#include "tcp_stream_config.h"
 
 using namespace snort;
 
+// a segment retained in place in its DAQ message.  the oldest are first on
+// the list so they are the first copied out when the DAQ pool runs low or
+// they get too old.  the analyzer defers finalizing the message until the
+// segment is released.
+struct RetainedMsg
+{
+    RetainedMsg* prev;
+    RetainedMsg* next;
+
+    TcpSegmentNode* tsn;
+    DAQ_Msg_h msg;
+    SFDAQInstance* daq;
+    struct timeval tv;
+    struct timeval expires;
+    DAQ_Verdict verdict;
+    bool deferred;
+};
+
+static THREAD_LOCAL RetainedMsg* retained_head = nullptr;
+static THREAD_LOCAL RetainedMsg* retained_tail = nullptr;
+
+// retained messages still waiting for their verdict.  usually just the
+// current packet's but offloaded packets get their verdicts out of order.
+static THREAD_LOCAL std::vector<RetainedMsg*>* unfinalized = nullptr;
+
+static std::vector<RetainedMsg*>::iterator find_unfinalized(DAQ_Msg_h msg)
+{
+    return std::find_if(unfinalized->begin(), unfinalized->end(),
+        [msg](const RetainedMsg* rm) { return rm->msg == msg; });
+}
+
+static void release(RetainedMsg* rm)
+{
+    if ( rm->prev )
+        rm->prev->next = rm->next;
+    else
+        retained_head = rm->next;
+
+    if ( rm->next )
+        rm->next->prev = rm->prev;
+    else
+        retained_tail = rm->prev;
+
+    if ( rm->deferred )
+        rm->daq->finalize_message(rm->msg, rm->verdict);
+    else
+    {
+        auto it = find_unfinalized(rm->msg);
+        assert(it != unfinalized->end());
+        unfinalized->erase(it);
+    }
+
+    snort_free(rm);
+}
+
 #define USE_RESERVE
 #ifdef USE_RESERVE
 static THREAD_LOCAL TcpSegmentNode* reserved = nullptr;
@@ -48,10 +109,25 @@ void TcpSegmentNode::setup()
     reserved = nullptr;
     reserve_sz = 0;
 #endif
+    retained_head = retained_tail = nullptr;
+    unfinalized = new std::vector<RetainedMsg*>;
 }
 
 void TcpSegmentNode::clear()
 {
+    // flows are purged before the DAQ stops so anything left here is
+    // abandoned along with its segments
+    while ( retained_head )
+    {
+        RetainedMsg* rm = retained_head;
+        retained_head = rm->next;
+        snort_free(rm);
+    }
+    retained_tail = nullptr;
+
+    delete unfinalized;
+    unfinalized = nullptr;
+
 #ifdef USE_RESERVE
     while ( reserved )
     {
@@ -91,6 +167,117 @@ TcpSegmentNode* TcpSegmentNode::create(
     tsn->tv = tv;
     tsn->length = len;
     memcpy(tsn->data, payload, len);
+    tcpStats.copied_bytes += len;
+
+    tsn->prev = tsn->next = nullptr;
+    tsn->ext = nullptr;
+    tsn->retained = nullptr;
+
+    tsn->seq = 0;
+    tsn->offset = 0;
+    tsn->cursor = 0;
+    tsn->ts = 0;
+
+    return tsn;
+}
+
+// the verdict of a retained message is deferred so this is only done when
+// the verdict doesn't hold up traffic.  the data of rebuilt packets isn't in
+// the DAQ message and a message is only retained by one segment.
+bool TcpSegmentNode::can_retain(const Packet* p)
+{
+    if ( !p->daq_msg or !p->daq_instance or p->is_rebuilt() )
+        return false;
+
+    if ( SnortConfig::get_conf()->adaptor_inline_mode() )
+        return false;
+
+    if ( p->daq_instance->get_pool_available() < p->daq_instance->get_batch_size() )
+        return false;
+
+    return find_unfinalized(p->daq_msg) == unfinalized->end();
+}
+
+// copy out enough of the oldest segments to refill a batch when the pool is
+// low and any that have been retained longer than max_age ms
+void TcpSegmentNode::release_retained(const Packet* p, uint32_t max_age)
+{
+    unsigned low = 0;
+
+    if ( p->daq_instance and
+        p->daq_instance->get_pool_available() < p->daq_instance->get_batch_size() )
+        low = p->daq_instance->get_batch_size();
+
+    struct timeval age = { (time_t)(max_age / 1000), (suseconds_t)((max_age % 1000) * 1000) };
+    struct timeval oldest;
+    timersub(&p->pkth->ts, &age, &oldest);
+
+    while ( retained_head )
+    {
+        if ( low )
+            --low;
+
+        else if ( timercmp(&retained_head->tv, &oldest, >) )
+            break;
+
+        retained_head->tsn->copy_out();
+    }
+}
+
+// copy out segments retained longer than their retain_age when no segment
+// is queued to do it, so a quiet thread doesn't hold on to DAQ messages.
+// messages are in arrival order so only the oldest are checked unless all.
+void TcpSegmentNode::release_expired(const struct timeval& now, bool all)
+{
+    RetainedMsg* rm = retained_head;
+
+    while ( rm )
+    {
+        RetainedMsg* next = rm->next;
+
+        if ( !timercmp(&now, &rm->expires, <) )
+            rm->tsn->copy_out();
+
+        else if ( !all )
+            break;
+
+        rm = next;
+    }
+}
+
+TcpSegmentNode* TcpSegmentNode::retain(const Packet* p, uint16_t len, uint32_t max_age)
+{
+    TcpSegmentNode* tsn = (TcpSegmentNode*)snort_alloc(sizeof(*tsn));
+    RetainedMsg* rm = (RetainedMsg*)snort_alloc(sizeof(*rm));
+
+    rm->tsn = tsn;
+    rm->msg = p->daq_msg;
+    rm->daq = p->daq_instance;
+    rm->tv = p->pkth->ts;
+    rm->verdict = MAX_DAQ_VERDICT;
+    rm->deferred = false;
+
+    struct timeval age = { (time_t)(max_age / 1000), (suseconds_t)((max_age % 1000) * 1000) };
+    timeradd(&rm->tv, &age, &rm->expires);
+
+    rm->next = nullptr;
+    rm->prev = retained_tail;
+
+    if ( retained_tail )
+        retained_tail->next = rm;
+    else
+        retained_head = rm;
+
+    retained_tail = rm;
+    unfinalized->emplace_back(rm);
+
+    tsn->tv = p->pkth->ts;
+    tsn->length = len;
+    tsn->size = len;
+    tsn->ext = const_cast<uint8_t*>(p->data);
+    tsn->retained = rm;
+    tcpStats.retained_bytes += len;
+    tcpStats.mem_in_use += len;
 
     tsn->prev = tsn->next = nullptr;
 
@@ -102,9 +289,49 @@ TcpSegmentNode* TcpSegmentNode::create(
     return tsn;
 }
 
-TcpSegmentNode* TcpSegmentNode::init(const TcpSegmentDescriptor& tsd)
+void TcpSegmentNode::copy_out()
+{
+    assert(retained);
+    uint8_t* copy = (uint8_t*)snort_alloc(size);
+    memcpy(copy, ext, size);
+    ext = copy;
+
+    tcpStats.retained_copies++;
+
+    release(retained);
+    retained = nullptr;
+}
+
+bool TcpSegmentNode::defer_finalize(DAQ_Msg_h msg, DAQ_Verdict verdict)
+{
+    if ( !unfinalized or unfinalized->empty() )
+        return false;
+
+    auto it = find_unfinalized(msg);
+
+    if ( it == unfinalized->end() )
+        return false;
+
+    RetainedMsg* rm = *it;
+    unfinalized->erase(it);
+
+    rm->verdict = verdict;
+    rm->deferred = true;
+    return true;
+}
+
+TcpSegmentNode* TcpSegmentNode::init(const TcpSegmentDescriptor& tsd, const TcpStreamConfig& config)
 {
-    return create(tsd.get_pkt()->pkth->ts, tsd.get_pkt()->data, tsd.get_len());
+    const Packet* p = tsd.get_pkt();
+
+    if ( config.retain_daq_buffers )
+    {
+        release_retained(p, config.retain_age);
+
+        if ( can_retain(p) )
+            return retain(p, tsd.get_len(), config.retain_age);
+    }
+    return create(p->pkth->ts, p->data, tsd.get_len());
 }
 
 TcpSegmentNode* TcpSegmentNode::init(TcpSegmentNode& tsn)
@@ -114,6 +341,18 @@ TcpSegmentNode* TcpSegmentNode::init(TcpSegmentNode& tsn)
 
 void TcpSegmentNode::term()
 {
+    if ( ext )
+    {
+        if ( retained )
+            release(retained);
+        else
+            snort_free(ext);
+
+        tcpStats.mem_in_use -= size;
+        snort_free(this);
+        tcpStats.segs_released++;
+        return;
+    }
 #ifdef USE_RESERVE
     if ( size == res_max and reserve_sz < num_res )
     {
@@ -140,12 +379,12 @@ bool TcpSegmentNode::is_retransmit(const uint8_t* rdata, uint16_t rsize,
     if ( orig_dsize == unscanned() )
     {
         uint16_t cmp_len = ( length <= rsize ) ? length : rsize;
-        if ( !memcmp(data, rdata, cmp_len) )
+        if ( !memcmp(base(), rdata, cmp_len) )
             return true;
     }
     //Checking for a possible split of segment in which case
     //we compare complete data of the segment to find a retransmission
-    else if ( (orig_dsize == rsize) and !memcmp(data, rdata, rsize) )
+    else if ( (orig_dsize == rsize) and !memcmp(base(), rdata, rsize) )
     {
         if ( full_retransmit )
             *full_retransmit = true;
@@ -22,6 +22,8 @@
 #ifndef TCP_SEGMENT_NODE_H
 #define TCP_SEGMENT_NODE_H
 
+#include <daq_common.h>
+
 #include <cassert>
 
 #include "protocols/packet.h"
@@ -30,6 +32,8 @@
 #include "tcp_defs.h"
 
 class TcpSegmentDescriptor;
+class TcpStreamConfig;
+struct RetainedMsg;
 
 //-----------------------------------------------------------------
 // we make a lot of TcpSegments so it is organized by member
@@ -42,9 +46,14 @@ class TcpSegmentNode
 {
 private:
     static TcpSegmentNode* create(const struct timeval& tv, const uint8_t* segment, uint16_t len);
+    static TcpSegmentNode* retain(const snort::Packet*, uint16_t len, uint32_t max_age);
+    static bool can_retain(const snort::Packet*);
+    static void release_retained(const snort::Packet*, uint32_t max_age);
+
+    void copy_out();
 
 public:
-    static TcpSegmentNode* init(const TcpSegmentDescriptor&);
+    static TcpSegmentNode* init(const TcpSegmentDescriptor&, const TcpStreamConfig&);
     static TcpSegmentNode* init(TcpSegmentNode&);
 
     void term();
@@ -52,13 +61,23 @@ public:
     static void setup();
     static void clear();
 
+    // called instead of finalizing a message that is still referenced by
+    // a segment; it is finalized with the given verdict when released
+    static bool defer_finalize(DAQ_Msg_h, DAQ_Verdict);
+
+    // called from the timeout path to release segments past their age
+    static void release_expired(const struct timeval& now, bool all);
+
     bool is_retransmit(const uint8_t*, uint16_t size, uint32_t, uint16_t, bool*);
 
+    uint8_t* base()
+    { return ext ? ext : data; }
+
     uint8_t* payload()
-    { return data + offset; }
+    { return base() + offset; }
 
     uint8_t* paf_data()
-    { return data + offset + cursor; }
+    { return base() + offset + cursor; }
 
     uint32_t start_seq() const
     { return seq + offset; }
@@ -103,6 +122,9 @@ public:
     TcpSegmentNode* prev;
     TcpSegmentNode* next;
 
+    uint8_t* ext;           // payload if not in data: in a DAQ message or copied out
+    RetainedMsg* retained;  // DAQ message referenced by ext
+
     struct timeval tv;
     uint32_t ts;
 
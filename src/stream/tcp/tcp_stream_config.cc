@@ -56,6 +56,8 @@ void TcpStreamConfig::show() const
     str += " }";
     ConfigLogger::log_value("asymmetric_ids", str.c_str());
     ConfigLogger::log_value("reassemble_async", "deprecated, has no effect");
+    ConfigLogger::log_flag("retain_daq_buffers", retain_daq_buffers);
+    ConfigLogger::log_value("retain_age", retain_age);
     ConfigLogger::log_value("session_timeout", session_timeout);
 
     str = "{ count = ";
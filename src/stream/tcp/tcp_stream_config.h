@@ -55,8 +55,10 @@ public:
     uint32_t max_consec_small_seg_size = STREAM_DEFAULT_MAX_SMALL_SEG_SIZE;
 
     uint32_t paf_max = 16384;
+    uint32_t retain_age = 100;
 
     bool no_ack = false;
+    bool retain_daq_buffers = false;
     uint32_t embryonic_timeout = STREAM_DEFAULT_SSN_TIMEOUT;
     uint32_t idle_timeout = 3600;
 };
@@ -0,0 +1,260 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+
+// tcp_segment_node_test.cc
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "main/snort_config.h"
+#include "packet_io/sfdaq_instance.h"
+#include "stream/tcp/tcp_module.h"
+#include "stream/tcp/tcp_segment_descriptor.h"
+#include "stream/tcp/tcp_segment_node.h"
+#include "stream/tcp/tcp_stream_config.h"
+
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+
+using namespace snort;
+
+//--------------------------------------------------------------------------
+// mocks
+//--------------------------------------------------------------------------
+
+THREAD_LOCAL TcpStats tcpStats;
+
+static SnortConfig snort_conf;
+static std::vector<std::pair<DAQ_Msg_h, DAQ_Verdict>> finalized;
+
+namespace snort
+{
+SnortConfig::SnortConfig(const char*)
+{
+    daq_config = nullptr;
+    thread_config = nullptr;
+}
+SnortConfig::~SnortConfig() = default;
+const SnortConfig* SnortConfig::get_conf() { return &snort_conf; }
+
+// plenty of messages available
+SFDAQInstance::SFDAQInstance(const char*, unsigned, const SFDAQConfig*) :
+    instance_id(0), daq_msgs(nullptr), batch_size(4)
+{ pool_available = 64; }
+
+SFDAQInstance::~SFDAQInstance() = default;
+
+int SFDAQInstance::finalize_message(DAQ_Msg_h msg, DAQ_Verdict verdict)
+{
+    finalized.emplace_back(msg, verdict);
+    return 0;
+}
+
+Packet::Packet(bool) { }
+Packet::~Packet() = default;
+}
+
+TcpSegmentDescriptor::TcpSegmentDescriptor(Flow* f, Packet* p, uint32_t, uint16_t) :
+    flow(f), pkt(p), tcph(nullptr), packet_number(0)
+{ }
+
+TcpStreamConfig::TcpStreamConfig() = default;
+
+//--------------------------------------------------------------------------
+// tests
+//--------------------------------------------------------------------------
+
+// a packet in its own DAQ message
+struct TestPacket
+{
+    DAQ_PktHdr_t pkth = { };
+    std::string payload;
+    Packet pkt { false };
+
+    TestPacket(SFDAQInstance& daq, uintptr_t msg, const char* s, time_t secs, unsigned usecs = 0)
+        : payload(s)
+    {
+        pkth.ts.tv_sec = secs;
+        pkth.ts.tv_usec = usecs;
+
+        pkt.pkth = &pkth;
+        pkt.data = (const uint8_t*)payload.data();
+        pkt.dsize = payload.size();
+        pkt.packet_flags = 0;
+        pkt.daq_msg = (DAQ_Msg_h)msg;
+        pkt.daq_instance = &daq;
+    }
+
+    TcpSegmentNode* queue(const TcpStreamConfig& config)
+    {
+        TcpSegmentDescriptor tsd(nullptr, &pkt, 0, 0);
+        return TcpSegmentNode::init(tsd, config);
+    }
+};
+
+// what stream_tcp flushes from the segment
+static std::string flush(TcpSegmentNode* tsn)
+{
+    std::string pdu((const char*)tsn->paf_data(), tsn->unscanned());
+    tsn->advance_cursor(tsn->unscanned());
+    return pdu;
+}
+
+TEST_GROUP(retained_segments)
+{
+    SFDAQInstance daq { nullptr, 0, nullptr };
+    TcpStreamConfig config;
+
+    void setup() override
+    {
+        TcpSegmentNode::setup();
+        tcpStats = { };
+        finalized.clear();
+
+        config.retain_daq_buffers = true;
+        config.retain_age = 100;
+    }
+
+    void teardown() override
+    {
+        TcpSegmentNode::clear();
+    }
+};
+
+TEST(retained_segments, retain_then_flush)
+{
+    TestPacket p(daq, 1, "retained payload", 1);
+    TcpSegmentNode* tsn = p.queue(config);
+
+    CHECK(tsn->paf_data() == p.pkt.data);
+    CHECK_EQUAL(16, tcpStats.retained_bytes);
+    CHECK_EQUAL(0, tcpStats.copied_bytes);
+    CHECK_EQUAL(16, tcpStats.mem_in_use);
+
+    CHECK(TcpSegmentNode::defer_finalize(p.pkt.daq_msg, DAQ_VERDICT_PASS));
+    CHECK(finalized.empty());
+
+    CHECK(flush(tsn) == "retained payload");
+
+    tsn->term();
+    CHECK_EQUAL(1, finalized.size());
+    CHECK(finalized[0].first == p.pkt.daq_msg);
+    CHECK(finalized[0].second == DAQ_VERDICT_PASS);
+    CHECK_EQUAL(0, tcpStats.mem_in_use);
+}
+
+TEST(retained_segments, copy_out_when_old)
+{
+    TestPacket p1(daq, 1, "first", 1);
+    TcpSegmentNode* tsn1 = p1.queue(config);
+    CHECK(TcpSegmentNode::defer_finalize(p1.pkt.daq_msg, DAQ_VERDICT_PASS));
+
+    // retain_age later, the first is copied out and its message released
+    TestPacket p2(daq, 2, "second", 1, 100001);
+    TcpSegmentNode* tsn2 = p2.queue(config);
+
+    CHECK_EQUAL(1, tcpStats.retained_copies);
+    CHECK_EQUAL(1, finalized.size());
+    CHECK(finalized[0].first == p1.pkt.daq_msg);
+    CHECK(tsn1->paf_data() != p1.pkt.data);
+    CHECK(tsn2->paf_data() == p2.pkt.data);
+    CHECK_EQUAL(11, tcpStats.mem_in_use);
+
+    p1.payload.assign(5, 'x');
+    CHECK(flush(tsn1) == "first");
+    CHECK(flush(tsn2) == "second");
+
+    // released before the verdict, the analyzer finalizes it
+    tsn2->term();
+    CHECK_FALSE(TcpSegmentNode::defer_finalize(p2.pkt.daq_msg, DAQ_VERDICT_PASS));
+    CHECK_EQUAL(1, finalized.size());
+
+    tsn1->term();
+    CHECK_EQUAL(0, tcpStats.mem_in_use);
+}
+
+TEST(retained_segments, verdicts_out_of_order)
+{
+    TestPacket p1(daq, 1, "offloaded", 1);
+    TestPacket p2(daq, 2, "next", 1);
+
+    TcpSegmentNode* tsn1 = p1.queue(config);
+    TcpSegmentNode* tsn2 = p2.queue(config);
+
+    CHECK(TcpSegmentNode::defer_finalize(p2.pkt.daq_msg, DAQ_VERDICT_PASS));
+    CHECK(TcpSegmentNode::defer_finalize(p1.pkt.daq_msg, DAQ_VERDICT_BLOCK));
+    CHECK(finalized.empty());
+
+    tsn1->term();
+    tsn2->term();
+
+    CHECK_EQUAL(2, finalized.size());
+    CHECK(finalized[0].first == p1.pkt.daq_msg);
+    CHECK(finalized[0].second == DAQ_VERDICT_BLOCK);
+    CHECK(finalized[1].first == p2.pkt.daq_msg);
+    CHECK(finalized[1].second == DAQ_VERDICT_PASS);
+}
+
+TEST(retained_segments, released_when_quiet)
+{
+    TestPacket p(daq, 1, "quiet", 1);
+    TcpSegmentNode* tsn = p.queue(config);
+    CHECK(TcpSegmentNode::defer_finalize(p.pkt.daq_msg, DAQ_VERDICT_PASS));
+
+    // no segment follows, the timeout path releases it once retain_age passes
+    TcpSegmentNode::release_expired({ 1, 99999 }, false);
+    CHECK(finalized.empty());
+
+    TcpSegmentNode::release_expired({ 1, 100000 }, true);
+    CHECK_EQUAL(1, tcpStats.retained_copies);
+    CHECK_EQUAL(1, finalized.size());
+    CHECK(finalized[0].first == p.pkt.daq_msg);
+
+    p.payload.assign(5, 'x');
+    CHECK(flush(tsn) == "quiet");
+
+    tsn->term();
+    CHECK_EQUAL(1, finalized.size());
+    CHECK_EQUAL(0, tcpStats.mem_in_use);
+}
+
+TEST(retained_segments, copied_when_disabled)
+{
+    config.retain_daq_buffers = false;
+
+    TestPacket p(daq, 1, "copied", 1);
+    TcpSegmentNode* tsn = p.queue(config);
+
+    CHECK(tsn->paf_data() != p.pkt.data);
+    CHECK_EQUAL(6, tcpStats.copied_bytes);
+    CHECK_FALSE(TcpSegmentNode::defer_finalize(p.pkt.daq_msg, DAQ_VERDICT_PASS));
+    CHECK(flush(tsn) == "copied");
+
+    tsn->term();
+}
+
+int main(int argc, char** argv)
+{
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
@@ -28,6 +28,10 @@
 #include "stream/flush_bucket.h"
 #include "stream/stream.h"
 
+#include <cstring>
+#include <string>
+#include <vector>
+
 #include <CppUTest/CommandLineTestRunner.h>
 #include <CppUTest/TestHarness.h>
 
@@ -53,8 +57,13 @@ Packet::~Packet() = default;
 struct Packet* DetectionEngine::get_current_packet()
 { return nullptr; }
 
-uint8_t* DetectionEngine::get_next_buffer(unsigned int&)
-{ return nullptr; }
+static uint8_t pdu_buf[Packet::max_dsize];
+
+uint8_t* DetectionEngine::get_next_buffer(unsigned int& max)
+{
+    max = sizeof(pdu_buf);
+    return pdu_buf;
+}
 
 StreamSplitter* Stream::get_splitter(Flow*, bool)
 { return next_splitter; }
@@ -155,6 +164,102 @@ TEST(other_splitter, stop_and_wait)
     CHECK(flushed == 2);
 }
 
+//--------------------------------------------------------------------------
+// pdu data tests
+//--------------------------------------------------------------------------
+
+// flush len bytes starting at off in the first segment like stream_tcp does
+static std::string flush(StreamSplitter& s, const std::vector<std::string>& segs,
+    unsigned off, unsigned len, bool in_place, bool& was_in_place)
+{
+    uint32_t flags = PKT_PDU_HEAD;
+    unsigned total = 0;
+    was_in_place = false;
+
+    for ( const auto& seg : segs )
+    {
+        const uint8_t* data = (const uint8_t*)seg.data() + off;
+        unsigned n = std::min((unsigned)seg.size() - off, len - total);
+        unsigned copied = 0;
+        off = 0;
+
+        if ( total + n == len )
+            flags |= PKT_PDU_TAIL;
+
+        StreamBuffer sb = s.get_pdu_data(nullptr, len, total, data, n, flags, copied, in_place);
+        CHECK(copied == n);
+
+        total += copied;
+        flags = 0;
+
+        if ( sb.data )
+        {
+            was_in_place = (sb.data == data);
+            return std::string((const char*)sb.data, sb.length);
+        }
+    }
+    return "";
+}
+
+TEST_GROUP(pdu_data)
+{
+    std::vector<std::string> segs;
+
+    void setup() override
+    {
+        segs.emplace_back(std::string(100, 'a') + "0123456789");
+        segs.emplace_back("ABCDEFGHIJ" + std::string(50, 'b'));
+    }
+};
+
+TEST(pdu_data, in_segment)
+{
+    LogSplitter s(true);
+    bool in_place;
+
+    std::string copy = flush(s, segs, 95, 15, false, in_place);
+    CHECK(!in_place);
+    CHECK(copy == "aaaaa0123456789");
+
+    std::string zero = flush(s, segs, 95, 15, true, in_place);
+    CHECK(in_place);
+    CHECK(zero == copy);
+}
+
+TEST(pdu_data, across_segments)
+{
+    LogSplitter s(true);
+    bool in_place;
+
+    std::string copy = flush(s, segs, 100, 20, false, in_place);
+    CHECK(!in_place);
+    CHECK(copy == "0123456789ABCDEFGHIJ");
+
+    std::string zero = flush(s, segs, 100, 20, true, in_place);
+    CHECK(!in_place);
+    CHECK(zero == copy);
+}
+
+// the base splitter doesn't allow zero copy
+class CopySplitter : public StreamSplitter
+{
+public:
+    CopySplitter() : StreamSplitter(true) { }
+
+    Status scan(Packet*, const uint8_t*, uint32_t, uint32_t, uint32_t*) override
+    { return SEARCH; }
+};
+
+TEST(pdu_data, splitter_opts_out)
+{
+    CopySplitter s;
+    bool in_place;
+
+    std::string data = flush(s, segs, 0, 10, true, in_place);
+    CHECK(!in_place);
+    CHECK(data == std::string(10, 'a'));
+}
+
 //-------------------------------------------------------------------------
 // main
 //-------------------------------------------------------------------------
@@ -150,6 +150,8 @@ const PegInfo pc_names[] =
     { CountType::SUM, "offload_fallback", "fast pattern offload search fallback attempts" },
     { CountType::SUM, "offload_failures", "fast pattern offload search failures" },
     { CountType::SUM, "offload_suspends", "fast pattern search suspends due to offload context chains" },
+    { CountType::MAX, "offload_queue_max", "maximum depth of a packet thread's offload queue" },
+    { CountType::SUM, "offload_steals", "offloaded searches run by a worker for another worker's packet thread" },
     { CountType::SUM, "cont_creations", "total number of continuations created" },
     { CountType::SUM, "cont_recalls", "total number of continuations recalled" },
     { CountType::SUM, "cont_flows", "total number of flows using continuation" },
@@ -175,6 +177,8 @@ const PegInfo proc_names[] =
     { CountType::SUM, "attribute_table_reloads", "number of times hosts attribute table was reloaded" },
     { CountType::SUM, "attribute_table_hosts", "number of hosts added to the attribute table" },
     { CountType::SUM, "attribute_table_overflow", "number of host additions that failed due to attribute table full" },
+    { CountType::SUM, "reload_mpse_reused", "number of search engines adopted from the previous config on reload" },
+    { CountType::SUM, "reload_mpse_rebuilt", "number of search engines compiled on reload" },
     { CountType::END, nullptr, nullptr }
 };
 
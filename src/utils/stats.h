@@ -58,6 +58,8 @@ struct PacketCount
     PegCount offload_fallback;
     PegCount offload_failures;
     PegCount offload_suspends;
+    PegCount offload_queue_max;
+    PegCount offload_steals;
     PegCount cont_creations;
     PegCount cont_recalls;
     PegCount cont_flows;
@@ -82,6 +84,8 @@ struct ProcessCount
     PegCount attribute_table_reloads;
     PegCount attribute_table_hosts;     // FIXIT-D - remove when host attribute pegs updated
     PegCount attribute_table_overflow;  // FIXIT-D - remove when host attribute pegs updated
+    PegCount reload_mpse_reused;
+    PegCount reload_mpse_rebuilt;
 };
 
 extern ProcessCount proc_stats;
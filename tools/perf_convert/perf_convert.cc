@@ -0,0 +1,159 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+// perf_convert.cc
+
+// converts perf_monitor format = binary files to csv or json
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <getopt.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "network_inspectors/perf_monitor/binary_formatter.h"
+#include "network_inspectors/perf_monitor/csv_formatter.h"
+#include "network_inspectors/perf_monitor/json_formatter.h"
+
+const struct option longopts[] =
+{
+    { "help",   no_argument,       0, 'h' },
+    { "format", required_argument, 0, 'f' },
+    { "output", required_argument, 0, 'o' },
+    { 0, 0, 0, 0 },
+};
+
+struct Options
+{
+    std::string format = "csv";
+    std::string output;
+};
+
+static void usage(const char* prog)
+{
+    printf("usage: %s [-f csv|json] [-o file] file.pmbf ...\n", prog);
+    printf("  -f, --format    csv or json (default csv)\n");
+    printf("  -o, --output    write to this file instead of stdout\n");
+}
+
+static bool parse(int argc, char* argv[], Options& opts)
+{
+    int c;
+
+    while ( (c = getopt_long(argc, argv, "hf:o:", longopts, nullptr)) != -1 )
+    {
+        switch ( c )
+        {
+        case 'f':
+            opts.format = optarg;
+            break;
+        case 'o':
+            opts.output = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return false;
+        }
+    }
+
+    if ( optind == argc or (opts.format != "csv" and opts.format != "json") )
+    {
+        usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+static PerfFormatter* get_formatter(const Options& opts, const std::string& name)
+{
+    if ( opts.format == "json" )
+        return new JSONFormatter(name);
+
+    return new CSVFormatter(name);
+}
+
+int main(int argc, char* argv[])
+{
+    Options opts;
+
+    if ( !parse(argc, argv, opts) )
+        return 1;
+
+    FILE* out = stdout;
+
+    if ( !opts.output.empty() and !(out = fopen(opts.output.c_str(), "w")) )
+    {
+        fprintf(stderr, "can't open %s: %s\n", opts.output.c_str(), strerror(errno));
+        return 1;
+    }
+
+    BinaryReader reader;
+    std::unique_ptr<PerfFormatter> fmt;
+    int ret = 0;
+
+    for ( int i = optind; i < argc; ++i )
+    {
+        FILE* in = fopen(argv[i], "rb");
+
+        if ( !in )
+        {
+            fprintf(stderr, "can't open %s: %s\n", argv[i], strerror(errno));
+            ret = 1;
+            break;
+        }
+
+        if ( !reader.open(in) )
+        {
+            if ( fmt )
+                fprintf(stderr, "%s doesn't have the fields of %s\n", argv[i], argv[optind]);
+            else
+                fprintf(stderr, "%s is not a binary perf_monitor file\n", argv[i]);
+            fclose(in);
+            ret = 1;
+            break;
+        }
+
+        if ( !fmt )
+        {
+            fmt.reset(get_formatter(opts, reader.get_tracker_name()));
+            reader.register_fields(*fmt);
+            fmt->init_output(out);
+        }
+
+        time_t t;
+
+        while ( reader.read(t) )
+            fmt->write(out, t);
+
+        fclose(in);
+    }
+
+    if ( fmt )
+        fmt->finalize_output(out);
+
+    if ( out != stdout )
+        fclose(out);
+
+    return ret;
+}
+
@@ -0,0 +1,321 @@
+//--------------------------------------------------------------------------
+// Copyright (C) 2026-2026 Cisco and/or its affiliates. All rights reserved.
+//
+// This program is free software; you can redistribute it and/or modify it
+// under the terms of the GNU General Public License Version 2 as published
+// by the Free Software Foundation.  You may not use, modify or distribute
+// this program under any other version of the GNU General Public License.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+//--------------------------------------------------------------------------
+// snort_stats.cc
+
+// reads the peg counts snort publishes with perf_monitor.stats_segment
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "network_inspectors/perf_monitor/stats_segment_defs.h"
+
+#define DEFAULT_NAME "/snort_stats"
+#define MAX_RETRIES 1000
+
+enum PegType : uint8_t { PEG_SUM = 1, PEG_NOW = 2, PEG_MAX = 3 };
+
+const struct option longopts[] =
+{
+    { "help",     no_argument,       0, 'h' },
+    { "name",     required_argument, 0, 'n' },
+    { "module",   required_argument, 0, 'm' },
+    { "all",      no_argument,       0, 'a' },
+    { "threads",  no_argument,       0, 't' },
+    { "interval", required_argument, 0, 'i' },
+    { 0, 0, 0, 0 },
+};
+
+struct Options
+{
+    std::string name = DEFAULT_NAME;
+    std::string module;
+    bool all = false;
+    bool threads = false;
+    unsigned interval = 0;
+};
+
+class Segment
+{
+public:
+    ~Segment()
+    { unmap(); }
+
+    bool map(const char* name);
+    void unmap();
+
+    bool retired() const
+    { return hdr->state.load(std::memory_order_acquire) == SSS_RETIRED; }
+
+    bool read_thread(unsigned, std::vector<uint64_t>&, uint64_t& updates) const;
+
+    const StatsSegmentHeader* hdr = nullptr;
+    const StatsSegmentModule* modules = nullptr;
+    const StatsSegmentPeg* pegs = nullptr;
+    const char* strings = nullptr;
+
+private:
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+};
+
+bool Segment::map(const char* name)
+{
+    int fd = shm_open(name, O_RDONLY, 0);
+
+    if ( fd < 0 )
+    {
+        fprintf(stderr, "can't open %s: %s\n", name, strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+
+    if ( fstat(fd, &st) or (size_t)st.st_size < sizeof(StatsSegmentHeader) )
+    {
+        fprintf(stderr, "%s is not a stats segment\n", name);
+        close(fd);
+        return false;
+    }
+
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if ( p == MAP_FAILED )
+    {
+        fprintf(stderr, "can't map %s: %s\n", name, strerror(errno));
+        return false;
+    }
+
+    base = (const uint8_t*)p;
+    size = st.st_size;
+    hdr = (const StatsSegmentHeader*)base;
+
+    if ( memcmp(hdr->magic, STATS_SEGMENT_MAGIC, sizeof(hdr->magic)) or
+        hdr->version != STATS_SEGMENT_VERSION )
+    {
+        fprintf(stderr, "%s is not a version %d stats segment\n", name, STATS_SEGMENT_VERSION);
+        unmap();
+        return false;
+    }
+
+    if ( hdr->state.load(std::memory_order_acquire) != SSS_LIVE or hdr->size > size )
+    {
+        fprintf(stderr, "%s is not live\n", name);
+        unmap();
+        return false;
+    }
+
+    modules = (const StatsSegmentModule*)(base + hdr->modules);
+    pegs = (const StatsSegmentPeg*)(base + hdr->pegs);
+    strings = (const char*)(base + hdr->strings);
+    return true;
+}
+
+void Segment::unmap()
+{
+    if ( base )
+        munmap((void*)base, size);
+
+    base = nullptr;
+    hdr = nullptr;
+}
+
+bool Segment::read_thread(unsigned id, std::vector<uint64_t>& counts, uint64_t& updates) const
+{
+    auto* t = (const StatsSegmentThread*)(base + hdr->threads + id * hdr->thread_size);
+    auto* src = (const uint64_t*)(t + 1);
+
+    counts.resize(hdr->num_pegs);
+
+    for ( unsigned i = 0; i < MAX_RETRIES; ++i )
+    {
+        uint64_t seq = t->seq.load(std::memory_order_acquire);
+
+        if ( seq & 1 )
+            continue;
+
+        memcpy(counts.data(), src, hdr->num_pegs * sizeof(uint64_t));
+        updates = t->updates;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if ( t->seq.load(std::memory_order_relaxed) == seq )
+            return true;
+    }
+    return false;
+}
+
+static void usage(const char* prog)
+{
+    printf("usage: %s [-n name] [-m module] [-a] [-t] [-i seconds]\n", prog);
+    printf("  -n, --name      shared memory segment name (default %s)\n", DEFAULT_NAME);
+    printf("  -m, --module    only show this module\n");
+    printf("  -a, --all       include zero counts\n");
+    printf("  -t, --threads   show each packet thread after the total\n");
+    printf("  -i, --interval  repeat every so many seconds\n");
+}
+
+static bool parse(int argc, char* argv[], Options& opts)
+{
+    int c;
+
+    while ( (c = getopt_long(argc, argv, "hn:m:ati:", longopts, nullptr)) != -1 )
+    {
+        switch ( c )
+        {
+        case 'n':
+            opts.name = optarg;
+            break;
+        case 'm':
+            opts.module = optarg;
+            break;
+        case 'a':
+            opts.all = true;
+            break;
+        case 't':
+            opts.threads = true;
+            break;
+        case 'i':
+            opts.interval = strtoul(optarg, nullptr, 0);
+            break;
+        default:
+            usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void merge(uint8_t type, uint64_t& total, uint64_t value)
+{
+    if ( type == PEG_MAX )
+    {
+        if ( value > total )
+            total = value;
+    }
+    else
+        total += value;
+}
+
+static bool show(const Segment& seg, const Options& opts)
+{
+    const StatsSegmentHeader* hdr = seg.hdr;
+    std::vector<std::vector<uint64_t>> counts(hdr->num_threads);
+    std::vector<uint64_t> totals(hdr->num_pegs, 0);
+
+    for ( unsigned t = 0; t < hdr->num_threads; ++t )
+    {
+        uint64_t updates;
+
+        if ( !seg.read_thread(t, counts[t], updates) )
+        {
+            fprintf(stderr, "thread %u is too busy to read\n", t);
+            return false;
+        }
+
+        for ( unsigned p = 0; p < hdr->num_pegs; ++p )
+            merge(seg.pegs[p].type, totals[p], counts[t][p]);
+    }
+
+    printf("--------------------------------------------------\n");
+    printf("pid %" PRIu64 ", %u threads\n", hdr->pid, hdr->num_threads);
+
+    for ( unsigned m = 0; m < hdr->num_modules; ++m )
+    {
+        const StatsSegmentModule& mod = seg.modules[m];
+        const char* mod_name = seg.strings + mod.name;
+
+        if ( !opts.module.empty() and opts.module != mod_name )
+            continue;
+
+        bool header = false;
+
+        for ( unsigned p = mod.first_peg; p < mod.first_peg + mod.num_pegs; ++p )
+        {
+            if ( !opts.all and !totals[p] )
+                continue;
+
+            if ( !header )
+            {
+                printf("%s\n", mod_name);
+                header = true;
+            }
+
+            printf("%25.25s: %" PRIu64, seg.strings + seg.pegs[p].name, totals[p]);
+
+            if ( opts.threads )
+            {
+                for ( unsigned t = 0; t < hdr->num_threads; ++t )
+                    printf(" %" PRIu64, counts[t][p]);
+            }
+            printf("\n");
+        }
+    }
+    fflush(stdout);
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    Options opts;
+
+    if ( !parse(argc, argv, opts) )
+        return 1;
+
+    Segment seg;
+
+    if ( !seg.map(opts.name.c_str()) )
+        return 1;
+
+    while ( true )
+    {
+        if ( seg.retired() )
+        {
+            // snort reloaded or exited; pick up the replacement if any
+            seg.unmap();
+
+            if ( !seg.map(opts.name.c_str()) )
+                return 1;
+        }
+
+        if ( !show(seg, opts) )
+            return 1;
+
+        if ( !opts.interval )
+            break;
+
+        sleep(opts.interval);
+    }
+    return 0;
+}
+